@@ -1269,7 +1269,13 @@ CallExpr* buildScanExpr(Expr* opExpr, Expr* dataExpr, bool zippered) {
   buildReduceScanPreface1(fn, data, eltType, opExpr, dataExpr, zippered);
   buildReduceScanPreface2(fn, eltType, globalOp, opExpr);
 
-  fn->insertAtTail("compilerWarning('scan has been serialized (see issue #5760)')");
+  // only warn about the scans that chpl__scanIterator cannot parallelize
+  BlockStmt* serialWarning = new BlockStmt();
+  serialWarning->insertAtTail("compilerWarning('scan has been serialized (see issue #5760)')");
+  fn->insertAtTail(new CondStmt(new CallExpr("!",
+                                  new CallExpr("chpl__scanSupportsPar",
+                                               globalOp, data)),
+                                serialWarning));
 
   if( !zippered ) {
     fn->insertAtTail("'return'(chpl__scanIterator(%S, %S))", globalOp, data);
@@ -59,8 +59,14 @@
 
 #include <cstring>
 #include <cstdio>
+#include <fstream>
+#include <sstream>
 #include <vector>
 
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 // function prototypes
 static bool compareSymbol(const void* v1, const void* v2);
 
@@ -1354,7 +1360,7 @@ static void codegen_defn(std::set<const char*> & cnames, std::vector<TypeSymbol*
   genComment("Virtual Method Table");
   genVirtualMethodTable(types, false);
 
-  if(fIncrementalCompilation) {
+  if(fIncrementalCompilation || fParallelCCompile) {
     genComment("Global Variables");
     forv_Vec(VarSymbol, varSymbol, globals) {
       varSymbol->codegenGlobalDef(false);
@@ -2044,6 +2050,413 @@ static const char* generateFileName(ChainHashMap<char*, StringHashFns, int>& fil
   return name;
 }
 
+//
+// With --parallel-c-compile, the per-module C files are packed into
+// translation units of roughly this many bytes.  Units are filled in
+// module order, so a change to one module only moves the boundaries of
+// the units from that module onward.  Modules whose code changes with
+// any edit to the program (see ParallelCModule) get units of their own,
+// so that such edits leave the library units alone.
+//
+static const size_t parallelCUnitBytes = 256 * 1024;
+
+struct ParallelCModule {
+  const char* filename;
+  bool        ownUnit;
+};
+
+static std::string readGeneratedFile(const char* pathname) {
+  std::ifstream in(pathname, std::ios::in | std::ios::binary);
+  std::ostringstream contents;
+  contents << in.rdbuf();
+  return contents.str();
+}
+
+static bool isHeaderFile(const std::string& name) {
+  size_t dot = name.rfind('.');
+  if (dot == std::string::npos)
+    return false;
+  std::string ext = name.substr(dot);
+  return ext == ".h" || ext == ".hh" || ext == ".hpp" || ext == ".def";
+}
+
+// Collect the header files in a directory and its subdirectories
+static void findHeaderFiles(const std::string& dirName,
+                            std::set<std::string>& headers) {
+  DIR* dir = opendir(dirName.c_str());
+  if (dir == NULL)
+    return;
+  while (struct dirent* entry = readdir(dir)) {
+    std::string name = entry->d_name;
+    if (name == "." || name == "..")
+      continue;
+    std::string path = dirName + "/" + name;
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0)
+      continue;
+    if (S_ISDIR(st.st_mode))
+      findHeaderFiles(path, headers);
+    else if (S_ISREG(st.st_mode) && isHeaderFile(name))
+      headers.insert(path);
+  }
+  closedir(dir);
+}
+
+//
+// The runtime and third-party include flags and defines, and the contents
+// of every header under those include directories, so that an edit to a
+// runtime header invalidates the objects built against it.  Relative
+// directories are left out, since they hold the generated code, which is
+// hashed separately.
+//
+static std::string parallelCUnitRuntimeHeaders() {
+  std::vector<std::string> args;
+  readArgsFromCommand(std::string(CHPL_HOME) +
+                      "/util/config/compileline --includes-and-defines",
+                      args);
+  expandInstallationPaths(args);
+
+  std::string config;
+  std::set<std::string> headers;
+  for (size_t i = 0; i < args.size(); i++) {
+    config += "\n" + args[i];
+    if (args[i].compare(0, 2, "-I") == 0 && args[i].size() > 2 &&
+        args[i][2] == '/')
+      findHeaderFiles(args[i].substr(2), headers);
+  }
+  for (std::set<std::string>::iterator it = headers.begin();
+       it != headers.end(); ++it) {
+    config += "\n" + *it + "\n" + readGeneratedFile(it->c_str());
+  }
+  return config;
+}
+
+// Everything other than the generated code that affects an object file
+static std::string parallelCUnitConfig() {
+  std::string config = compileVersion;
+  config += std::string("\n") + CHPL_HOME;
+  config += std::string("\n") + CHPL_RUNTIME_LIB;
+  config += std::string("\n") + CHPL_RUNTIME_INCL;
+  for (std::map<std::string, const char*>::iterator env = envMap.begin();
+       env != envMap.end(); ++env) {
+    config += "\n" + env->first + "=" + env->second;
+  }
+  for_vector(const char, dirName, incDirs) {
+    config += std::string("\n-I") + dirName;
+  }
+  config += parallelCUnitRuntimeHeaders();
+  config += "\n" + ccflags;
+  config += astr("\n", istr(debugCCode), istr(optimizeCCode),
+                 istr(specializeCCode), istr(ffloatOpt), istr(ccwarnings));
+  return config;
+}
+
+static bool isIdentStart(char c) {
+  return isalpha((unsigned char)c) || c == '_';
+}
+
+static bool isIdentChar(char c) {
+  return isalnum((unsigned char)c) || c == '_';
+}
+
+// Skip a string or character literal starting at code[i]
+static size_t skipCLiteral(const std::string& code, size_t i) {
+  char quote = code[i++];
+  while (i < code.size() && code[i] != quote) {
+    if (code[i] == '\\')
+      i++;
+    i++;
+  }
+  return i + 1;
+}
+
+// Collect the identifiers in some generated C code
+static void collectIdentifiers(const std::string& code,
+                               std::vector<std::string>& idents) {
+  size_t i = 0;
+  while (i < code.size()) {
+    if (isIdentStart(code[i])) {
+      size_t start = i;
+      while (i < code.size() && isIdentChar(code[i]))
+        i++;
+      idents.push_back(code.substr(start, i - start));
+    } else if (isdigit((unsigned char)code[i])) {
+      // skip numbers whole, so that suffixes aren't taken as identifiers
+      while (i < code.size() && isIdentChar(code[i]))
+        i++;
+    } else {
+      i++;
+    }
+  }
+}
+
+//
+// A top-level declaration in chpl__header.h, the names it declares and
+// the identifiers it mentions.  A declaration whose names aren't found
+// (preprocessor lines among them) is treated as needed by every unit.
+//
+struct HeaderDecl {
+  std::string              text;
+  std::vector<std::string> declares;
+  std::vector<std::string> mentions;
+};
+
+struct HeaderToken {
+  std::string text;
+  int         depth;   // nesting of (), [] and {} around the token
+};
+
+//
+// Work out the names a declaration declares, from the forms that
+// codegen_header() writes: typedefs (including function pointer types,
+// struct and enum definitions), function prototypes and extern globals.
+//
+static void findDeclaredNames(const std::vector<HeaderToken>& toks,
+                              std::vector<std::string>& names) {
+  const char* lastIdent = NULL;
+  const char* beforeParen = NULL;
+  bool sawParen = false;
+  bool isEnum = false;
+
+  for (size_t i = 0; i < toks.size(); i++) {
+    const std::string& tok = toks[i].text;
+    bool ident = isIdentStart(tok[0]);
+
+    // a struct, union or enum tag defined here
+    if ((tok == "struct" || tok == "union" || tok == "enum") &&
+        i + 2 < toks.size() && isIdentStart(toks[i+1].text[0]) &&
+        toks[i+2].text == "{")
+      names.push_back(toks[i+1].text);
+
+    if (tok == "enum")
+      isEnum = true;
+
+    // enum constants
+    if (isEnum && ident && toks[i].depth == 1 && i > 0 &&
+        (toks[i-1].text == "{" || toks[i-1].text == ","))
+      names.push_back(tok);
+
+    // a function pointer type or variable: ( * name )
+    if (tok == "(" && toks[i].depth == 0 && i + 2 < toks.size() &&
+        toks[i+1].text == "*" && isIdentStart(toks[i+2].text[0])) {
+      names.push_back(toks[i+2].text);
+      return;
+    }
+
+    if (tok == "(" && toks[i].depth == 0 && !sawParen) {
+      sawParen = true;
+      if (i > 0 && isIdentStart(toks[i-1].text[0]))
+        beforeParen = toks[i-1].text.c_str();
+    }
+
+    if (ident && toks[i].depth == 0)
+      lastIdent = tok.c_str();
+  }
+
+  if (toks.empty())
+    return;
+
+  if (toks[0].text != "typedef" && sawParen) {
+    // a function prototype
+    if (beforeParen != NULL)
+      names.push_back(beforeParen);
+  } else if (lastIdent != NULL) {
+    // a typedef or a variable
+    names.push_back(lastIdent);
+  }
+}
+
+static std::vector<HeaderDecl> splitHeader(const std::string& hdr) {
+  std::vector<HeaderDecl> decls;
+  size_t i = 0;
+
+  while (i < hdr.size()) {
+    if (isspace((unsigned char)hdr[i])) {
+      i++;
+    } else if (hdr.compare(i, 2, "/*") == 0) {
+      size_t end = hdr.find("*/", i + 2);
+      i = (end == std::string::npos) ? hdr.size() : end + 2;
+    } else if (hdr.compare(i, 2, "//") == 0) {
+      while (i < hdr.size() && hdr[i] != '\n')
+        i++;
+    } else if (hdr[i] == '#') {
+      HeaderDecl decl;
+      size_t start = i;
+      while (i < hdr.size() && hdr[i] != '\n') {
+        if (hdr[i] == '\\' && i + 1 < hdr.size())
+          i++;
+        i++;
+      }
+      decl.text = hdr.substr(start, i - start);
+      decls.push_back(decl);
+    } else {
+      HeaderDecl decl;
+      std::vector<HeaderToken> toks;
+      int depth = 0;
+      size_t start = i;
+      bool done = false;
+
+      while (i < hdr.size() && !done) {
+        char c = hdr[i];
+        if (isIdentStart(c)) {
+          size_t identStart = i;
+          while (i < hdr.size() && isIdentChar(hdr[i]))
+            i++;
+          HeaderToken tok = { hdr.substr(identStart, i - identStart), depth };
+          toks.push_back(tok);
+          decl.mentions.push_back(tok.text);
+        } else if (isdigit((unsigned char)c)) {
+          while (i < hdr.size() && isIdentChar(hdr[i]))
+            i++;
+        } else if (c == '"' || c == '\'') {
+          i = skipCLiteral(hdr, i);
+        } else if (hdr.compare(i, 2, "/*") == 0) {
+          size_t end = hdr.find("*/", i + 2);
+          i = (end == std::string::npos) ? hdr.size() : end + 2;
+        } else {
+          if (c == ')' || c == ']' || c == '}')
+            depth--;
+          if (!isspace((unsigned char)c)) {
+            HeaderToken tok = { std::string(1, c), depth };
+            toks.push_back(tok);
+          }
+          if (c == '(' || c == '[' || c == '{')
+            depth++;
+          if (c == ';' && depth == 0)
+            done = true;
+          i++;
+        }
+      }
+
+      decl.text = hdr.substr(start, i - start);
+      findDeclaredNames(toks, decl.declares);
+      decls.push_back(decl);
+    }
+  }
+
+  return decls;
+}
+
+//
+// The parts of the header that a unit's code can depend on: the
+// declarations of the names it uses, those of the names that those
+// declarations use, and so on, plus every declaration that declares
+// no name we know of.  An edit elsewhere in the program that changes
+// other declarations, or adds some, doesn't change this.
+//
+static std::string unitHeaderInputs(
+    const std::vector<HeaderDecl>& decls,
+    const std::map<std::string, std::vector<size_t> >& declaredBy,
+    const std::string& code) {
+  std::vector<bool> needed(decls.size(), false);
+  std::set<std::string> seen;
+  std::vector<std::string> work;
+
+  collectIdentifiers(code, work);
+  while (!work.empty()) {
+    std::string name = work.back();
+    work.pop_back();
+    if (!seen.insert(name).second)
+      continue;
+
+    std::map<std::string, std::vector<size_t> >::const_iterator it =
+      declaredBy.find(name);
+    if (it == declaredBy.end())
+      continue;
+    for (size_t j = 0; j < it->second.size(); j++) {
+      size_t d = it->second[j];
+      if (!needed[d]) {
+        needed[d] = true;
+        work.insert(work.end(),
+                    decls[d].mentions.begin(), decls[d].mentions.end());
+      }
+    }
+  }
+
+  std::string inputs;
+  for (size_t d = 0; d < decls.size(); d++) {
+    if (needed[d] || decls[d].declares.empty())
+      inputs += decls[d].text + "\n";
+  }
+  return inputs;
+}
+
+static CodegenUnit codegenParallelCUnit(int index,
+                                        const std::vector<const char*>& files,
+                                        const std::string& inputs) {
+  fileinfo unitfile;
+  openCFile(&unitfile, astr("chpl__unit", istr(index)), "c");
+  fprintf(unitfile.fptr, "#include \"chpl__header.h\"\n");
+  for_vector(const char, filename, files) {
+    fprintf(unitfile.fptr, "#include \"%s\"\n", filename);
+  }
+  closeCFile(&unitfile, false);
+
+  const char* objname = astr("chpl__unit-", hashString(inputs), ".o");
+
+  CodegenUnit unit;
+  unit.source = genIntermediateFilename(astr("chpl__unit", istr(index)));
+  if (cObjectCacheDir[0] != '\0')
+    unit.object = astr(cObjectCacheDir, "/", objname);
+  else
+    unit.object = genIntermediateFilename(objname);
+  return unit;
+}
+
+//
+// Group the generated module files into separately compiled units.
+// Each unit's object file is named after a hash of the compile
+// configuration, the unit's module code and the header declarations
+// that code depends on, so an object left by an earlier build with
+// identical inputs is reused as is.  Debug info records where in the
+// header each declaration is, so with -g the whole header is hashed.
+//
+static std::vector<CodegenUnit>
+codegenParallelCUnits(const std::vector<ParallelCModule>& modules) {
+  std::vector<CodegenUnit> units;
+  std::string config = parallelCUnitConfig();
+  std::string header =
+    readGeneratedFile(genIntermediateFilename("chpl__header.h"));
+  std::vector<HeaderDecl> decls;
+  std::map<std::string, std::vector<size_t> > declaredBy;
+
+  if (!debugCCode) {
+    decls = splitHeader(header);
+    for (size_t d = 0; d < decls.size(); d++) {
+      for (size_t j = 0; j < decls[d].declares.size(); j++)
+        declaredBy[decls[d].declares[j]].push_back(d);
+    }
+  }
+
+  if (cObjectCacheDir[0] != '\0')
+    ensureDirExists(cObjectCacheDir, "ensuring --c-object-cache directory exists");
+
+  std::vector<const char*> files;
+  std::string code;
+  size_t unitBytes = 0;
+  for (size_t i = 0; i < modules.size(); i++) {
+    std::string moduleCode =
+      readGeneratedFile(genIntermediateFilename(modules[i].filename));
+    files.push_back(modules[i].filename);
+    code += std::string("\n") + modules[i].filename + "\n" + moduleCode;
+    unitBytes += moduleCode.size();
+
+    if (unitBytes >= parallelCUnitBytes || modules[i].ownUnit ||
+        i == modules.size() - 1 || modules[i+1].ownUnit) {
+      std::string inputs = config + "\n";
+      inputs += debugCCode ? header
+                           : unitHeaderInputs(decls, declaredBy, code);
+      inputs += code;
+      units.push_back(codegenParallelCUnit(units.size(), files, inputs));
+      files.clear();
+      code.clear();
+      unitBytes = 0;
+    }
+  }
+
+  return units;
+}
+
 
 static bool
 shouldChangeArgumentTypeToRef(ArgSymbol* arg) {
@@ -2293,6 +2706,9 @@ void codegen() {
     if(fIncrementalCompilation)
       USR_FATAL("Incremental compilation is not yet supported with LLVM");
 
+    if(fParallelCCompile)
+      USR_FATAL("--parallel-c-compile is not supported with LLVM");
+
     if(printCppLineno || debugCCode)
     {
       debug_info = new debug_data(*info->module);
@@ -2314,6 +2730,9 @@ void codegen() {
     prepareCodegenLLVM();
 #endif
   } else {
+    if (fParallelCCompile && fLibraryCompile)
+      USR_FATAL("--parallel-c-compile is not supported with --library");
+
     openCFile(&hdrfile,  "chpl__header", "h");
     openCFile(&mainfile, "_main",        "c");
     openCFile(&defnfile, "chpl__defn",    "c");
@@ -2325,26 +2744,6 @@ void codegen() {
     fprintf(mainfile.fptr, "#include \"%s.c\"\n", sCfgFname);
     fprintf(mainfile.fptr, "#include \"chpl__defn.c\"\n");
 
-    std::vector<const char*> userFileName;
-    if(fIncrementalCompilation) {
-      ChainHashMap<char*, StringHashFns, int> fileNameHashMap;
-      forv_Vec(ModuleSymbol, currentModule, allModules) {
-        const char* filename = NULL;
-        filename = generateFileName(fileNameHashMap, filename, currentModule->name);
-        if(currentModule->modTag == MOD_USER) {
-          fileinfo modulefile;
-          openCFile(&modulefile, filename, "c");
-          int modulePathLen = strlen(astr(modulefile.pathname));
-          char path[FILENAME_MAX];
-          strncpy(path, astr(modulefile.pathname), modulePathLen-2);
-          path[modulePathLen-2]='\0';
-          userFileName.push_back(astr(path));
-          closeCFile(&modulefile);
-        }
-      }
-    }
-
-    codegen_makefile(&mainfile, NULL, false, userFileName);
     if (fLibraryCompile && fLibraryMakefile) {
       codegen_library_makefile();
     }
@@ -2396,6 +2795,8 @@ void codegen() {
       }
     }
 
+    std::vector<const char*> userFileName;
+    std::vector<ParallelCModule> moduleFiles;
     ChainHashMap<char*, StringHashFns, int> fileNameHashMap;
     forv_Vec(ModuleSymbol, currentModule, allModules) {
       mysystem(astr("# codegen-ing module", currentModule->name),
@@ -2403,16 +2804,26 @@ void codegen() {
 
       const char* filename = NULL;
       filename = generateFileName(fileNameHashMap, filename,currentModule->name);
+      bool splitUserModule = fIncrementalCompilation && !fParallelCCompile &&
+                             currentModule->modTag == MOD_USER;
 
       fileinfo modulefile;
       openCFile(&modulefile, filename, "c");
       info->cfile = modulefile.fptr;
-      if(fIncrementalCompilation && (currentModule->modTag == MOD_USER))
+      if(splitUserModule)
         fprintf(modulefile.fptr, "#include \"chpl__header.h\"\n");
       currentModule->codegenDef();
       closeCFile(&modulefile);
 
-      if(!(fIncrementalCompilation && (currentModule->modTag == MOD_USER)))
+      if(fParallelCCompile) {
+        // User code and the string literals change with any edit
+        ParallelCModule module = { modulefile.filename,
+                                   currentModule->modTag == MOD_USER ||
+                                   currentModule == stringLiteralModule };
+        moduleFiles.push_back(module);
+      } else if(splitUserModule)
+        userFileName.push_back(genIntermediateFilename(filename));
+      else
         fprintf(mainfile.fptr, "#include \"%s%s\"\n", filename, ".c");
     }
 
@@ -2430,6 +2841,12 @@ void codegen() {
     closeCFile(&mainfile);
     closeCFile(&defnfile);
     closeCFile(&strconfig);
+
+    std::vector<CodegenUnit> units;
+    if(fParallelCCompile)
+      units = codegenParallelCUnits(moduleFiles);
+
+    codegen_makefile(&mainfile, NULL, false, userFileName, units);
   }
 
   if (fPrintEmittedCodeSize)
@@ -2448,6 +2865,11 @@ void makeBinary(void) {
 #endif
   } else {
     const char* makeflags = printSystemCommands ? "-f " : "-s -f ";
+    if (fParallelCCompile) {
+      long numCores = sysconf(_SC_NPROCESSORS_ONLN);
+      makeflags = astr("-j", istr(numCores > 0 ? (int)numCores : 1), " ",
+                       makeflags);
+    }
     const char* command = astr(astr(CHPL_MAKE, " "),
                                makeflags,
                                getIntermediateDirName(), "/Makefile");
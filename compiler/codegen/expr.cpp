@@ -4040,6 +4040,9 @@ DEFINE_PRIM(PRIM_ASSIGN) {
 }
 
 static bool commGetUnorderedAvailable(Type* elementType) {
+  if (0 == strcmp(CHPL_COMM, "none"))
+    return false;
+
   if (0 == strcmp(CHPL_COMM, "ugni")) {
     // the ugni layer only supports unordered gets for up to 8 bytes
     // and we use numeric type as a stand-in for that
@@ -4052,8 +4055,17 @@ static bool commGetUnorderedAvailable(Type* elementType) {
         // note: default sized complex is too big at present
         is_enum_type(elementType))
       return true;
+    return false;
   }
-  return false;
+
+  // the other comm layers use the portable implementation in the
+  // runtime, which handles any size
+  return true;
+}
+
+static bool commPutUnorderedAvailable(Type* elementType) {
+  // all comm layers use the portable implementation in the runtime
+  return 0 != strcmp(CHPL_COMM, "none");
 }
 
 DEFINE_PRIM(PRIM_UNORDERED_ASSIGN) {
@@ -4090,6 +4102,33 @@ DEFINE_PRIM(PRIM_UNORDERED_ASSIGN) {
                 genCommID(gGenInfo),
                 ln,
                 fn);
+  } else if (lhsWide == true && rhsWide == false &&
+             commPutUnorderedAvailable(rhsExpr->getValType())) {
+    // do an unordered PUT
+    // chpl_comm_put_unordered(
+    //   void *src,
+    //   c_nodeid_t dst_node, void* dst_raddr,
+    //   size_t size, int32_t typeIndex, int32_t commID,
+    //   int ln, int32_t fn);
+    GenRet dst = call->get(1);
+    GenRet src = codegenValuePtr(call->get(2));
+    GenRet ln = call->get(3);
+    GenRet fn = call->get(4);
+    TypeSymbol* dt = call->get(2)->typeInfo()->getValType()->symbol;
+    GenRet size = codegenSizeof(dt->typeInfo());
+
+    if (call->get(2)->typeInfo()->symbol->hasFlag(FLAG_REF))
+      src = codegenDeref(src);
+
+    codegenCall("chpl_comm_put_unordered",
+                codegenCastToVoidStar(codegenAddrOf(src)),
+                codegenRnode(dst),
+                codegenRaddr(dst),
+                size,
+                genTypeStructureIndex(dt),
+                genCommID(gGenInfo),
+                ln,
+                fn);
   } else {
     // Handle it like a normal assign
     FORWARD_PRIM(PRIM_ASSIGN);
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _RESOLUTION_PROFILER_H_
+#define _RESOLUTION_PROFILER_H_
+
+#include <cstdio>
+
+class FnSymbol;
+
+// Set by --profile-resolution and --profile-resolution-trace
+extern bool fProfileResolution;
+extern char profileResolutionTraceFile[FILENAME_MAX + 1];
+
+enum ResolutionProfileKind {
+  PROFILE_RESOLVE_FUNCTION,
+  PROFILE_INSTANTIATION,
+  PROFILE_WRAPPER,
+  PROFILE_NUM_KINDS
+};
+
+enum ResolutionProfileCache {
+  PROFILE_GENERICS_CACHE,
+  PROFILE_PROMOTIONS_CACHE,
+  PROFILE_NUM_CACHES
+};
+
+//
+// Records the time and the number of AST nodes created between its
+// construction and destruction, attributed to 'fn'.  Scopes nest, so
+// each event also knows its time excluding nested events.  Costs a
+// single test when profiling is off.
+//
+class ResolutionProfileScope {
+public:
+                 ResolutionProfileScope(ResolutionProfileKind kind,
+                                        FnSymbol*             fn,
+                                        const char*           what = NULL) {
+                   mEvent = fProfileResolution ? start(kind, fn, what) : -1;
+                 }
+
+                ~ResolutionProfileScope() {
+                   if (mEvent >= 0)
+                     stop(mEvent);
+                 }
+
+private:
+  static int     start(ResolutionProfileKind kind,
+                       FnSymbol*             fn,
+                       const char*           what);
+  static void    stop(int event);
+
+  int            mEvent;
+};
+
+void profileCacheLookup(ResolutionProfileCache cache, bool hit);
+
+// Print the ranked report and write the trace file, if requested
+void reportResolutionProfile();
+
+#endif
@@ -231,6 +231,9 @@ extern bool fMinimalModules;
 // Set to true if we want to enable incremental compilation.
 extern bool fIncrementalCompilation;
 
+// Set to true to compile the generated C as separate units in parallel.
+extern bool fParallelCCompile;
+
 // LLVM flags (-mllvm)
 extern std::string llvmFlags;
 
@@ -39,6 +39,9 @@ const char* astr(const std::string& s);
 
 const char* istr(int i);
 
+// 128-bit FNV-1a hash of 's' as 32 hex digits, for naming cached files
+const char* hashString(const std::string& s);
+
 const char* asubstr(const char* s, const char* e);
 
 void        deleteStrings();
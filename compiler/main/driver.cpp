@@ -39,6 +39,7 @@
 #include "parser.h"
 #include "PhaseTracker.h"
 #include "primitive.h"
+#include "ResolutionProfiler.h"
 #include "runpasses.h"
 #include "stmt.h"
 #include "stringutil.h"
@@ -176,6 +177,7 @@ bool fNoRemoveEmptyRecords = true;
 bool fRemoveUnreachableBlocks = true;
 bool fMinimalModules = false;
 bool fIncrementalCompilation = false;
+bool fParallelCCompile = false;
 bool fNoOptimizeForallUnordered = true;
 
 int optimize_on_clause_limit = 20;
@@ -660,6 +662,20 @@ static void verifySaveCDir(const ArgumentDescription* desc, const char* unused)
   }
 }
 
+static void verifyCObjectCacheDir(const ArgumentDescription* desc,
+                                  const char* unused) {
+  if (cObjectCacheDir[0] == '-') {
+    USR_FATAL("--c-object-cache takes a directory name as its argument\n"
+              "       (you specified '%s', assumed to be another flag)",
+              cObjectCacheDir);
+  }
+}
+
+static void setProfileResolutionTrace(const ArgumentDescription* desc,
+                                      const char* unused) {
+  fProfileResolution = true;
+}
+
 static void setLibmode(const ArgumentDescription* desc, const char* unused);
 
 static void verifySaveLibDir(const ArgumentDescription* desc, const char* unused) {
@@ -933,6 +949,7 @@ static ArgumentDescription arg_desc[] = {
  {"savec", ' ', "<directory>", "Save generated C code in directory", "P", saveCDir, "CHPL_SAVEC_DIR", verifySaveCDir},
 
  {"", ' ', NULL, "C Code Compilation Options", NULL, NULL, NULL, NULL},
+ {"c-object-cache", ' ', "<directory>", "Reuse back-end object files from directory (implies --parallel-c-compile)", "P", cObjectCacheDir, "CHPL_C_OBJECT_CACHE", verifyCObjectCacheDir},
  {"ccflags", ' ', "<flags>", "Back-end C compiler flags (can be specified multiple times)", "S", NULL, "CHPL_CC_FLAGS", setCCFlags},
  {"debug", 'g', NULL, "[Don't] Support debugging of generated C code", "N", &debugCCode, "CHPL_DEBUG", setChapelDebug},
  {"dynamic", ' ', NULL, "Generate a dynamically linked binary", "F", &fLinkStyle, NULL, setDynamicLink},
@@ -943,6 +960,7 @@ static ArgumentDescription arg_desc[] = {
  {"optimize", 'O', NULL, "[Don't] Optimize generated C code", "N", &optimizeCCode, "CHPL_OPTIMIZE", NULL},
  {"specialize", ' ', NULL, "[Don't] Specialize generated C code for CHPL_TARGET_CPU", "N", &specializeCCode, "CHPL_SPECIALIZE", NULL},
  {"output", 'o', "<filename>", "Name output executable", "P", executableFilename, "CHPL_EXE_NAME", NULL},
+ {"parallel-c-compile", ' ', NULL, "[Don't] Compile generated C code as separate units in parallel", "N", &fParallelCCompile, "CHPL_PARALLEL_C_COMPILE", NULL},
  {"static", ' ', NULL, "Generate a statically linked binary", "F", &fLinkStyle, NULL, NULL},
 
  {"", ' ', NULL, "LLVM Code Generation Options", NULL, NULL, NULL, NULL},
@@ -954,6 +972,8 @@ static ArgumentDescription arg_desc[] = {
  {"print-commands", ' ', NULL, "[Don't] print system commands", "N", &printSystemCommands, "CHPL_PRINT_COMMANDS", NULL},
  {"print-passes", ' ', NULL, "[Don't] print compiler passes", "N", &printPasses, "CHPL_PRINT_PASSES", NULL},
  {"print-passes-file", ' ', "<filename>", "Print compiler passes to <filename>", "S", NULL, "CHPL_PRINT_PASSES_FILE", setPrintPassesFile},
+ {"profile-resolution", ' ', NULL, "[Don't] report time spent resolving, instantiating and wrapping each function", "N", &fProfileResolution, "CHPL_PROFILE_RESOLUTION", NULL},
+ {"profile-resolution-trace", ' ', "<filename>", "Write a Chrome trace of function resolution to <filename>", "P", profileResolutionTraceFile, "CHPL_PROFILE_RESOLUTION_TRACE", setProfileResolutionTrace},
 
  {"", ' ', NULL, "Miscellaneous Options", NULL, NULL, NULL, NULL},
 // Support for extern { c-code-here } blocks could be toggled with this
@@ -1398,6 +1418,12 @@ static void checkIncrementalAndOptimized() {
               " using -O optimizations directly.");
 }
 
+static void postParallelCCompile() {
+  // Objects can only be cached once the code is split into units
+  if (cObjectCacheDir[0] != '\0')
+    fParallelCCompile = true;
+}
+
 static void postprocess_args() {
   // Processes that depend on results of passed arguments or values of CHPL_vars
 
@@ -1419,6 +1445,8 @@ static void postprocess_args() {
 
   checkTargetCpu();
 
+  postParallelCCompile();
+
   checkIncrementalAndOptimized();
 }
 
@@ -1498,6 +1526,8 @@ int main(int argc, char* argv[]) {
     fclose(printPassesFile);
   }
 
+  reportResolutionProfile();
+
   clean_exit(0);
 
   return 0;
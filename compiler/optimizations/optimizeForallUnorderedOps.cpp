@@ -788,7 +788,17 @@ static void transformAssignStmt(Expr* stmt) {
     }
   }
 
-  if (lhs->isRef() && rhs->isRef()) {
+  // With a ref on both sides this can become an unordered GET (or PUT);
+  // with a value on the right it can become an unordered PUT, since the
+  // runtime copies the value before returning.
+  bool rhsAddressable = rhs->isRef();
+  if (VarSymbol* rhsVar = toVarSymbol(rhs))
+    if (rhsVar->immediate == NULL)
+      rhsAddressable = true;
+  if (isArgSymbol(rhs))
+    rhsAddressable = true;
+
+  if (lhs->isRef() && rhsAddressable) {
     SET_LINENO(call);
     // add the call to getput
     if (fReportOptimizeForallUnordered)
@@ -0,0 +1,283 @@
+/*
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ResolutionProfiler.h"
+
+#include "baseAST.h"
+#include "misc.h"
+#include "stringutil.h"
+#include "symbol.h"
+
+#include <sys/time.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+bool fProfileResolution = false;
+char profileResolutionTraceFile[FILENAME_MAX + 1] = "";
+
+/************************************* | **************************************
+*                                                                             *
+* Each scope appends one event.  The events stay in the order they started,   *
+* which is what the trace file wants; the report aggregates them by kind and  *
+* by function.  Instantiations of a generic keep its source location, so     *
+* they are aggregated with it.                                                *
+*                                                                             *
+************************************** | *************************************/
+
+struct ProfileEvent {
+  ResolutionProfileKind kind;
+  const char*           name;
+  unsigned long         start;     // usecs since the first event
+  unsigned long         duration;
+  unsigned long         nested;    // time spent in nested events
+  int                   firstNode;
+  int                   nodes;
+};
+
+struct ProfileTotals {
+  ProfileTotals() : count(0), total(0), self(0), nodes(0) { }
+
+  int                   count;
+  unsigned long         total;
+  unsigned long         self;
+  long                  nodes;
+};
+
+static const int            numReportRows = 25;
+
+static const char*          kindNames[PROFILE_NUM_KINDS] = {
+  "resolveFunction",
+  "instantiation",
+  "wrapper"
+};
+
+static const char*          cacheNames[PROFILE_NUM_CACHES] = {
+  "genericsCache",
+  "promotionsCache"
+};
+
+static std::vector<ProfileEvent> events;
+static std::vector<int>          openEvents;
+static struct timeval            firstEventTime;
+
+static int                  cacheHits[PROFILE_NUM_CACHES];
+static int                  cacheMisses[PROFILE_NUM_CACHES];
+
+static unsigned long now() {
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+
+  if (events.empty() && openEvents.empty()) {
+    firstEventTime = tv;
+  }
+
+  return (tv.tv_sec  - firstEventTime.tv_sec) * 1000000 +
+         (tv.tv_usec - firstEventTime.tv_usec);
+}
+
+int ResolutionProfileScope::start(ResolutionProfileKind kind,
+                                  FnSymbol*             fn,
+                                  const char*           what) {
+  ProfileEvent event;
+
+  event.kind      = kind;
+  event.name      = astr(what ? what : "", fn->name, " (",
+                         cleanFilename(fn), ":", istr(fn->linenum()), ")");
+  event.start     = now();
+  event.duration  = 0;
+  event.nested    = 0;
+  event.firstNode = lastNodeIDUsed();
+  event.nodes     = 0;
+
+  events.push_back(event);
+  openEvents.push_back(events.size() - 1);
+
+  return events.size() - 1;
+}
+
+void ResolutionProfileScope::stop(int index) {
+  ProfileEvent& event = events[index];
+
+  INT_ASSERT(openEvents.back() == index);
+  openEvents.pop_back();
+
+  event.duration = now() - event.start;
+  event.nodes    = lastNodeIDUsed() - event.firstNode;
+
+  if (openEvents.empty() == false) {
+    events[openEvents.back()].nested += event.duration;
+  }
+}
+
+void profileCacheLookup(ResolutionProfileCache cache, bool hit) {
+  if (fProfileResolution) {
+    if (hit) {
+      cacheHits[cache]++;
+    } else {
+      cacheMisses[cache]++;
+    }
+  }
+}
+
+/************************************* | **************************************
+*                                                                             *
+* Report                                                                      *
+*                                                                             *
+************************************** | *************************************/
+
+typedef std::pair<const char*, ProfileTotals> NamedTotals;
+
+static bool compareByTotal(const NamedTotals& a, const NamedTotals& b) {
+  if (a.second.total != b.second.total) {
+    return a.second.total > b.second.total;
+  }
+
+  return strcmp(a.first, b.first) < 0;
+}
+
+static void reportKind(FILE* fp, ResolutionProfileKind kind) {
+  std::map<const char*, ProfileTotals> byName;
+  ProfileTotals                        all;
+
+  for (size_t i = 0; i < events.size(); i++) {
+    const ProfileEvent& event = events[i];
+
+    if (event.kind == kind) {
+      ProfileTotals& totals = byName[event.name];
+
+      totals.count += 1;
+      totals.total += event.duration;
+      totals.self  += event.duration - event.nested;
+      totals.nodes += event.nodes;
+
+      all.count    += 1;
+      all.self     += event.duration - event.nested;
+      all.nodes    += event.nodes;
+    }
+  }
+
+  std::vector<NamedTotals> ranked(byName.begin(), byName.end());
+
+  std::sort(ranked.begin(), ranked.end(), compareByTotal);
+
+  fprintf(fp, "\n%s: %d events, %.3f seconds self time, %ld AST nodes\n",
+          kindNames[kind], all.count, all.self / 1e6, all.nodes);
+
+  if (ranked.empty() == false) {
+    fprintf(fp, "%10s %10s %8s %10s  %s\n",
+            "Total", "Self", "Count", "Nodes", "Function");
+  }
+
+  for (size_t i = 0; i < ranked.size() && i < (size_t) numReportRows; i++) {
+    const ProfileTotals& totals = ranked[i].second;
+
+    fprintf(fp, "%10.3f %10.3f %8d %10ld  %s\n",
+            totals.total / 1e6, totals.self / 1e6,
+            totals.count, totals.nodes, ranked[i].first);
+  }
+}
+
+static void reportCache(FILE* fp, ResolutionProfileCache cache) {
+  int lookups = cacheHits[cache] + cacheMisses[cache];
+
+  fprintf(fp, "%-16s %8d hits %8d misses", cacheNames[cache],
+          cacheHits[cache], cacheMisses[cache]);
+
+  if (lookups > 0) {
+    fprintf(fp, "  (%.1f%% hit rate)", 100.0 * cacheHits[cache] / lookups);
+  }
+
+  fprintf(fp, "\n");
+}
+
+static std::string jsonEscape(const char* str) {
+  std::string retval;
+
+  for (const char* c = str; *c != '\0'; c++) {
+    if (*c == '"' || *c == '\\') {
+      retval += '\\';
+      retval += *c;
+
+    } else if ((unsigned char) *c < 0x20) {
+      char buf[8];
+
+      snprintf(buf, sizeof(buf), "\\u%04x", *c);
+      retval += buf;
+
+    } else {
+      retval += *c;
+    }
+  }
+
+  return retval;
+}
+
+// Complete ("X") events in the Chrome trace event format; they nest by time
+static void writeTrace(const char* filename) {
+  FILE* fp = fopen(filename, "w");
+
+  if (fp == NULL) {
+    USR_WARN("Error opening resolution trace file: %s.", filename);
+    return;
+  }
+
+  fprintf(fp, "{\"traceEvents\":[\n");
+
+  for (size_t i = 0; i < events.size(); i++) {
+    const ProfileEvent& event = events[i];
+
+    fprintf(fp,
+            "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\","
+            "\"ts\":%lu,\"dur\":%lu,\"pid\":1,\"tid\":1,"
+            "\"args\":{\"nodes\":%d}}%s\n",
+            jsonEscape(event.name).c_str(), kindNames[event.kind],
+            event.start, event.duration, event.nodes,
+            i + 1 < events.size() ? "," : "");
+  }
+
+  fprintf(fp, "],\"displayTimeUnit\":\"ms\"}\n");
+
+  fclose(fp);
+}
+
+void reportResolutionProfile() {
+  if (fProfileResolution == false) {
+    return;
+  }
+
+  fprintf(stderr, "\nResolution profile (seconds; Total includes nested events)\n");
+
+  for (int kind = 0; kind < PROFILE_NUM_KINDS; kind++) {
+    reportKind(stderr, (ResolutionProfileKind) kind);
+  }
+
+  fprintf(stderr, "\n");
+
+  for (int cache = 0; cache < PROFILE_NUM_CACHES; cache++) {
+    reportCache(stderr, (ResolutionProfileCache) cache);
+  }
+
+  if (profileResolutionTraceFile[0] != '\0') {
+    writeTrace(profileResolutionTraceFile);
+  }
+}
@@ -25,6 +25,7 @@
 #include "driver.h"
 #include "expr.h"
 #include "PartialCopyData.h"
+#include "ResolutionProfiler.h"
 #include "resolveFunction.h"
 #include "resolveIntents.h"
 #include "stmt.h"
@@ -422,6 +423,8 @@ FnSymbol* instantiate(FnSymbol* fn, SymbolMap& subs) {
  */
 void instantiateBody(FnSymbol* fn) {
   if (getPartialCopyData(fn) != NULL) {
+    ResolutionProfileScope profile(PROFILE_INSTANTIATION, fn, "body of ");
+
     fn->finalizeCopy();
   }
 }
@@ -492,7 +495,11 @@ FnSymbol* instantiateSignature(FnSymbol*  fn,
     determineAllSubs(fn, root, subs, allSubs);
 
     // use cached instantiation if possible
-    if (FnSymbol* cached = checkCache(genericsCache, root, &allSubs)) {
+    FnSymbol* cached = checkCache(genericsCache, root, &allSubs);
+
+    profileCacheLookup(PROFILE_GENERICS_CACHE, cached != NULL);
+
+    if (cached != NULL) {
       if (cached != (FnSymbol*) gVoid) {
         checkInfiniteWhereInstantiation(cached);
 
@@ -502,6 +509,8 @@ FnSymbol* instantiateSignature(FnSymbol*  fn,
     } else {
       SET_LINENO(fn);
 
+      ResolutionProfileScope profile(PROFILE_INSTANTIATION, fn);
+
       // copy generic class type if this function is a type constructor
       SymbolMap      map;
       AggregateType* newType = NULL;
@@ -36,6 +36,7 @@
 #include "passes.h"
 #include "postFold.h"
 #include "resolution.h"
+#include "ResolutionProfiler.h"
 #include "resolveIntents.h"
 #include "stmt.h"
 #include "stringutil.h"
@@ -460,6 +461,8 @@ void resolveSpecifiedReturnType(FnSymbol* fn) {
 
 void resolveFunction(FnSymbol* fn, CallExpr* forCall) {
   if (fn->isResolved() == false) {
+    ResolutionProfileScope profile(PROFILE_RESOLVE_FUNCTION, fn);
+
     if (fn->id == breakOnResolveID) {
       printf("breaking on resolve fn %s[%d] (%d args)\n",
              fn->name, fn->id, fn->numFormals());
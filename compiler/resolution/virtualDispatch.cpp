@@ -58,6 +58,8 @@ static child type could end up calling something in the parent.
 #include "stmt.h"
 #include "symbol.h"
 
+#include <algorithm>
+#include <cstring>
 #include <set>
 #include <vector>
 
@@ -637,21 +639,35 @@ static void addVirtualMethodTableEntry(Type*     type,
                                        FnSymbol* fn,
                                        bool      exclusive);
 
+// Order the roots by name and then by id rather than by the pointer-keyed
+// map they are collected from, so a type's table slots don't depend on
+// heap layout and stay put when unrelated code changes.
+static bool compareVirtualRoots(FnSymbol* a, FnSymbol* b) {
+  int cmp = strcmp(a->name, b->name);
+
+  return cmp < 0 || (cmp == 0 && a->id < b->id);
+}
+
 static void buildVirtualMethodTable() {
-  Vec<Type*> ctq;
+  Vec<Type*>             ctq;
+  std::vector<FnSymbol*> roots;
 
   ctq.add(dtObject);
 
   for (int i = 0; i < virtualRootsMap.n; i++) {
     if (virtualRootsMap.v[i].key != NULL) {
       for (int j = 0; j < virtualRootsMap.v[i].value->n; j++) {
-        FnSymbol* root = virtualRootsMap.v[i].value->v[j];
-
-        addVirtualMethodTableEntry(root->_this->type, root, true);
+        roots.push_back(virtualRootsMap.v[i].value->v[j]);
       }
     }
   }
 
+  std::sort(roots.begin(), roots.end(), compareVirtualRoots);
+
+  for_vector(FnSymbol, root, roots) {
+    addVirtualMethodTableEntry(root->_this->type, root, true);
+  }
+
   forv_Vec(Type, t, ctq) {
     if (Vec<FnSymbol*>* parentFns = virtualMethodTable.get(t)) {
       forv_Vec(FnSymbol, pfn, *parentFns) {
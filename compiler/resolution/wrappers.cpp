@@ -54,6 +54,7 @@
 #include "UnmanagedClassType.h"
 #include "passes.h"
 #include "resolution.h"
+#include "ResolutionProfiler.h"
 #include "resolveFunction.h"
 #include "resolveIntents.h"
 #include "stlUtil.h"
@@ -227,6 +228,8 @@ static void addDefaultsAndReorder(FnSymbol *fn,
                                 std::vector<ArgSymbol*>& actualFormals,
                                 bool resolveNewCode) {
 
+  ResolutionProfileScope profile(PROFILE_WRAPPER, fn, "default arguments for ");
+
   int numFormals = fn->numFormals();
   std::vector<Symbol*> newActuals(numFormals);
   std::vector<int8_t> newActualDefaulted(numFormals);
@@ -1710,8 +1713,12 @@ static FnSymbol* promotionWrap(FnSymbol* fn,
 
   retval = checkCache(promotionsCache, promotion.fn, &promotion.subs);
 
+  profileCacheLookup(PROFILE_PROMOTIONS_CACHE, retval != NULL);
+
   if (retval == NULL) {
     SET_LINENO(info.call);
+    ResolutionProfileScope profile(PROFILE_WRAPPER, fn,
+                                   "promotion wrapper for ");
     BlockStmt* instantiationPt = getInstantiationPoint(info.call);
     retval = buildPromotionWrapper(promotion,
                                    instantiationPt,
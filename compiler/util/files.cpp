@@ -60,6 +60,7 @@ char libmodeHeadername[FILENAME_MAX + 1]  = "";
 char fortranModulename[FILENAME_MAX + 1]  = "";
 char pythonModulename[FILENAME_MAX + 1]   = "";
 char saveCDir[FILENAME_MAX + 1]           = "";
+char cObjectCacheDir[FILENAME_MAX + 1]    = "";
 
 std::string ccflags;
 std::string ldflags;
@@ -639,7 +640,28 @@ void genIncludeCommandLineHeaders(FILE* outfile) {
 }
 
 
-void codegen_makefile(fileinfo* mainfile, const char** tmpbinname, bool skip_compile_link, const std::vector<const char*>& splitFiles) {
+//
+// Each unit gets a rule of its own so that make -j can compile them in
+// parallel.  The rules have no prerequisites: an object is named after
+// the hash of its inputs, so one that already exists is up to date.
+// Objects are written under a temporary name and renamed into place so
+// that builds sharing a --c-object-cache never see a partial one.
+//
+static void genUnitBuildRules(FILE* makefile,
+                              const std::vector<CodegenUnit>& units) {
+  for (size_t i = 0; i < units.size(); i++) {
+    fprintf(makefile, "%s:\n", units[i].object);
+    fprintf(makefile,
+            "\t$(CC) $(CHPL_MAKE_BASE_CFLAGS) $(GEN_CFLAGS) "
+            "$(COMP_GEN_CFLAGS) -c -o $@.tmp$$$$ $(CHPL_RT_INC_DIR) %s.c && "
+            "mv -f $@.tmp$$$$ $@\n",
+            units[i].source);
+    fprintf(makefile, "\n");
+  }
+}
+
+
+void codegen_makefile(fileinfo* mainfile, const char** tmpbinname, bool skip_compile_link, const std::vector<const char*>& splitFiles, const std::vector<CodegenUnit>& units) {
   fileinfo makefile;
   openCFile(&makefile, "Makefile");
   const char* tmpDirName = intDirName;
@@ -761,6 +783,10 @@ void codegen_makefile(fileinfo* mainfile, const char** tmpbinname, bool skip_com
   for(int i=0; i<(int)splitFiles.size(); i++)
     fprintf(makefile.fptr, "\t%s \\\n", splitFiles[i]);
   fprintf(makefile.fptr, "\n");
+  fprintf(makefile.fptr, "CHPL_UNIT_OBJS = \\\n");
+  for (size_t i = 0; i < units.size(); i++)
+    fprintf(makefile.fptr, "\t%s \\\n", units[i].object);
+  fprintf(makefile.fptr, "\n");
   genCFiles(makefile.fptr);
   genObjFiles(makefile.fptr);
   fprintf(makefile.fptr, "\nLIBS =");
@@ -788,6 +814,7 @@ void codegen_makefile(fileinfo* mainfile, const char** tmpbinname, bool skip_com
   }
   fprintf(makefile.fptr, "\n");
   genCFileBuildRules(makefile.fptr);
+  genUnitBuildRules(makefile.fptr, units);
   closeCFile(&makefile, false);
 }
 
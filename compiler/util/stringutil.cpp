@@ -122,6 +122,22 @@ istr(int i) {
   return astr(s);
 }
 
+//
+// 128-bit FNV-1a.  Not cryptographic, but collisions between generated
+// inputs are vanishingly unlikely.
+//
+const char* hashString(const std::string& s) {
+  typedef unsigned __int128 uint128;
+  const uint128 prime = ((uint128)1 << 88) + 0x13B;
+  uint128 hash = ((uint128)0x6c62272e07bb0142ULL << 64) | 0x62b821756295c58dULL;
+  for (size_t i = 0; i < s.size(); i++)
+    hash = (hash ^ (unsigned char)s[i]) * prime;
+  char buf[33];
+  snprintf(buf, sizeof(buf), "%016llx%016llx",
+           (unsigned long long)(hash >> 64), (unsigned long long)hash);
+  return astr(buf);
+}
+
 //
 // returns a canonicalized substring that contains the first part of
 // 's' up to 'e'
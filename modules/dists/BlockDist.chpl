@@ -1414,6 +1414,50 @@ private proc _doSimpleBlockTransfer(Dest, destDom, Src, srcDom) {
   if debugBlockDistBulkTransfer then writeln("Comms:",getCommDiagnostics());
 }
 
+//
+// Parallel scan that leaves the data where it is.  Each locale reduces
+// its own block, only the per-locale totals are combined into
+// exclusive prefixes, and then each locale scans its block starting
+// from its prefix.  See chpl__ScanChunks in ChapelReduce.
+//
+proc BlockArr.doiScan(op, dom) where (rank == 1) {
+  type resType = op.generate().type;
+  var res: [dom] resType;
+  const resArr = res._value;
+
+  type chunksType = unmanaged chpl__ScanChunks(op.type, dom.dim(1).type);
+  var totals: [this.dom.dist.targetLocDom] op.type;
+  var chunks: [this.dom.dist.targetLocDom] chunksType;
+
+  coforall (locid, myLocArr) in zip(this.dom.dist.targetLocDom, locArr) {
+    on this.dom.dist.targetLocales(locid) {
+      const myChunks = new unmanaged chpl__ScanChunks(op.type,
+                                                      myLocArr.locDom.myBlock.dim(1));
+      totals[locid] = myChunks.reduceChunks(op, myLocArr.myElems._value);
+      chunks[locid] = myChunks;
+    }
+  }
+
+  chpl__scanExclusivePrefixes(op, op.clone(), totals);
+
+  coforall (locid, myLocArr, myResArr) in zip(this.dom.dist.targetLocDom,
+                                              locArr, resArr.locArr) {
+    on this.dom.dist.targetLocales(locid) {
+      const prefix = op.clone();
+      prefix.combine(totals[locid]);
+      const myChunks = chunks[locid];
+      myChunks.scanChunks(op, prefix, myLocArr.myElems._value,
+                          myResArr.myElems._value);
+      delete myChunks;
+    }
+  }
+
+  for total in totals do
+    delete total;
+
+  return res;
+}
+
 proc BlockArr.dsiTargetLocales() {
   return dom.dist.targetLocales;
 }
@@ -209,6 +209,26 @@ config param disableStencilLazyRAD = defaultDisableLazyRADOpt;
   After updating, any read from the array should be up-to-date. The
   ``updateFluff`` function does not currently accept any arguments.
 
+  The update can also be split into two phases so that computation which
+  does not read the cached elements can overlap with the communication.
+  ``beginUpdateFluff`` starts fetching the cached elements and returns a
+  handle, and ``waitUpdateFluff`` waits for the fetches to complete and
+  fills in the caches:
+
+  .. code-block:: chapel
+
+    var update = A.beginUpdateFluff();
+
+    // compute on elements whose neighbors are all owned by this locale
+
+    A.waitUpdateFluff(update);
+
+    // the ghost caches are now up-to-date
+
+  The cached elements reflect the array's values at the time
+  ``beginUpdateFluff`` was called. Between the two calls, the caches must
+  not be read and no other update of the same array may be started.
+
   **Reading and Writing to Array Elements**
 
   The Stencil distribution uses ghost cells as cached read-only values from
@@ -358,6 +378,10 @@ class LocStencilArr {
   var recvBufs, sendBufs : [locDom.NeighDom] [locDom.bufDom] eltType;
   var sendRecvFlag : [locDom.NeighDom] atomic bool;
 
+  // Outstanding non-blocking GETs into recvBufs, see beginUpdateFluff.
+  // These are the runtime's chpl_comm_nb_handle_t, which is a void*.
+  var recvHandles : [locDom.NeighDom] c_void_ptr;
+
   // These functions will always be called on this.locale, and so we do
   // not have an on statement around the while loop below (to avoid
   // the repeated on's from calling testAndSet()).
@@ -1589,6 +1613,131 @@ proc StencilArr.updateFluff() {
   }
 }
 
+//
+// Split-phase variant of the packed update, see beginUpdateFluff.
+//
+// Every region is packed, regardless of stencilDistPackedUpdateMinChunks,
+// so that each region can be fetched with a single non-blocking GET.
+// Because the packing coforall completes before any GETs are started, the
+// sendRecvFlag handshake used by _packedUpdate is not needed here.
+//
+proc StencilArr._beginPackedUpdate() {
+  coforall i in dom.dist.targetLocDom {
+    on dom.dist.targetLocales(i) {
+      const myLocDom = locArr[i].locDom;
+
+      forall (S, sendBufIdx) in zip(myLocDom.sendSrc, myLocDom.NeighDom) {
+        if S.size != 0 {
+          ref src = locArr[i].myElems[S];
+          ref buf = locArr[i].sendBufs[sendBufIdx];
+          local do for (s, i) in zip(src, buf.domain.first..#src.size) do buf[i] = s;
+        }
+      }
+    }
+  }
+
+  coforall i in dom.dist.targetLocDom {
+    on dom.dist.targetLocales(i) {
+      const myLocArr = locArr[i];
+      const myLocDom = myLocArr.locDom;
+
+      for (D, srcIdx, recvBufIdx) in zip(myLocDom.recvDest, myLocDom.Neighs,
+                                         myLocDom.NeighDom) {
+        if !isZeroTuple(recvBufIdx) && D.size != 0 {
+          const srcBufIdx = -1 * chpl__tuplify(recvBufIdx);
+          ref dest = myLocArr.recvBufs[recvBufIdx][1];
+          ref src = locArr[srcIdx].sendBufs[srcBufIdx][1];
+          myLocArr.recvHandles[recvBufIdx] =
+            chpl_comm_get_nb(c_ptrTo(dest):c_void_ptr,
+                             __primitive("_wide_get_node", src),
+                             __primitive("_wide_get_addr", src),
+                             D.size:size_t * c_sizeof(eltType),
+                             -1, CHPL_COMM_UNKNOWN_ID);
+        }
+      }
+    }
+  }
+}
+
+proc StencilArr._waitPackedUpdate() {
+  coforall i in dom.dist.targetLocDom {
+    on dom.dist.targetLocales(i) {
+      const myLocArr = locArr[i];
+      const myLocDom = myLocArr.locDom;
+
+      // chpl_comm_wait_nb_some() returns once at least one of the GETs
+      // has completed, clearing the handles of those that have, so keep
+      // waiting until all of them are clear.
+      ref handles = myLocArr.recvHandles;
+      const h = c_ptrTo(handles[handles.domain.first]);
+      const numHandles = handles.size;
+      var next = 0;
+      while next < numHandles {
+        if h[next] == nil then
+          next += 1;
+        else
+          chpl_comm_wait_nb_some(h + next, (numHandles - next):size_t);
+      }
+
+      forall (D, recvBufIdx) in zip(myLocDom.recvDest, myLocDom.NeighDom) {
+        if !isZeroTuple(recvBufIdx) && D.size != 0 {
+          ref dest = myLocArr.myElems[D];
+          ref buf = myLocArr.recvBufs[recvBufIdx];
+          local do for (d, i) in zip(dest, buf.domain.first..#dest.size) do d = buf[i];
+        }
+      }
+    }
+  }
+}
+
+pragma "insert line file info"
+private extern proc chpl_comm_get_nb(addr: c_void_ptr, node: chpl_nodeID_t,
+                                     raddr: c_void_ptr, size: size_t,
+                                     typeIndex: int(32), commID: int(32)
+                                    ): c_void_ptr;
+
+private extern proc chpl_comm_wait_nb_some(h: c_ptr(c_void_ptr),
+                                           nhandles: size_t);
+
+private extern const CHPL_COMM_UNKNOWN_ID: int(32);
+
+/*
+  A pending update of the cached elements of a Stencil-distributed array.
+  It is returned by ``beginUpdateFluff`` and is completed by passing it to
+  ``waitUpdateFluff``.
+*/
+record StencilFluffUpdate {
+  pragma "no doc"
+  var pending = false;
+}
+
+// Start updating the caches, returning before the remote data has arrived.
+//
+// For element types that cannot be bulk transferred and for a single
+// locale, the caches are updated with a blocking naive update instead,
+// and waitUpdateFluff has nothing left to do.
+//
+proc StencilArr.beginUpdateFluff() {
+  var update: StencilFluffUpdate;
+  if isZeroTuple(dom.fluff) then return update;
+
+  if shouldDoPackedUpdate() && dom.dist.targetLocales.size > 1 {
+    this._beginPackedUpdate();
+    update.pending = true;
+  } else {
+    this.naiveUpdateFluff();
+  }
+  return update;
+}
+
+// Finish an update of the caches started by beginUpdateFluff
+proc StencilArr.waitUpdateFluff(ref update: StencilFluffUpdate) {
+  if update.pending {
+    this._waitPackedUpdate();
+    update.pending = false;
+  }
+}
+
 override proc StencilArr.dsiReallocate(bounds:rank*range(idxType,BoundedRangeType.bounded,stridable))
 {
   //
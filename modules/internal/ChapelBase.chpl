@@ -1080,9 +1080,12 @@ module ChapelBase {
   pragma "task complete impl fn"
   extern proc chpl_comm_task_end(): void;
 
+  pragma "task complete impl fn"
+  extern proc chpl_comm_unordered_task_fence(): void;
+
   pragma "task complete impl fn"
   proc chpl_after_forall_fence() {
-    chpl_comm_task_end(); // TODO: change to chpl_comm_unordered_task_fence()
+    chpl_comm_unordered_task_fence();
   }
 
   // This function is called once by each newly initiated task.  No on
@@ -732,6 +732,10 @@ module ChapelDistribution {
       halt("clearEntry() not supported for non-associative arrays");
     }
 
+    proc clearSlot(slotNum: int) {
+      halt("clearSlot() not supported for non-associative arrays");
+    }
+
     proc _backupArray() {
       halt("_backupArray() not supported for non-associative arrays");
     }
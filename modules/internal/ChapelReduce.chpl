@@ -30,10 +30,117 @@ module ChapelReduce {
   }
 
   proc chpl__scanIterator(op, data) {
-    var arr = for d in data do chpl__accumgen(op, d);
+    if chpl__scanSupportsPar(op, data) {
+      var arr = data._value.doiScan(op, data.domain);
 
-    delete op;
-    return arr;
+      delete op;
+      return arr;
+    } else {
+      var arr = for d in data do chpl__accumgen(op, d);
+
+      delete op;
+      return arr;
+    }
+  }
+
+  // Arrays whose implementation provides doiScan(op, dom) are scanned in
+  // parallel, as long as the op can be cloned and combined with itself.
+  // Everything else falls back to the serial for-expression.  Array views
+  // forward doiScan to the array they view, which would scan that array's
+  // indices rather than the view's, so views are always scanned serially.
+  proc chpl__scanSupportsPar(op, data) param {
+    use Reflection;
+
+    if !isArray(data) || chpl__isArrayView(data) then
+      return false;
+    else if !canResolveMethod(op, "clone") then
+      return false;
+    else if op.clone().type != op.type then
+      return false;
+    else
+      return canResolveMethod(op, "combine", op) &&
+             canResolveMethod(data._value, "doiScan", op, data.domain);
+  }
+
+  //
+  // Support for parallel scans of 1-D arrays.  The indices are split
+  // into chunks, and the scan takes two passes over the data: first
+  // each chunk is reduced into its own clone of the scan op, then the
+  // chunk totals are turned into exclusive prefixes and each chunk is
+  // scanned again starting from its prefix.  Only clone(), accumulate(),
+  // combine() and generate() are used, so user-defined ReduceScanOps
+  // work as well as the built-in ones.
+  //
+  // A distributed array creates one of these per locale for its local
+  // indices, so that only the per-locale totals need to be exchanged.
+  //
+  class chpl__ScanChunks {
+    type opType;
+    const inds;
+    const numChunks = if __primitive("task_get_serial") then 1
+                      else chpl__scanNumChunks(inds.size);
+    var ops: [0..#numChunks] opType;
+
+    // the indices of chunk 'c', in order
+    proc chunk(c) {
+      use DSIUtil;
+
+      const (lo, hi) = _computeChunkStartEnd(inds.size, numChunks, c+1);
+      return inds # hi # -(hi-lo+1);
+    }
+
+    // First pass: reduce each chunk of 'data' in parallel and return
+    // the total of all the chunks as a new op.
+    proc reduceChunks(op, data) {
+      coforall c in 0..#numChunks {
+        const chunkOp = op.clone();
+        for i in chunk(c) do
+          chunkOp.accumulate(data.dsiAccess(i));
+        ops[c] = chunkOp;
+      }
+
+      const total = op.clone();
+      for c in 0..#numChunks do
+        total.combine(ops[c]);
+      return total;
+    }
+
+    // Second pass: scan each chunk of 'data' into 'res' in parallel,
+    // with everything before the first chunk summarized by 'prefix'.
+    // 'prefix' and the chunk totals are deleted.
+    proc scanChunks(op, prefix, data, res) {
+      chpl__scanExclusivePrefixes(op, prefix, ops);
+
+      coforall c in 0..#numChunks {
+        const chunkOp = ops[c];
+        for i in chunk(c) {
+          chunkOp.accumulate(data.dsiAccess(i));
+          res.dsiAccess(i) = chunkOp.generate();
+        }
+        delete chunkOp;
+      }
+    }
+  }
+
+  private proc chpl__scanNumChunks(numElems) {
+    use DSIUtil;
+
+    return _computeNumChunks(numElems);
+  }
+
+  // Replace each op in 'ops' by a new op summarizing 'start' and all of
+  // the ops before it.  'start' and the original ops are deleted.
+  proc chpl__scanExclusivePrefixes(op, start, ref ops) {
+    var running = start;
+    for i in ops.domain {
+      const next = op.clone();
+      next.combine(running);
+      next.combine(ops[i]);
+      delete ops[i];
+      ops[i] = running;
+      running = next;
+    }
+    delete running;
   }
 
   // helper routine to run the accumulate + generate steps of a scan
@@ -25,6 +25,18 @@ module DefaultAssociative {
   config param debugDefaultAssoc = false;
   config param debugAssocDataPar = false;
 
+  // When true, tables have a power-of-two number of slots and are searched
+  // by comparing a group of per-slot control bytes at a time (see
+  // chpl-hash-probe.h), and lookups and adds into parSafe domains run
+  // concurrently without taking the table lock.  When false, tables have a
+  // prime number of slots and are searched one slot at a time with
+  // quadratic probing.
+  config param defaultAssocGroupProbe = true;
+
+  // Tables with at least this many slots are rehashed in parallel when
+  // resized (defaultAssocGroupProbe only)
+  config const defaultAssocParallelRehash = 1 << 16;
+
   // TODO: make the domain parameterized by this?
   type chpl_table_index_type = int;
 
@@ -39,6 +51,42 @@ module DefaultAssociative {
     var idx: idxType;
   }
 
+  // Control byte values used with defaultAssocGroupProbe.  Empty is 0 so
+  // that newly allocated control bytes are empty; a full slot stores the
+  // high bit plus the low 7 bits of its index's hash.
+  // Busy marks a slot claimed by an add that hasn't finished writing it.
+  param chpl__assocCtrlEmpty: uint(8) = 0,
+        chpl__assocCtrlDeleted: uint(8) = 1,
+        chpl__assocCtrlBusy: uint(8) = 2;
+
+  inline proc chpl__assocCtrlFull(hash: uint): uint(8) {
+    return (0x80 | (hash & 0x7f)): uint(8);
+  }
+
+  // Must match CHPL_HASH_PROBE_GROUP_SIZE
+  param chpl__assocGroupSize = 16;
+
+  extern proc chpl_hash_probe_match(group: c_ptr(uint(8)),
+                                    ctrl: uint(8)): uint(32);
+  extern proc chpl_hash_probe_claim(ctrl: c_ptr(uint(8)),
+                                    expected: uint(8),
+                                    desired: uint(8)): bool;
+  extern proc chpl_hash_probe_publish(ctrl: c_ptr(uint(8)), value: uint(8));
+  extern proc chpl_bitops_ctz_32(x: uint(32)): uint(32);
+
+  // Number of locks serializing concurrent adds of the same index
+  proc chpl__assocNumAddLocks(param parSafe) param {
+    return if defaultAssocGroupProbe && parSafe then 256 else 0;
+  }
+
+  // Number of slots in a table whose size number is 'num'
+  proc chpl__assocTableSize(num: int): int {
+    if defaultAssocGroupProbe then
+      return chpl__assocGroupSize << num;
+    else
+      return chpl__primes(num);
+  }
+
   proc chpl__primes return
   (23, 53, 89, 191, 383, 761, 1531, 3067, 6143, 12281, 24571, 49139, 98299,
    196597, 393209, 786431, 1572853, 3145721, 6291449, 12582893, 25165813,
@@ -67,14 +115,47 @@ module DefaultAssociative {
     var tableSize : int;
     var tableDom = {0..tableSize-1};
     var table: [tableDom] chpl_TableEntry(idxType);
+
+    // Control byte for each slot when defaultAssocGroupProbe is set
+    var ctrl: [tableDom] uint(8);
+
+    // Number of tasks currently searching or adding to the table without
+    // holding tableLock (defaultAssocGroupProbe and parSafe only)
+    var numReaders: chpl__processorAtomicType(int);
+
+    // Adds of the same index serialize on the lock chosen by its hash
+    // (defaultAssocGroupProbe and parSafe only)
+    var addLocks: [0..#chpl__assocNumAddLocks(parSafe)]
+                  chpl__processorAtomicType(bool);
   
     inline proc lockTable() {
-      while tableLock.testAndSet(memory_order_acquire) do chpl_task_yield();
+      if defaultAssocGroupProbe {
+        // Writers wait for in-progress lookups to finish.  This pairs with
+        // _startRead(), which registers before checking for a writer.
+        while tableLock.testAndSet() do chpl_task_yield();
+        while numReaders.read() != 0 do chpl_task_yield();
+      } else {
+        while tableLock.testAndSet(memory_order_acquire) do chpl_task_yield();
+      }
     }
   
     inline proc unlockTable() {
       tableLock.clear(memory_order_release);
     }
+
+    inline proc _startRead() {
+      while true {
+        numReaders.add(1);
+        if !tableLock.read() then return;
+        // a writer holds the table: back out and wait for it to finish
+        numReaders.sub(1);
+        while tableLock.read() do chpl_task_yield();
+      }
+    }
+
+    inline proc _endRead() {
+      numReaders.sub(1, memory_order_release);
+    }
   
     // TODO: An ugly [0..-1] domain appears several times in the code --
     //       replace with a named constant/param?
@@ -95,7 +176,7 @@ module DefaultAssociative {
       this.idxType = idxType;
       this.parSafe = parSafe;
       this.dist = dist;
-      this.tableSize = chpl__primes(tableSizeNum);
+      this.tableSize = chpl__assocTableSize(tableSizeNum);
     }
   
     //
@@ -273,6 +354,8 @@ module DefaultAssociative {
         for slot in tableDom {
           table[slot].status = chpl__hash_status.empty;
         }
+        if defaultAssocGroupProbe then
+          ctrl = chpl__assocCtrlEmpty;
         numEntries.write(0);
         if parSafe then unlockTable();
       }
@@ -307,21 +390,93 @@ module DefaultAssociative {
       var retVal = 0;
       on this {
         const shouldLock = needLock && parSafe;
-        if shouldLock then lockTable();
-        var findAgain = shouldLock;
-        if ((numEntries.read()+1)*2 > tableSize) {
-          _resize(grow=true);
-          findAgain = true;
+        if defaultAssocGroupProbe && shouldLock {
+          (slotNum, retVal) = _addConcurrent(idx);
+        } else {
+          if shouldLock then lockTable();
+          var findAgain = shouldLock;
+          if ((numEntries.read()+1)*2 > tableSize) {
+            _resize(grow=true);
+            findAgain = true;
+          }
+          if findAgain then
+            (slotNum, retVal) = _add(idx, -1);
+          else
+            (_, retVal) = _add(idx, inSlot);
+          if shouldLock then unlockTable();
         }
-        if findAgain then
-          (slotNum, retVal) = _add(idx, -1);
-        else
-          (_, retVal) = _add(idx, inSlot);
-        if shouldLock then unlockTable();
       }
       return (slotNum, retVal);
     }
 
+    // Adds 'idx' to a parSafe table while other tasks add and look up
+    // indices.  Tasks adding the same index serialize on one of addLocks,
+    // while tasks adding different indices claim open slots by swapping
+    // their control bytes to busy.  Growing the table takes tableLock.
+    proc _addConcurrent(idx: idxType): (index(tableDom), int) {
+      const hash = chpl__defaultHashWrapper(idx):uint;
+      const full = chpl__assocCtrlFull(hash);
+      ref addLock = addLocks[(hash % addLocks.size:uint):int];
+
+      while true {
+        _startRead();
+
+        // Reserve room for 'idx', or grow the table and try again
+        if (numEntries.fetchAdd(1)+1)*2 > tableSize {
+          numEntries.sub(1);
+          _endRead();
+          var added = false, ret: (index(tableDom), int);
+          lockTable();
+          if (numEntries.read()+1)*2 > tableSize {
+            if postponeResize {
+              // can't grow now, so add while holding the table
+              ret = _add(idx);
+              added = true;
+            } else {
+              _resize(grow=true);
+            }
+          }
+          unlockTable();
+          if added then return ret;
+          continue;
+        }
+
+        while addLock.testAndSet(memory_order_acquire) do chpl_task_yield();
+        var (found, slotNum) = _findSlotInGroups(idx);
+        while !found && slotNum != -1 && !_claimSlot(slotNum) do
+          (found, slotNum) = _findSlotInGroups(idx);
+        if found || slotNum == -1 {
+          numEntries.sub(1);
+        } else {
+          table[slotNum].status = chpl__hash_status.full;
+          table[slotNum].idx = idx;
+
+          // default initialize newly added array elements before the slot
+          // is published, so lock-free readers never see a stale element
+          // left behind by a deleted index
+          for a in _arrs do
+            a.clearSlot(slotNum);
+          chpl_hash_probe_publish(c_ptrTo(ctrl[slotNum]), full);
+        }
+        addLock.clear(memory_order_release);
+        _endRead();
+
+        if slotNum == -1 then
+          halt("couldn't add ", idx, " -- ", numEntries.read(), " / ", tableSize, " taken");
+        return (slotNum, if found then 0 else 1);
+      }
+      return (-1, 0);
+    }
+
+    // Claims an open slot for a concurrent add by marking it busy
+    inline proc _claimSlot(slotNum: index(tableDom)) {
+      const slotCtrl = ctrl[slotNum];
+      return (slotCtrl == chpl__assocCtrlEmpty ||
+              slotCtrl == chpl__assocCtrlDeleted) &&
+             chpl_hash_probe_claim(c_ptrTo(ctrl[slotNum]), slotCtrl,
+                                   chpl__assocCtrlBusy);
+    }
+
     // This routine adds new indices without checking the table size and
     //  is thus appropriate for use by routines like _resize().
     //
@@ -336,6 +491,8 @@ module DefaultAssociative {
       if foundSlot {
         table[slotNum].status = chpl__hash_status.full;
         table[slotNum].idx = idx;
+        if defaultAssocGroupProbe then
+          ctrl[slotNum] = chpl__assocCtrlFull(chpl__defaultHashWrapper(idx):uint);
         numEntries.add(1);
 
         // default initialize newly added array elements
@@ -361,6 +518,8 @@ module DefaultAssociative {
           for a in _arrs do
             a.clearEntry(idx);
           table[slotNum].status = chpl__hash_status.deleted;
+          if defaultAssocGroupProbe then
+            ctrl[slotNum] = chpl__assocCtrlDeleted;
           numEntries.sub(1);
         } else {
           retval = 0;
@@ -374,13 +533,14 @@ module DefaultAssociative {
     }
   
     proc findPrimeSizeIndex(numKeys:int) {
-      //Find the first suitable prime
+      //Find the first suitable table size (a prime unless
+      //defaultAssocGroupProbe is set)
       var threshold = (numKeys + 1) * 2;
       var prime = 0;
       var primeLoc = 0;
       for i in 1..chpl__primes.size {
-          if chpl__primes(i) > threshold {
-            prime = chpl__primes(i);
+          if chpl__assocTableSize(i) > threshold {
+            prime = chpl__assocTableSize(i);
             primeLoc = i;
             break;
           }
@@ -399,7 +559,7 @@ module DefaultAssociative {
       if entries < numKeys {
 
         var primeLoc = findPrimeSizeIndex(numKeys);
-        var prime = chpl__primes(primeLoc);
+        var prime = chpl__assocTableSize(primeLoc);
 
         //Changing underlying structure, time for locking
         if parSafe then lockTable();
@@ -422,10 +582,7 @@ module DefaultAssociative {
           numEntries.write(0);
 
           // insert old data into newly resized table
-          for slot in _fullSlots(copyTable) {
-            const (newslot, _) = _add(copyTable[slot].idx);
-            _preserveArrayElements(oldslot=slot, newslot=newslot);
-          }
+          _rehash(copyTable);
             
           _removeArrayBackups();
         } else {
@@ -475,23 +632,78 @@ module DefaultAssociative {
       numEntries.write(0); // reset, because the adds below will re-set this
       tableSizeNum += if grow then 1 else -1;
       if tableSizeNum > chpl__primes.size then halt("associative array exceeds maximum size");
-      tableSize = chpl__primes(tableSizeNum);
+      tableSize = chpl__assocTableSize(tableSizeNum);
       tableDom = {0..tableSize-1};
   
       // insert old data into newly resized table
-      for slot in _fullSlots(copyTable) {
-        const (newslot, _) = _add(copyTable[slot].idx);
-        _preserveArrayElements(oldslot=slot, newslot=newslot);
-      }
+      _rehash(copyTable);
       
       _removeArrayBackups();
     }
 
+    // Inserts the indices of 'oldTable' into the (empty) table, moving
+    // the corresponding array elements along with them.
+    //
+    // NOTE: Calls to this routine assume that the tableLock has been acquired.
+    //
+    proc _rehash(oldTable) {
+      if defaultAssocGroupProbe &&
+         oldTable.domain.size >= defaultAssocParallelRehash {
+        _rehashParallel(oldTable);
+      } else {
+        for slot in _fullSlots(oldTable) {
+          const (newslot, _) = _add(oldTable[slot].idx);
+          _preserveArrayElements(oldslot=slot, newslot=newslot);
+        }
+      }
+    }
+
+    // The parallel version of _rehash(): a task per core inserts a block of
+    // 'oldTable', claiming slots as in _addConcurrent().  The indices are
+    // known to be distinct, so no add locks are needed.
+    proc _rehashParallel(oldTable) {
+      const numOldSlots = oldTable.domain.size;
+      const numTasks = max(1, min(here.maxTaskPar,
+                                  numOldSlots / defaultAssocParallelRehash));
+      coforall tid in 0..#numTasks {
+        const (lo, hi) = _computeBlock(numOldSlots, numTasks, tid,
+                                       numOldSlots-1);
+        for oldslot in lo..hi {
+          if oldTable[oldslot].status == chpl__hash_status.full {
+            const idx = oldTable[oldslot].idx;
+            var (_, slotNum) = _findSlotInGroups(idx);
+            while slotNum != -1 && !_claimSlot(slotNum) do
+              (_, slotNum) = _findSlotInGroups(idx);
+            if slotNum == -1 then
+              halt("couldn't add ", idx, " -- ", numEntries.read(), " / ", tableSize, " taken");
+
+            table[slotNum].status = chpl__hash_status.full;
+            table[slotNum].idx = idx;
+            chpl_hash_probe_publish(c_ptrTo(ctrl[slotNum]),
+                chpl__assocCtrlFull(chpl__defaultHashWrapper(idx):uint));
+            numEntries.add(1);
+            _preserveArrayElements(oldslot=oldslot, newslot=slotNum);
+          }
+        }
+      }
+    }
+
     // Searches for 'idx' in a filled slot.
     //
     // Returns true if found, along with the first open slot that may be
     // re-used for faster addition to the domain
     proc _findFilledSlot(idx: idxType, needLock = true) : (bool, index(tableDom)) {
+      if defaultAssocGroupProbe {
+        var ret: (bool, index(tableDom));
+        // probing reads the control bytes through a local pointer
+        on this {
+          if parSafe && needLock then _startRead();
+          ret = _findSlotInGroups(idx);
+          if parSafe && needLock then _endRead();
+        }
+        return ret;
+      }
+
       if parSafe && needLock then lockTable();
       var firstOpen = -1;
       for slotNum in _lookForSlots(idx, table.domain.high+1) {
@@ -519,6 +731,11 @@ module DefaultAssociative {
     // NOTE: Calls to this routine assume that the tableLock has been acquired.
     //
     proc _findEmptySlot(idx: idxType): (bool, index(tableDom)) {
+      if defaultAssocGroupProbe {
+        const (found, slotNum) = _findSlotInGroups(idx);
+        return (!found && slotNum != -1, slotNum);
+      }
+
       for slotNum in _lookForSlots(idx) {
         const slotStatus = table[slotNum].status;
         if (slotStatus == chpl__hash_status.empty ||
@@ -547,6 +764,52 @@ module DefaultAssociative {
       }
     }
   
+    // Searches for 'idx' a group of control bytes at a time.
+    //
+    // Returns true and its slot if found, otherwise false and the first
+    // open slot in its probe sequence (or -1 if there is none).
+    //
+    // NOTE: Calls to this routine assume that the tableLock has been
+    // acquired or that _startRead() has been called.
+    proc _findSlotInGroups(idx: idxType): (bool, index(tableDom)) {
+      const hash = chpl__defaultHashWrapper(idx):uint;
+      const full = chpl__assocCtrlFull(hash);
+      var firstOpen = -1;
+      for group in _lookForGroups(hash) {
+        const groupCtrl = c_ptrTo(ctrl[group]);
+        var matches = chpl_hash_probe_match(groupCtrl, full);
+        while matches != 0 {
+          const slotNum = group + chpl_bitops_ctz_32(matches):int;
+          if table[slotNum].idx == idx then
+            return (true, slotNum);
+          matches &= matches - 1;
+        }
+        const empty = chpl_hash_probe_match(groupCtrl, chpl__assocCtrlEmpty);
+        if firstOpen == -1 {
+          const open = empty |
+                       chpl_hash_probe_match(groupCtrl, chpl__assocCtrlDeleted);
+          if open != 0 then
+            firstOpen = group + chpl_bitops_ctz_32(open):int;
+        }
+        // 'idx' would have been placed in an empty slot of this group
+        if empty != 0 then
+          return (false, firstOpen);
+      }
+      return (false, firstOpen);
+    }
+
+    // Yields the first slot of each group to search for a hash, visiting
+    // every group once by triangular probing over the power-of-two number
+    // of groups.
+    iter _lookForGroups(hash: uint, numSlots = tableSize) {
+      const numGroups = (numSlots / chpl__assocGroupSize):uint;
+      var group = (hash >> 7) & (numGroups - 1);
+      for probe in 1..numGroups {
+        yield (group * chpl__assocGroupSize:uint):int;
+        group = (group + probe) & (numGroups - 1);
+      }
+    }
+
     iter _fullSlots(tab = table) {
       for slot in tab.domain {
         if tab[slot].status == chpl__hash_status.full then
@@ -588,6 +851,11 @@ module DefaultAssociative {
       dsiAccess(idx) = initval;
     }
 
+    override proc clearSlot(slotNum: int) {
+      const initval: eltType;
+      data[slotNum] = initval;
+    }
+
     // ref version
     proc dsiAccess(idx : idxType) ref {
       // Attempt to look up the value
@@ -895,10 +1163,12 @@ module DefaultAssociative {
     return _gen_key(i:uint);
   }
   
+  // Combines the hash 'a' of field number 'fieldnum' of a record or tuple
+  // with the hash 'b' of its preceding fields.  See chpl-hash.h.
   inline proc chpl__defaultHashCombine(a:uint, b:uint, fieldnum:int): uint {
-    extern proc chpl_bitops_rotl_64(x: uint(64), n: uint(64)) : uint(64);
-    var n:uint = (17 + fieldnum):uint;
-    return a ^ chpl_bitops_rotl_64(b, n);
+    extern proc chpl_hash_combine(h: uint(64), acc: uint(64),
+                                  fieldnum: int(64)): uint(64);
+    return chpl_hash_combine(a, b, fieldnum);
   }
 
   inline proc chpl__defaultHash(b: bool): uint {
@@ -1835,6 +1835,19 @@ module DefaultRectangular {
     return transferHelper(this, destDom, srcClass, srcDom);
   }
 
+  // Parallel scan, see chpl__ScanChunks in ChapelReduce.
+  proc DefaultRectangularArr.doiScan(op, dom) where rank == 1 {
+    type resType = op.generate().type;
+    var res: [dom] resType;
+
+    const chunks = new unmanaged chpl__ScanChunks(op.type, dom.dim(1));
+    delete chunks.reduceChunks(op, this);
+    chunks.scanChunks(op, op.clone(), this, res._value);
+    delete chunks;
+
+    return res;
+  }
+
   private proc transferHelper(A, aView, B, bView) : bool {
     if A.rank == B.rank &&
        (aView.stridable == false && bView.stridable == false) &&
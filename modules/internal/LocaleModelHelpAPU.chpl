@@ -100,6 +100,7 @@ module LocaleModelHelpAPU {
    if dnode != chpl_nodeID {
       var tls = chpl_task_getChapelData();
       chpl_task_data_setup(chpl_comm_on_bundle_task_bundle(args), tls);
+      chpl_comm_on_bundle_set_lineinfo(args);
       chpl_comm_execute_on(dnode, dsubloc, fn, args, args_size);
     } else {
       // run directly on this node
@@ -131,6 +132,7 @@ module LocaleModelHelpAPU {
     if dnode != chpl_nodeID {
       var tls = chpl_task_getChapelData();
       chpl_task_data_setup(chpl_comm_on_bundle_task_bundle(args), tls);
+      chpl_comm_on_bundle_set_lineinfo(args);
       chpl_comm_execute_on_fast(dnode, dsubloc, fn, args, args_size);
     } else {
       var origSubloc = chpl_task_getRequestedSubloc();
@@ -172,6 +174,7 @@ module LocaleModelHelpAPU {
       }
     } else {
       chpl_task_data_setup(chpl_comm_on_bundle_task_bundle(args), tls);
+      chpl_comm_on_bundle_set_lineinfo(args);
       if isSerial {
         chpl_comm_execute_on(dnode, dsubloc, fn, args, args_size);
       } else {
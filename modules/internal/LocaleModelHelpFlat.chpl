@@ -67,6 +67,7 @@ module LocaleModelHelpFlat {
     } else {
       var tls = chpl_task_getChapelData();
       chpl_task_data_setup(chpl_comm_on_bundle_task_bundle(args), tls);
+      chpl_comm_on_bundle_set_lineinfo(args);
       chpl_comm_execute_on(node, chpl_sublocFromLocaleID(loc),
                            fn, args, args_size);
     }
@@ -90,6 +91,7 @@ module LocaleModelHelpFlat {
     } else {
       var tls = chpl_task_getChapelData();
       chpl_task_data_setup(chpl_comm_on_bundle_task_bundle(args), tls);
+      chpl_comm_on_bundle_set_lineinfo(args);
       chpl_comm_execute_on_fast(node, chpl_sublocFromLocaleID(loc),
                                 fn, args, args_size);
     }
@@ -122,6 +124,7 @@ module LocaleModelHelpFlat {
       }
     } else {
       chpl_task_data_setup(chpl_comm_on_bundle_task_bundle(args), tls);
+      chpl_comm_on_bundle_set_lineinfo(args);
       if isSerial {
         chpl_comm_execute_on(node, c_sublocid_any, fn, args, args_size);
       } else {
@@ -90,6 +90,7 @@ module LocaleModelHelpNUMA {
     if dnode != chpl_nodeID {
       var tls = chpl_task_getChapelData();
       chpl_task_data_setup(chpl_comm_on_bundle_task_bundle(args), tls);
+      chpl_comm_on_bundle_set_lineinfo(args);
       chpl_comm_execute_on(dnode, dsubloc, fn, args, args_size);
     } else {
       // run directly on this node
@@ -123,6 +124,7 @@ module LocaleModelHelpNUMA {
     if dnode != chpl_nodeID {
       var tls = chpl_task_getChapelData();
       chpl_task_data_setup(chpl_comm_on_bundle_task_bundle(args), tls);
+      chpl_comm_on_bundle_set_lineinfo(args);
       chpl_comm_execute_on_fast(dnode, dsubloc, fn, args, args_size);
     } else {
       var origSubloc = chpl_task_getRequestedSubloc();
@@ -166,6 +168,7 @@ module LocaleModelHelpNUMA {
       }
     } else {
       chpl_task_data_setup(chpl_comm_on_bundle_task_bundle(args), tls);
+      chpl_comm_on_bundle_set_lineinfo(args);
       if isSerial {
         chpl_comm_execute_on(dnode, dsubloc, fn, args, args_size);
       } else {
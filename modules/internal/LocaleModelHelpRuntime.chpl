@@ -104,6 +104,9 @@ module LocaleModelHelpRuntime {
                                         args: chpl_comm_on_bundle_p, args_size: size_t);
   extern proc chpl_comm_execute_on_nb(loc_id: int, subloc_id: int, fn: int,
                                       args: chpl_comm_on_bundle_p, args_size: size_t);
+  // records where an "on" came from, for comm diagnostics
+  pragma "insert line file info"
+    extern proc chpl_comm_on_bundle_set_lineinfo(args: chpl_comm_on_bundle_p);
   pragma "insert line file info"
     extern proc chpl_comm_taskCallFTable(fn: int,
                                          args: chpl_comm_on_bundle_p, args_size: size_t,
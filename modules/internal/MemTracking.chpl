@@ -30,6 +30,8 @@ module MemTracking
     memLeaks: bool = false,
     memMax: uint = 0,
     memThreshold: uint = 0,
+    memSample: uint = 0,
+    memSampleByCount: bool = false,
     memLog: string;
 
   pragma "no auto destroy"
@@ -55,7 +57,8 @@ module MemTracking
 
   // Safely cast to size_t instances of memMax and memThreshold.
   const cMemMax = memMax.safeCast(size_t),
-    cMemThreshold = memThreshold.safeCast(size_t);
+    cMemThreshold = memThreshold.safeCast(size_t),
+    cMemSample = memSample.safeCast(size_t);
 
   //
   // This communicates the settings of the various memory tracking
@@ -77,6 +80,8 @@ module MemTracking
                                          ref ret_memLeaks: bool,
                                          ref ret_memMax: size_t,
                                          ref ret_memThreshold: size_t,
+                                         ref ret_memSample: size_t,
+                                         ref ret_memSampleByCount: bool,
                                          ref ret_memLog: c_string,
                                          ref ret_memLeaksLog: c_string) {
     ret_memTrack = memTrack;
@@ -85,6 +90,8 @@ module MemTracking
     ret_memLeaks = memLeaks;
     ret_memMax = cMemMax;
     ret_memThreshold = cMemThreshold;
+    ret_memSample = cMemSample;
+    ret_memSampleByCount = memSampleByCount;
 
     if (here.id != 0) {
       if memLeaksByDesc.length != 0 {
@@ -179,6 +179,13 @@ module String {
   pragma "fn synchronization free"
   private extern proc qio_nbytes_char(chr:int(32)):c_int;
 
+  private extern proc chpl_bytes_find(hay: bufferType, hayLen: int,
+                                      needle: bufferType, needleLen: int): int;
+  private extern proc chpl_bytes_rfind(hay: bufferType, hayLen: int,
+                                       needle: bufferType, needleLen: int): int;
+  private extern proc chpl_bytes_count(hay: bufferType, hayLen: int,
+                                       needle: bufferType, needleLen: int): int;
+
   pragma "no doc"
   extern const CHPL_SHORT_STRING_SIZE : c_int;
 
@@ -298,6 +305,11 @@ module String {
     // We use chpl_nodeID as a shortcut to get at here.id without actually constructing
     // a locale object. Used when determining if we should make a remote transfer.
     var locale_id = chpl_nodeID; // : chpl_nodeID_t
+    pragma "no doc"
+    // The string's hash, computed the first time it is needed by
+    // chpl__defaultHash(), or 0 if it hasn't been.  Anything that changes
+    // the contents of the string must reset it.
+    var _hash: uint = 0;
 
     pragma "no doc"
     proc init() {
@@ -316,6 +328,7 @@ module String {
       const sRemote = _local == false && s.locale_id != chpl_nodeID;
       const sLen = s.len;
       this.isowned = isowned;
+      this._hash = s._hash;
       this.complete();
       // Don't need to do anything if s is an empty string
       if sLen != 0 {
@@ -469,6 +482,7 @@ module String {
       }
 
       this.len = s_len;
+      this._hash = 0;
     }
 
     /*
@@ -889,8 +903,6 @@ module String {
 
 
     // Helper function that uses a param bool to toggle between count and find
-    //TODO: this could be a much better string search
-    //      (Boyer-Moore-Horspool|any thing other than brute force)
     //
     pragma "no doc"
     inline proc _search_helper(needle: string, region: range(?),
@@ -930,27 +942,43 @@ module String {
           localRet = 0;
           const localNeedle: string = needle.localize();
 
-          // i *is not* an index into anything, it is the order of the element
-          // of view we are searching from.
-          const numPossible = thisLen - nLen + 1;
-          const searchSpace = if fromLeft
-              then 0..#(numPossible)
-              else 0..#(numPossible) by -1;
-          for i in searchSpace {
-            // j *is* the index into the localNeedle's buffer
-            for j in 0..#nLen {
-              const idx = view.orderToIndex(i+j); // 1s based idx
-              if this.buff[idx-1] != localNeedle.buff[j] then break;
-
-              if j == nLen-1 {
-                if count {
-                  localRet += 1;
-                } else { // find
-                  localRet = view.orderToIndex(i);
+          if view.stridable && view.stride != 1 {
+            // i *is not* an index into anything, it is the order of the
+            // element of view we are searching from.
+            const numPossible = thisLen - nLen + 1;
+            const searchSpace = if fromLeft
+                then 0..#(numPossible)
+                else 0..#(numPossible) by -1;
+            for i in searchSpace {
+              // j *is* the index into the localNeedle's buffer
+              for j in 0..#nLen {
+                const idx = view.orderToIndex(i+j); // 1s based idx
+                if this.buff[idx-1] != localNeedle.buff[j] then break;
+
+                if j == nLen-1 {
+                  if count {
+                    localRet += 1;
+                  } else { // find
+                    localRet = view.orderToIndex(i);
+                  }
                 }
               }
+              if !count && localRet != 0 then break;
+            }
+          } else {
+            // The view is contiguous, so search its bytes directly.
+            const first = view.first:int;
+            const hay = this.buff + (first - 1);
+            if count {
+              localRet = chpl_bytes_count(hay, thisLen,
+                                          localNeedle.buff, nLen);
+            } else {
+              const pos = if fromLeft
+                then chpl_bytes_find(hay, thisLen, localNeedle.buff, nLen)
+                else chpl_bytes_rfind(hay, thisLen, localNeedle.buff, nLen);
+              if pos >= 0 then
+                localRet = first + pos;
             }
-            if !count && localRet != 0 then break;
           }
         }
         ret = localRet;
@@ -1006,24 +1034,52 @@ module String {
       :returns: a copy of the string where `replacement` replaces `needle` up
                 to `count` times
      */
-    // TODO: not ideal - count and single allocation probably faster
-    //                 - can special case on replacement|needle.length (0, 1)
     proc replace(needle: string, replacement: string, count: int = -1) : string {
-      var result: string = this;
-      var found: int = 0;
-      var startIdx: int = 1;
+      const localThis: string = this.localize();
       const localNeedle: string = needle.localize();
       const localReplacement: string = replacement.localize();
+      const thisLen = localThis.len;
+      const nLen = localNeedle.len;
+      const rLen = localReplacement.len;
 
-      while (count < 0) || (found < count) {
-        const idx = result.find(localNeedle, startIdx..);
-        if !idx then break;
+      if nLen == 0 || nLen > thisLen then return localThis;
 
+      // Count the replacements first, so the result can be built with a
+      // single allocation.
+      var found: int = 0;
+      var off: int = 0;
+      while (count < 0) || (found < count) {
+        const pos = chpl_bytes_find(localThis.buff + off, thisLen - off,
+                                    localNeedle.buff, nLen);
+        if pos < 0 then break;
         found += 1;
-        result = result[..idx-1] + localReplacement + result[(idx + localNeedle.length)..];
-        startIdx = idx + localReplacement.length;
+        off += pos + nLen;
       }
-      return result;
+      if found == 0 then return localThis;
+
+      var ret: string;
+      ret.len = thisLen + found * (rLen - nLen);
+      const allocSize = chpl_here_good_alloc_size(ret.len+1);
+      ret._size = allocSize;
+      ret.buff = chpl_here_alloc(allocSize,
+                                offset_STR_COPY_DATA): bufferType;
+      ret.isowned = true;
+
+      var src: int = 0;
+      var dst: int = 0;
+      for 1..found {
+        const pos = chpl_bytes_find(localThis.buff + src, thisLen - src,
+                                    localNeedle.buff, nLen);
+        c_memcpy(ret.buff + dst, localThis.buff + src, pos);
+        dst += pos;
+        c_memcpy(ret.buff + dst, localReplacement.buff, rLen);
+        dst += rLen;
+        src += pos + nLen;
+      }
+      c_memcpy(ret.buff + dst, localThis.buff + src, thisLen - src);
+      ret.buff[ret.len] = 0;
+
+      return ret;
     }
 
     /*
@@ -1059,8 +1115,12 @@ module String {
             chunk = localThis;
             done = true;
           } else {
-            if (splitAll || splitCount < maxsplit) then
-              end = localThis.find(localSep, start..);
+            if (splitAll || splitCount < maxsplit) && !localSep.isEmpty() {
+              const pos = chpl_bytes_find(localThis.buff + (start-1),
+                                          localThis.len - (start-1),
+                                          localSep.buff, localSep.len);
+              end = if pos < 0 then 0 else start + pos;
+            }
 
             if(end == 0) {
               // Separator not found
@@ -1557,6 +1617,8 @@ module String {
     */
     proc toLower() : string {
       var result: string = this;
+      // result is changed in place below, so it can't keep this hash
+      result._hash = 0;
       if result.isEmpty() then return result;
 
       var i = 0;
@@ -1590,6 +1652,8 @@ module String {
     */
     proc toUpper() : string {
       var result: string = this;
+      // result is changed in place below, so it can't keep this hash
+      result._hash = 0;
       if result.isEmpty() then return result;
 
       var i = 0;
@@ -1624,6 +1688,8 @@ module String {
      */
     proc toTitle() : string {
       var result: string = this;
+      // result is changed in place below, so it can't keep this hash
+      result._hash = 0;
       if result.isEmpty() then return result;
 
       param UN = 0, LETTER = 1;
@@ -1669,6 +1735,8 @@ module String {
     pragma "no doc"
     proc capitalize() : string {
       var result: string = this.toLower();
+      // result is changed in place below, so it can't keep this hash
+      result._hash = 0;
       if result.isEmpty() then return result;
 
       var codepoint: int(32);
@@ -1705,6 +1773,7 @@ module String {
           remote_buf = copyRemoteBuffer(rhs.locale_id, rhs.buff, len);
         lhs.reinitString(remote_buf, len, len+1, needToCopy=false);
       }
+      lhs._hash = rhs._hash;
     }
 
     if _local || lhs.locale_id == chpl_nodeID then {
@@ -1956,6 +2025,7 @@ module String {
       }
       lhs.len = newLength;
       lhs.buff[newLength] = 0;
+      lhs._hash = 0;
     }
   }
 
@@ -2192,18 +2262,28 @@ module String {
   //
 
   pragma "no doc"
-  inline proc chpl__defaultHash(x : string): uint {
-    var hash: int(64);
-    on __primitive("chpl_on_locale_num",
-                   chpl_buildLocaleID(x.locale_id, c_sublocid_any)) {
-      // Use djb2 (Dan Bernstein in comp.lang.c), XOR version
-      var locHash: int(64) = 5381;
-      for c in 0..#(x.length) {
-        locHash = ((locHash << 5) + locHash) ^ x.buff[c];
+  extern proc chpl_hash_bytes(key: bufferType, len: int, seed: uint): uint;
+
+  pragma "no doc"
+  inline proc chpl__defaultHash(const ref x : string): uint {
+    if x._hash != 0 then return x._hash;
+
+    var hash: uint;
+    if _local || x.locale_id == chpl_nodeID {
+      hash = chpl_hash_bytes(x.buff, x.len, 0);
+    } else {
+      on __primitive("chpl_on_locale_num",
+                     chpl_buildLocaleID(x.locale_id, c_sublocid_any)) {
+        hash = chpl_hash_bytes(x.buff, x.len, 0);
       }
-      hash = locHash;
     }
-    return hash:uint;
+    // 0 means "not computed yet" in the cache
+    if hash == 0 then hash = 1;
+
+    // Cache the hash in 'x'.  Tasks hashing the same string concurrently
+    // all store the same value, so this doesn't need to be synchronized.
+    __primitive("=", x._hash, hash);
+    return hash;
   }
 
   //
@@ -34,6 +34,8 @@ module MemTracking
                                          ref ret_memLeaksTable: bool,
                                          ref ret_memMax: uint(64),       // **
                                          ref ret_memThreshold: uint(64), // **
+                                         ref ret_memSample: uint(64),    // **
+                                         ref ret_memSampleByCount: bool,
                                          ref ret_memLog: c_string,
                                          ref ret_memLeaksLog: c_string) {
 
@@ -69,13 +69,18 @@
    updates to perform and the order of those operations doesn't matter.
 
    .. note::
-     Currently, these are only optimized for ``CHPL_NETWORK_ATOMICS=ugni``.
-     Processor atomics or any other implementation falls back to non-buffered
-     operations. Under ugni these operations are internally buffered. When the
-     buffers are flushed, the operations are performed all at once. Cray Linux
-     Environment (CLE) 5.2.UP04 or newer is required for best performance. In
-     our experience, buffered atomics can achieve up to a 5X performance
-     improvement over non-buffered atomics for CLE 5.2UP04 or newer.
+     Under ``CHPL_NETWORK_ATOMICS=ugni`` these operations are internally
+     buffered. When the buffers are flushed, the operations are performed all
+     at once. Cray Linux Environment (CLE) 5.2.UP04 or newer is required for
+     best performance. In our experience, buffered atomics can achieve up to a
+     5X performance improvement over non-buffered atomics for CLE 5.2UP04 or
+     newer.
+
+     With processor atomics under ``CHPL_COMM=gasnet`` or ``ofi``, updates
+     of 32- and 64-bit atomics on other locales are buffered per target
+     locale and shipped there in batches, where they are applied together.
+     Updates of atomics on the current locale, of smaller atomic types,
+     and under other configurations are done right away.
  */
 module BufferedAtomics {
 
@@ -85,9 +90,30 @@ module BufferedAtomics {
     if isReal(T) then return "chpl_comm_atomic_" + s + "_real" + numBits(T):string;
   }
 
+  // Buffered updates of processor atomics go through the runtime's
+  // portable unordered atomics, which ugni doesn't provide.
+  private proc procExternFunc(param s: string, type T) param {
+    if isInt(T)  then return "chpl_comm_proc_atomic_" + s + "_int"  + numBits(T):string;
+    if isUint(T) then return "chpl_comm_proc_atomic_" + s + "_uint" + numBits(T):string;
+    if isReal(T) then return "chpl_comm_proc_atomic_" + s + "_real" + numBits(T):string;
+  }
+
+  private proc procBuffAvailable(type T) param {
+    return CHPL_COMM != "none" && CHPL_COMM != "ugni" && numBits(T) >= 32;
+  }
+
   /* Buffered atomic add. */
   inline proc AtomicT.addBuff(value:T): void {
-    this.add(value);
+    if procBuffAvailable(T) {
+      pragma "insert line file info" extern procExternFunc("add_unordered", T)
+        proc atomic_add_unordered(ref op:T, l:int(32), obj:c_void_ptr): void;
+
+      var v = value;
+      atomic_add_unordered(v, _v.locale.id:int(32),
+                          __primitive("_wide_get_addr", _v));
+    } else {
+      this.add(value);
+    }
   }
   pragma "no doc"
   inline proc RAtomicT.addBuff(value:T): void {
@@ -100,7 +126,16 @@ module BufferedAtomics {
 
   /* Buffered atomic sub. */
   inline proc AtomicT.subBuff(value:T): void {
-    this.sub(value);
+    if procBuffAvailable(T) {
+      pragma "insert line file info" extern procExternFunc("sub_unordered", T)
+        proc atomic_sub_unordered(ref op:T, l:int(32), obj:c_void_ptr): void;
+
+      var v = value;
+      atomic_sub_unordered(v, _v.locale.id:int(32),
+                          __primitive("_wide_get_addr", _v));
+    } else {
+      this.sub(value);
+    }
   }
   pragma "no doc"
   inline proc RAtomicT.subBuff(value:T): void {
@@ -113,7 +148,17 @@ module BufferedAtomics {
 
   /* Buffered atomic or. */
   inline proc AtomicT.orBuff(value:T): void {
-    this.or(value);
+    if !isIntegral(T) then compilerError("or is only defined for integer atomic types");
+    if procBuffAvailable(T) {
+      pragma "insert line file info" extern procExternFunc("or_unordered", T)
+        proc atomic_or_unordered(ref op:T, l:int(32), obj:c_void_ptr): void;
+
+      var v = value;
+      atomic_or_unordered(v, _v.locale.id:int(32),
+                          __primitive("_wide_get_addr", _v));
+    } else {
+      this.or(value);
+    }
   }
   pragma "no doc"
   inline proc RAtomicT.orBuff(value:T): void {
@@ -127,7 +172,17 @@ module BufferedAtomics {
 
   /* Buffered atomic and. */
   inline proc AtomicT.andBuff(value:T): void {
-    this.and(value);
+    if !isIntegral(T) then compilerError("and is only defined for integer atomic types");
+    if procBuffAvailable(T) {
+      pragma "insert line file info" extern procExternFunc("and_unordered", T)
+        proc atomic_and_unordered(ref op:T, l:int(32), obj:c_void_ptr): void;
+
+      var v = value;
+      atomic_and_unordered(v, _v.locale.id:int(32),
+                          __primitive("_wide_get_addr", _v));
+    } else {
+      this.and(value);
+    }
   }
   pragma "no doc"
   inline proc RAtomicT.andBuff(value:T): void {
@@ -141,7 +196,17 @@ module BufferedAtomics {
 
   /* Buffered atomic xor. */
   inline proc AtomicT.xorBuff(value:T): void {
-    this.xor(value);
+    if !isIntegral(T) then compilerError("xor is only defined for integer atomic types");
+    if procBuffAvailable(T) {
+      pragma "insert line file info" extern procExternFunc("xor_unordered", T)
+        proc atomic_xor_unordered(ref op:T, l:int(32), obj:c_void_ptr): void;
+
+      var v = value;
+      atomic_xor_unordered(v, _v.locale.id:int(32),
+                          __primitive("_wide_get_addr", _v));
+    } else {
+      this.xor(value);
+    }
   }
   pragma "no doc"
   inline proc RAtomicT.xorBuff(value:T): void {
@@ -165,5 +230,11 @@ module BufferedAtomics {
         chpl_comm_atomic_unordered_fence();
       }
     }
+    if CHPL_COMM != "none" && CHPL_COMM != "ugni" {
+      extern proc chpl_comm_proc_atomic_unordered_fence();
+      coforall loc in Locales do on loc {
+        chpl_comm_proc_atomic_unordered_fence();
+      }
+    }
   }
 }
@@ -49,13 +49,18 @@
    to perform and the order of those operations doesn't matter.
 
    .. note::
-     Currently, this is only optimized for ``CHPL_COMM=ugni``. Other
-     communication layers fall back to regular gets. Under ugni GETs
-     are internally buffered. When the buffers are flushed, the operations are
-     performed all at once. Cray Linux Environment (CLE) 5.2.UP04 or newer is
-     required for best performance. In our experience, buffered gets can
-     achieve up to a 5X performance improvement over non-buffered gets for
-     CLE 5.2UP04 or newer.
+     Under ``CHPL_COMM=ugni`` GETs are internally buffered. When the
+     buffers are flushed, the operations are performed all at once. Cray
+     Linux Environment (CLE) 5.2.UP04 or newer is required for best
+     performance. In our experience, buffered gets can achieve up to a 5X
+     performance improvement over non-buffered gets for CLE 5.2UP04 or
+     newer.
+
+     Other communication layers (``gasnet`` and ``ofi``) start each GET
+     as a non-blocking transfer and only wait for it when the task's
+     window of outstanding transfers fills up or the buffers are
+     flushed. With ``CHPL_COMM=none`` there is no remote memory, so these
+     are regular gets.
  */
 module BufferedGets {
   /*
@@ -64,7 +69,7 @@ module BufferedGets {
   inline proc getBuff(ref LHS, ref RHS): void {
     if !(isNumericType(LHS.type) && LHS.type == RHS.type) then
       compilerError("getBuff is only supported on numeric types");
-    if CHPL_COMM == 'ugni' {
+    if CHPL_COMM != 'none' {
       __primitive("chpl_comm_get_unordered", LHS, RHS.locale.id, RHS, numBytes(RHS.type));
     } else {
       __primitive("chpl_comm_get", LHS, RHS.locale.id, RHS, numBytes(RHS.type));
@@ -77,7 +82,7 @@ module BufferedGets {
      locale.
    */
   inline proc flushGetBuff(): void {
-    if CHPL_COMM == 'ugni' {
+    if CHPL_COMM != 'none' {
       extern proc chpl_comm_get_unordered_fence();
       coforall loc in Locales do on loc {
         chpl_comm_get_unordered_fence();
@@ -34,15 +34,14 @@
   with a best-effort round-robin algorithm such that each task begins searching
   at another segment (with the added benefit of reducing overall contention), in
   particular is useful for locally distributing insertion operations. Next it also
-  employs a work-stealing algorithm that horizontally steals a ratio of elements
-  across segments. A segment is considered 'horizontal' if it shares the same
-  segment index within [0, here.maxTaskPar); those other segments likely are also
-  benefited from local distribution from the round-robin algorithm discussed above.
-  We also steal a ratio of elements, say 25%, because it leaves all other segments
-  with 75% of their work; the more elements they have, the more we take, but the
-  less they have, the less we steal; this also has the added benefit of reducing
-  unnecessary work stealing between segments when the bag is nearly emptied. Furthermore,
-  stealing horizontally ensures that all segments remain filled and that we still
+  employs a work-stealing algorithm where a single task per node steals from one
+  victim node at a time, starting with the node it last stole from successfully;
+  the other nodes are not disturbed. We steal a ratio of the victim's elements,
+  say 25%, because it leaves the victim with 75% of its work; the more elements it
+  has, the more we take, but the less it has, the less we steal; this also has the
+  added benefit of reducing unnecessary work stealing between nodes when the bag is
+  nearly emptied. The elements are taken from the victim's fullest segments with one
+  bulk transfer per block, and spread across all of our segments, so that we still
   achieve parallelism across segments for removal operations. Lastly, we attempt
   to steal a maximum of `N / sizeof(eltType)`, where N is some size in megabytes
   (representing how much data can be sent in one network request), which keeps
@@ -104,14 +103,7 @@
   Planned Improvements
   ____________________
 
-  1.  Dynamic work-stealing will require an overhaul to use a helper algorithm to keep down
-      the number of tasks spawned. Currently user tasks will wait on the current work-stealer
-      task, which will spawn is own helper tasks which act as shepherds, which then spawns more
-      in a fork-join fashion. This leads to an excessive amount of tasks being spawned at once.
-      To make matters worse, the waiting tasks don't even get any elements, nor does the work
-      stealing task, which opens up the possibility of live-lock where nodes steal work back
-      and forth before either can process it.
-  2.  Static work-stealing (A.K.A :proc:`balance`) requires a rework that performs a more distributed
+  1.  Static work-stealing (A.K.A :proc:`balance`) requires a rework that performs a more distributed
       and fast way of distributing memory, as currently 'excess' elements are shifted to a single
       node to be redistributed in the next pass. On the note, we need to collapse the pass for moving
       excess elements into a single pass, hopefully with a zero-copy overhead.
@@ -341,6 +333,25 @@ module DistributedBag {
       return bag.remove();
     }
 
+    /*
+      Insert elements in bulk to this node's bag. They are gathered into chunks,
+      and each chunk is added to a segment at once, holding its lock only to copy
+      the chunk in. Returns the number of elements added.
+    */
+    override proc addBulk(elts) : int {
+      return bag.addBulk(elts);
+    }
+
+    /*
+      Remove up to `nElts` elements in bulk from this node's bag, returning them
+      as an array. Elements are moved out of each segment a block at a time. If
+      this node's bag runs out, it will attempt to steal elements from bags of
+      other nodes, and the array is shrunk if there are not enough elements.
+    */
+    override proc removeBulk(nElts : int) {
+      return bag.removeBulk(nElts);
+    }
+
     /*
       Obtain the number of elements held in all bags across all nodes. This method
       is best-effort and can be non-deterministic for concurrent updates across nodes,
@@ -386,15 +397,8 @@ module DistributedBag {
         forall segmentIdx in 0 .. #here.maxTaskPar {
           ref segment = instance.bag.segments[segmentIdx];
           if segment.acquireIfNonEmpty(STATUS_REMOVE) {
-            var block = segment.headBlock;
-            while block != nil {
-              var tmp = block;
-              block = block.next;
-              delete tmp;
-            }
-
-            segment.headBlock = nil;
-            segment.tailBlock = nil;
+            while segment.headBlock != nil do
+              segment.popHeadBlock();
             segment.nElems.write(0);
             segment.releaseStatus();
           }
@@ -693,6 +697,11 @@ module DistributedBag {
     var headBlock : unmanaged BagSegmentBlock(eltType);
     var tailBlock : unmanaged BagSegmentBlock(eltType);
 
+    // A block emptied by a removal, kept for the next addition that needs a new
+    // block. Under a steady stream of additions and removals, this saves an
+    // allocation and a free while the segment is locked.
+    var spareBlock : unmanaged BagSegmentBlock(eltType);
+
     var nElems : atomic uint;
 
     inline proc isEmpty {
@@ -744,6 +753,45 @@ module DistributedBag {
       status.write(STATUS_UNLOCKED);
     }
 
+    // Append a new, empty block to the list, reusing the spare block if there is
+    // one. Otherwise it is of initial size, or double the size of the last block.
+    inline proc appendBlock() {
+      var block = spareBlock;
+      if block != nil {
+        spareBlock = nil;
+        block.size = 0;
+        block.next = nil;
+      } else {
+        const cap = if tailBlock == nil then distributedBagInitialBlockSize
+                    else min(distributedBagMaxBlockSize, tailBlock.cap * 2);
+        block = new unmanaged BagSegmentBlock(eltType, cap);
+      }
+
+      if tailBlock == nil then headBlock = block;
+      else tailBlock.next = block;
+      tailBlock = block;
+      return block;
+    }
+
+    // Unlink the head block, keeping it as the spare block if there is none.
+    inline proc popHeadBlock() {
+      var tmp = headBlock;
+      headBlock = headBlock.next;
+      if headBlock == nil then tailBlock = nil;
+
+      if spareBlock == nil then spareBlock = tmp;
+      else delete tmp;
+    }
+
+    proc freeBlocks() {
+      while headBlock != nil do
+        popHeadBlock();
+      if spareBlock != nil {
+        delete spareBlock;
+        spareBlock = nil;
+      }
+    }
+
     inline proc transferElements(destPtr, n, locId = here.id) {
       var destOffset = 0;
       var srcOffset = 0;
@@ -769,13 +817,8 @@ module DistributedBag {
         }
 
         // Fix list if we consumed last one...
-        if headBlock.isEmpty {
-          var tmp = headBlock;
-          headBlock = headBlock.next;
-          delete tmp;
-
-          if headBlock == nil then tailBlock = nil;
-        }
+        if headBlock.isEmpty then
+          popHeadBlock();
       }
 
       nElems.sub(n : uint);
@@ -785,19 +828,9 @@ module DistributedBag {
       var offset = 0;
       while offset < n {
         var block = tailBlock;
-        // Empty? Create a new one of initial size
-        if block == nil then {
-          tailBlock = new unmanaged BagSegmentBlock(eltType, distributedBagInitialBlockSize);
-          headBlock = tailBlock;
-          block = tailBlock;
-        }
-
-        // Full? Create a new one double the previous size
-        if block.isFull {
-          block.next = new unmanaged BagSegmentBlock(eltType, min(distributedBagMaxBlockSize, block.cap * 2));
-          tailBlock = block.next;
-          block = block.next;
-        }
+        // Empty or full? Add a new block
+        if block == nil || block.isFull then
+          block = appendBlock();
 
         var nLeft = n - offset;
         var nSpace = block.cap - block.size;
@@ -829,13 +862,8 @@ module DistributedBag {
         nElems.sub(1);
 
         // Fix list if we consumed last one...
-        if headBlock.isEmpty {
-          var tmp = headBlock;
-          headBlock = headBlock.next;
-          delete tmp;
-
-          if headBlock == nil then tailBlock = nil;
-        }
+        if headBlock.isEmpty then
+          popHeadBlock();
       }
 
       return arr;
@@ -855,13 +883,8 @@ module DistributedBag {
       nElems.sub(1);
 
       // Fix list if we consumed last one...
-      if headBlock.isEmpty {
-        var tmp = headBlock;
-        headBlock = headBlock.next;
-        delete tmp;
-
-        if headBlock == nil then tailBlock = nil;
-      }
+      if headBlock.isEmpty then
+        popHeadBlock();
 
       return (true, elem);
     }
@@ -869,19 +892,9 @@ module DistributedBag {
     inline proc addElements(elt : eltType) {
       var block = tailBlock;
 
-      // Empty? Create a new one of initial size
-      if block == nil then {
-        tailBlock = new unmanaged BagSegmentBlock(eltType, distributedBagInitialBlockSize);
-        headBlock = tailBlock;
-        block = tailBlock;
-      }
-
-      // Full? Create a new one double the previous size
-      if block.isFull {
-        block.next = new unmanaged BagSegmentBlock(eltType, min(distributedBagMaxBlockSize, block.cap * 2));
-        tailBlock = block.next;
-        block = block.next;
-      }
+      // Empty or full? Add a new block
+      if block == nil || block.isFull then
+        block = appendBlock();
 
       block.push(elt);
       nElems.add(1);
@@ -921,7 +934,14 @@ module DistributedBag {
     var loadBalanceInProgress : atomic bool;
     var loadBalanceResult : atomic bool;
 
-
+    /*
+      Work stealing picks one victim node at a time. It first tries the node it
+      last stole from successfully, which likely still has work, and then the
+      others round-robin from a rotating offset, so that nodes do not all pick
+      the same victim.
+    */
+    var lastVictim : atomic int;
+    var victimOffset : atomic int;
 
     var maxParallelSegmentSpace = {0 .. #here.maxTaskPar};
     var segments : [maxParallelSegmentSpace] BagSegment(eltType);
@@ -937,17 +957,13 @@ module DistributedBag {
     proc init(type eltType, parentHandle) {
       this.eltType = eltType;
       this.parentHandle = parentHandle;
+      this.complete();
+      lastVictim.write(-1);
     }
 
     proc deinit() {
-      forall segment in segments {
-        var block = segment.headBlock;
-        while block != nil {
-          var tmp = block;
-          block = block.next;
-          delete tmp;
-        }
-      }
+      forall segment in segments do
+        segment.freeBlocks();
     }
 
     proc add(elt : eltType) : bool {
@@ -980,20 +996,18 @@ module DistributedBag {
           /*
             Pass 2: Average Case
 
-            Find any segment (locked or unlocked) and make an attempt to acquire it.
+            All segments were locked. Keep sweeping over them, yielding between
+            sweeps, and take the first that becomes unlocked rather than waiting
+            on any one of them.
           */
           when ADD_AVERAGE_CASE {
-            ref segment = segments[startIdx];
-
             while true {
-              select segment.currentStatus {
-                // Quick acquire...
-                when STATUS_UNLOCKED do {
-                  if segment.acquireWithStatus(STATUS_ADD) {
-                    segment.addElements(elt);
-                    segment.releaseStatus();
-                    return true;
-                  }
+              for offset in 0 .. #here.maxTaskPar {
+                ref segment = segments[(startIdx + offset) % here.maxTaskPar];
+                if segment.isUnlocked && segment.acquireWithStatus(STATUS_ADD) {
+                  segment.addElements(elt);
+                  segment.releaseStatus();
+                  return true;
                 }
               }
               chpl_task_yield();
@@ -1127,86 +1141,16 @@ module DistributedBag {
                     }
 
                     // We are the sole work stealer, and so it is our responsibility
-                    // to balance the load for our node. We fork-join new worker
-                    // tasks that will check horizontally across each node (as in
-                    // across each segment with the same index), and vertically across
-                    // each segment (each segment in a node). Horizontally, we steal
-                    // at most a % of work from other nodes to give to ourselves.
-                    // As load balancer, we also are the only one who knows whether
-                    // or not all bags are empty.
-                    var isEmpty : atomic bool;
-                    isEmpty.write(true);
+                    // to balance the load for our node. As load balancer, we also are
+                    // the only one who knows whether or not all bags are empty.
                     segment.releaseStatus();
-                    coforall segmentIdx in 0..#here.maxTaskPar {
-                      var stolenWork : [{0..#numLocales}] (int, c_ptr(eltType));
-                      coforall loc in parentHandle.targetLocalesNotHere() {
-                        if loc != here then on loc {
-                          // As we jumped to the target node, 'localBag' returns
-                          // the target's bag that we are attempting to steal from.
-                          var targetBag = parentHandle.bag;
-
-                          // Only proceed if the target is not load balancing themselves...
-                          if !targetBag.loadBalanceInProgress.read() {
-                            ref targetSegment = targetBag.segments[segmentIdx];
-
-                            // As we only care that the segment contains data,
-                            // we test-and-test-and-set until we gain ownership.
-                            while targetSegment.nElems.read() >= distributedBagWorkStealingMinElems {
-                              var backoff = 0;
-                              if targetSegment.currentStatus == STATUS_UNLOCKED && targetSegment.acquireWithStatus(STATUS_REMOVE) {
-                                // Sanity check: ensure segment did not fall under minimum since last check
-                                if  targetSegment.nElems.read() < distributedBagWorkStealingMinElems {
-                                  targetSegment.releaseStatus();
-                                  break;
-                                }
-
-                                extern proc sizeof(type x): size_t;
-                                // We steal at most 1MB worth of data. If the user has less than that, we steal a %, at least 1.
-                                const mb = distributedBagWorkStealingMemCap * 1024 * 1024;
-                                var toSteal = max(distributedBagWorkStealingMinElems, min(mb / sizeof(eltType), targetSegment.nElems.read() * distributedBagWorkStealingRatio)) : int;
-
-                                // Allocate storage...
-                                on stolenWork do stolenWork[loc.id] = (toSteal, c_malloc(eltType, toSteal));
-                                var destPtr = stolenWork[here.id][2];
-                                targetSegment.transferElements(destPtr, toSteal, stolenWork.locale.id);
-                                targetSegment.releaseStatus();
-
-                                // We are done...
-                                break;
-                              }
-
-                              // Backoff...
-                              chpl_task_yield();
-                            }
-                          }
-                        }
-                      }
+                    const foundWork = stealWork();
 
-                      // It is our job now to distribute all stolen data to the same
-                      // horizontal segment on our node. Acquire lock...
-                      ref recvSegment = segments[segmentIdx];
-                      while true {
-                        if recvSegment.currentStatus == STATUS_UNLOCKED && recvSegment.acquireWithStatus(STATUS_ADD) then break;
-                        chpl_task_yield();
-                      }
-
-                      // Add stolen elements to segment...
-                      for (nStolen, stolenPtr) in stolenWork {
-                        if nStolen == 0 then continue;
-                        recvSegment.addElementsPtr(stolenPtr, nStolen);
-                        c_free(stolenPtr);
-
-                        // Let parent know that the bag is not empty.
-                        isEmpty.write(false);
-                      }
-                      recvSegment.releaseStatus();
-                    }
-
-                    loadBalanceResult.write(!isEmpty.read());
+                    loadBalanceResult.write(foundWork);
                     loadBalanceInProgress.write(false);
 
                     // At this point, if no work has been found, we will return empty...
-                    if isEmpty.read() {
+                    if !foundWork {
                       var default: eltType;
                       return (false, default);
                     } else {
@@ -1234,5 +1178,202 @@ module DistributedBag {
 
       halt("DistributedBag Internal Error: DEADCODE");
     }
+
+    // Add the 'n' elements at 'ptr' to a single segment, preferring one that is
+    // unlocked.
+    proc addChunk(ptr, n) {
+      const startIdx = nextStartIdxEnq;
+      while true {
+        for offset in 0 .. #here.maxTaskPar {
+          ref segment = segments[(startIdx + offset) % here.maxTaskPar];
+          if segment.isUnlocked && segment.acquireWithStatus(STATUS_ADD) {
+            segment.addElementsPtr(ptr, n);
+            segment.releaseStatus();
+            return;
+          }
+        }
+        chpl_task_yield();
+      }
+    }
+
+    proc addBulk(elts) : int {
+      const chunkSize = distributedBagInitialBlockSize;
+      var buffer = c_malloc(eltType, chunkSize);
+      var n = 0;
+      var total = 0;
+
+      for elt in elts {
+        buffer[n] = elt;
+        n += 1;
+        if n == chunkSize {
+          addChunk(buffer, n);
+          total += n;
+          n = 0;
+        }
+      }
+
+      if n > 0 {
+        addChunk(buffer, n);
+        total += n;
+      }
+
+      c_free(buffer);
+      return total;
+    }
+
+    proc removeBulk(nElts : int) {
+      var dom = {0..#max(nElts, 0)};
+      var arr : [dom] eltType;
+      var nTaken = 0;
+
+      while nTaken < nElts {
+        // Move as many elements as we need out of each unlocked segment.
+        var foundElts = false;
+        const startIdx = nextStartIdxDeq;
+        for offset in 0 .. #here.maxTaskPar {
+          if nTaken == nElts then break;
+
+          ref segment = segments[(startIdx + offset) % here.maxTaskPar];
+          if !segment.isEmpty && segment.acquireWithStatus(STATUS_REMOVE) {
+            const n = min(nElts - nTaken, segment.nElems.read() : int);
+            if n > 0 {
+              segment.transferElements(c_ptrTo(arr[nTaken]), n);
+              nTaken += n;
+              foundElts = true;
+            }
+            segment.releaseStatus();
+          }
+        }
+
+        // Nothing unlocked was found; fall back to 'remove', which waits on
+        // locked segments and steals work from other nodes.
+        if !foundElts {
+          var (hasElt, elt) = remove();
+          if !hasElt then break;
+          arr[nTaken] = elt;
+          nTaken += 1;
+        }
+      }
+
+      dom = {0..#nTaken};
+      return arr;
+    }
+
+    // Approximate number of elements in this node's bag.
+    proc approxSize() : int {
+      var n = 0;
+      for segment in segments do
+        n += segment.nElems.read() : int;
+      return n;
+    }
+
+    /*
+      Give up to 'cap' elements of this node's bag to a work stealer on node
+      'locId', copying them to 'destPtr' there. We give a ratio of our elements
+      (see :const:`distributedBagWorkStealingRatio`), taking them from our
+      fullest segments first, with one bulk transfer per block. Returns the
+      number of elements given.
+    */
+    proc giveWork(destPtr, cap : int, locId : int) : int {
+      const total = approxSize();
+      if total < distributedBagWorkStealingMinElems then return 0;
+
+      const toGive = min(cap, total,
+                         max(distributedBagWorkStealingMinElems,
+                             (total * distributedBagWorkStealingRatio) : int));
+      var nGiven = 0;
+      var visited : [segments.domain] bool;
+      while nGiven < toGive {
+        var fullestIdx = -1;
+        var fullest = 0;
+        for (segment, idx) in zip(segments, segments.domain) {
+          const n = segment.nElems.read() : int;
+          if !visited[idx] && n > fullest {
+            fullestIdx = idx;
+            fullest = n;
+          }
+        }
+        if fullestIdx == -1 then break;
+        visited[fullestIdx] = true;
+
+        ref segment = segments[fullestIdx];
+        if segment.acquireIfNonEmpty(STATUS_REMOVE) {
+          const n = min(toGive - nGiven, segment.nElems.read() : int);
+          segment.transferElements(destPtr + nGiven, n, locId);
+          segment.releaseStatus();
+          nGiven += n;
+        }
+      }
+
+      return nGiven;
+    }
+
+    /*
+      Steal work from other nodes and spread it across our segments. Victims are
+      tried one at a time (see 'lastVictim'), and we stop at the first that gives
+      us any elements. We steal at most :const:`distributedBagWorkStealingMemCap`
+      megabytes of data. Returns whether any elements were found.
+    */
+    proc stealWork() : bool {
+      extern proc sizeof(type x): size_t;
+      const mb = distributedBagWorkStealingMemCap * 1024 * 1024;
+      const cap = max(1, (mb / sizeof(eltType)) : int);
+      const pid = parentHandle.pid;
+      const targetLocDom = parentHandle.targetLocDom;
+      const nLocs = targetLocDom.size;
+      const thiefId = here.id;
+      var buffer = c_malloc(eltType, cap);
+      var nStolen = 0;
+
+      const hint = lastVictim.read();
+      const offset = victimOffset.fetchAdd(1);
+      for k in -1 .. #nLocs {
+        // The last successful victim, then the others round-robin
+        var victimIdx : int;
+        if k == -1 {
+          if hint == -1 then continue;
+          victimIdx = hint;
+        } else {
+          victimIdx = targetLocDom.low + mod(offset + k, nLocs);
+          if victimIdx == hint then continue;
+        }
+
+        const victim = parentHandle.targetLocales[victimIdx];
+        if victim == here then continue;
+
+        on victim {
+          var targetBag = chpl_getPrivatizedCopy(DistributedBagImpl(eltType), pid).bag;
+          // Only proceed if the target is not load balancing themselves...
+          if !targetBag.loadBalanceInProgress.read() then
+            nStolen = targetBag.giveWork(buffer, cap, thiefId);
+        }
+
+        if nStolen > 0 {
+          lastVictim.write(victimIdx);
+          break;
+        }
+      }
+
+      if nStolen == 0 {
+        lastVictim.write(-1);
+      } else {
+        // Spread the stolen elements evenly across our segments.
+        const nSegments = here.maxTaskPar;
+        const perSegment = divceil(nStolen, nSegments);
+        forall segmentIdx in 0 .. #nSegments {
+          const lo = segmentIdx * perSegment;
+          const n = min(perSegment, nStolen - lo);
+          if n > 0 {
+            ref segment = segments[segmentIdx];
+            segment.acquire(STATUS_ADD);
+            segment.addElementsPtr(buffer + lo, n);
+            segment.releaseStatus();
+          }
+        }
+      }
+
+      c_free(buffer);
+      return nStolen > 0;
+    }
   }
 }
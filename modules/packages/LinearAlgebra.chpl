@@ -194,6 +194,20 @@ use LAPACK only lapack_memory_order, isLAPACKType;
 private param usingBLAS = BLAS.header != '';
 private param usingLAPACK = LAPACK.header != '';
 
+// Number of rows and columns in the tiles the native matrix
+// multiplications work on.  A tile of each of A, B and C fits in cache
+// together.
+private param _tileSize = 64;
+
+// Number of rows of the A tile the matrix-matrix kernel multiplies at
+// once, so that each element of the B tile it loads is used that many
+// times from registers.
+private param _kernelRows = 4;
+
+// Number of columns of A (and rows of B) in each panel that
+// _matmatMultDist() fetches.
+private param _panelSize = 4 * _tileSize;
+
 // TODO: compilerError if matrices are distributed
 
 //
@@ -463,6 +477,13 @@ proc _array.T where this.domain.rank == 1 { return transpose(this); }
       Since row vectors and columns vectors are indistinguishable, passing
       a vector to this function will return that vector unchanged
 
+   .. note::
+
+      Matrices distributed with ``Block`` or ``Cyclic`` are also supported.
+      The result is distributed the same way over the same locales, and
+      each locale fetches the part of ``A`` it needs with one bulk
+      transfer.
+
 */
 proc transpose(A: [?Dom] ?eltType) where isDenseMatrix(A) {
   if Dom.shape(1) == 1 then
@@ -479,6 +500,38 @@ proc transpose(A: [?Dom] ?eltType) where isDenseMatrix(A) {
   }
 }
 
+pragma "no doc"
+/* Transpose a Block- or Cyclic-distributed matrix */
+proc transpose(A: [?Dom] ?eltType) where isDistributedMatrix(A) {
+  param bs = _tileSize;
+  const Cdom = _distributedDomainLike(Dom, Dom.dim(2), Dom.dim(1));
+  var C: [Cdom] eltType;
+
+  coforall loc in C.targetLocales() do on loc {
+    const myC = C.localSubdomain();
+    if myC.size > 0 {
+      const (rows, cols) = (myC.dim(1), myC.dim(2));
+      // The elements of A that transpose onto this locale's part of C
+      const Al: [cols, rows] eltType = A[cols, rows];
+      var Cl: [myC] eltType;
+      // Work on tiles so that the reads of Al stay in cache
+      forall (ti, tj) in {0..#divceil(rows.size, bs),
+                          0..#divceil(cols.size, bs)} {
+        for i in ti*bs..#min(bs, rows.size - ti*bs) {
+          const ci = rows.orderToIndex(i);
+          for j in tj*bs..#min(bs, cols.size - tj*bs) {
+            const cj = cols.orderToIndex(j);
+            Cl[ci, cj] = Al[cj, ci];
+          }
+        }
+      }
+      C[myC] = Cl;
+    }
+  }
+
+  return C;
+}
+
 /* Transpose vector or matrix */
 proc _array.T where isDenseMatrix(this)
 {
@@ -546,8 +599,23 @@ proc _array.elementDiv(A: [?Adom]) where isDenseArr(A) && isDenseArr(this) {
       Dense matrix-matrix and matrix-vector multiplication will utilize the
       :mod:`BLAS` module for improved performance, if available. Compile with
       ``--set blasImpl=none`` to opt out of the :mod:`BLAS` implementation.
+      Otherwise, and for element types :mod:`BLAS` does not support, they
+      use a native implementation that works on cache-sized tiles of the
+      matrices in parallel.
+
+    .. note::
+
+      ``A`` and ``B`` may also be distributed with ``Block`` or ``Cyclic``.
+      A matrix-matrix product is then computed SUMMA-style: the result is
+      distributed like the distributed operand, and each locale computes
+      its part of it from panels of rows of ``A`` and columns of ``B`` that
+      it fetches with bulk transfers.  For a matrix-vector product, each
+      locale multiplies the block of the matrix it owns, and the per-locale
+      partial results are summed into a local vector.
 */
-proc dot(A: [?Adom] ?eltType, B: [?Bdom] eltType) where isDenseArr(A) && isDenseArr(B) {
+proc dot(A: [?Adom] ?eltType, B: [?Bdom] eltType)
+  where (isDenseArr(A) || isDistributedDenseArr(A)) &&
+        (isDenseArr(B) || isDistributedDenseArr(B)) {
   // vector-vector
   if Adom.rank == 1 && Bdom.rank == 1 then
     return inner(A, B);
@@ -588,15 +656,19 @@ proc dot(a, B: []) where isNumeric(a) {
 
 /* Explicit matrix-(matrix|vector) multiplication */
 private proc matMult(A: [?Adom] ?eltType, B: [?Bdom] eltType) {
+  param distributed = isDistributedDenseArr(A) || isDistributedDenseArr(B);
   // matrix-vector
   if Adom.rank == 2 && Bdom.rank == 1 then
-    return _matvecMult(A, B);
+    return if distributed then _matvecMultDist(A, B)
+           else _matvecMult(A, B);
   // vector-matrix
   else if Adom.rank == 1 && Bdom.rank == 2 then
-    return _matvecMult(B, A, trans=true);
+    return if distributed then _matvecMultDist(B, A, trans=true)
+           else _matvecMult(B, A, trans=true);
   // matrix-matrix
   else if Adom.rank == 2 && Bdom.rank == 2 then
-    return _matmatMult(A, B);
+    return if distributed then _matmatMultDist(A, B)
+           else _matmatMult(A, B);
   else
     compilerError("Rank sizes are not 1 or 2");
 }
@@ -682,17 +754,41 @@ proc _matvecMult(A: [?Adom] ?eltType, X: [?Xdom] eltType, trans=false)
 
   var Y: [Ydom] eltType;
 
-  // naive algorithm
   if !trans {
     if Adom.shape(2) != Xdom.shape(1) then
       halt("Mismatched shape in matrix-vector multiplication");
-    forall i in Ydom do
-      Y[i] = + reduce (A[i,..]*X[..]);
   } else {
     if Adom.shape(1) != Xdom.shape(1) then
       halt("Mismatched shape in matrix-vector multiplication");
-    forall i in Ydom do
-      Y[i] = + reduce (A[.., i]*X[..]);
+  }
+
+  // Copy X to a local, 0-based vector so the loops below index it directly
+  const Xl: [0..#Xdom.size] eltType = X;
+  const rows = Adom.dim(1), cols = Adom.dim(2);
+
+  if !trans {
+    // Each task sums along whole rows of A
+    forall (i, y) in zip(rows, Y) {
+      var sum: eltType;
+      for k in 0..#cols.size do
+        sum += A[i, cols.orderToIndex(k)] * Xl[k];
+      y = sum;
+    }
+  } else {
+    // Walking a column of A at a time would jump a row's length between
+    // elements, so instead each task sweeps the rows of a tile of columns.
+    param bs = _tileSize;
+    forall tj in 0..#divceil(cols.size, bs) {
+      const jlo = tj*bs, jn = min(bs, cols.size - jlo);
+      var Yp: [0..#bs] eltType;
+      for i in 0..#rows.size {
+        const ai = rows.orderToIndex(i), x = Xl[i];
+        for j in 0..#jn do
+          Yp[j] += A[ai, cols.orderToIndex(jlo+j)] * x;
+      }
+      for j in 0..#jn do
+        Y[Ydom.dim(1).orderToIndex(jlo+j)] = Yp[j];
+    }
   }
 
   return Y;
@@ -706,16 +802,218 @@ proc _matmatMult(A: [?Adom] ?eltType, B: [?Bdom] eltType)
 {
   if Adom.rank != 2 || Bdom.rank != 2 then
     compilerError("Rank sizes are not 2 and 2");
+  if Adom.shape(2) != Bdom.shape(1) then
+    halt("Mismatched shape in matrix-matrix multiplication");
 
   var C: [Adom.dim(1), Bdom.dim(2)] eltType;
+  _matmatMultBlocked(A, B, C);
+  return C;
+}
 
-  // naive algorithm
-  forall (i,j) in C.domain do
-    C[i,j] = + reduce (A[i,..]*B[..,j]);
+
+pragma "no doc"
+/*
+  Stores A * B into C, a tile of C at a time.  Tasks compute different
+  tiles of C.  For each tile, the tiles of A and B that contribute to it are
+  packed into contiguous local buffers, whatever the layout of A and B, and
+  multiplied by _matmatKernel() into a local C tile, which is copied to C
+  when done.
+*/
+private proc _matmatMultBlocked(A: [?Adom] ?eltType, B: [?Bdom] eltType,
+                                ref C: [?Cdom] eltType) {
+  param bs = _tileSize;
+  const m = Adom.dim(1).size, n = Adom.dim(2).size, p = Bdom.dim(2).size;
+  const (arows, acols) = (Adom.dim(1), Adom.dim(2)),
+        (brows, bcols) = (Bdom.dim(1), Bdom.dim(2)),
+        (crows, ccols) = (Cdom.dim(1), Cdom.dim(2));
+
+  forall (ti, tj) in {0..#divceil(m, bs), 0..#divceil(p, bs)} {
+    const ilo = ti*bs, in_ = min(bs, m - ilo),
+          jlo = tj*bs, jn = min(bs, p - jlo);
+    var Ap, Bp, Cp: [0..#bs*bs] eltType;
+
+    for klo in 0..#n by bs {
+      const kn = min(bs, n - klo);
+      for i in 0..#in_ {
+        const ai = arows.orderToIndex(ilo+i);
+        for k in 0..#kn do
+          Ap[i*kn+k] = A[ai, acols.orderToIndex(klo+k)];
+      }
+      for k in 0..#kn {
+        const bk = brows.orderToIndex(klo+k);
+        for j in 0..#jn do
+          Bp[k*bs+j] = B[bk, bcols.orderToIndex(jlo+j)];
+      }
+      _matmatKernel(c_ptrTo(Ap), c_ptrTo(Bp), c_ptrTo(Cp), in_, kn, jn);
+    }
+
+    for i in 0..#in_ {
+      const ci = crows.orderToIndex(ilo+i);
+      for j in 0..#jn do
+        C[ci, ccols.orderToIndex(jlo+j)] = Cp[i*bs+j];
+    }
+  }
+}
+
+pragma "no doc"
+/*
+  Adds the product of the ``m`` x ``n`` matrix at ``Ap`` (with rows of
+  length ``n``) and the ``n`` x ``p`` matrix at ``Bp`` to the ``m`` x ``p``
+  matrix at ``Cp``.  The rows of the latter two are _tileSize long.  The
+  innermost loops run along a row of B and C, and can be vectorized.
+*/
+private proc _matmatKernel(Ap: c_ptr(?eltType), Bp: c_ptr(eltType),
+                           Cp: c_ptr(eltType), m: int, n: int, p: int) {
+  param bs = _tileSize;
+  var i = 0;
+  while i + _kernelRows <= m {
+    const c0 = Cp + i*bs, c1 = c0 + bs, c2 = c1 + bs, c3 = c2 + bs;
+    const a0 = Ap + i*n, a1 = a0 + n, a2 = a1 + n, a3 = a2 + n;
+    for k in 0..#n {
+      const b = Bp + k*bs;
+      const a0k = a0[k], a1k = a1[k], a2k = a2[k], a3k = a3[k];
+      for j in 0..#p {
+        const bkj = b[j];
+        c0[j] += a0k * bkj;
+        c1[j] += a1k * bkj;
+        c2[j] += a2k * bkj;
+        c3[j] += a3k * bkj;
+      }
+    }
+    i += _kernelRows;
+  }
+  // leftover rows
+  while i < m {
+    const c = Cp + i*bs, a = Ap + i*n;
+    for k in 0..#n {
+      const b = Bp + k*bs, ak = a[k];
+      for j in 0..#p do
+        c[j] += ak * b[j];
+    }
+    i += 1;
+  }
+}
+
+
+pragma "no doc"
+/*
+  Returns the domain {rows, cols}, distributed the same way as the Block-
+  or Cyclic-distributed domain D and over the same locales.
+*/
+private proc _distributedDomainLike(D: domain, rows: range, cols: range) {
+  use BlockDist, CyclicDist;
+  const dist = D.dist._value;
+  if isSubtype(_to_borrowed(dist.type), Block) then
+    return {rows, cols} dmapped Block(boundingBox={rows, cols},
+                                      targetLocales=dist.targetLocales);
+  else
+    return {rows, cols} dmapped Cyclic(startIdx=(rows.low, cols.low),
+                                       targetLocales=dist.targetLocs);
+}
+
+pragma "no doc"
+/*
+  Matrix-matrix multiplication where A, B or both are distributed.  The
+  product is distributed like one of them, and each locale computes the
+  part of it that it owns.  Like SUMMA, it does so a panel of the inner
+  dimension at a time, fetching the panels of its rows of A and its
+  columns of B with a bulk transfer each, and multiplying them locally.
+*/
+private proc _matmatMultDist(A: [?Adom] ?eltType, B: [?Bdom] eltType) {
+  if Adom.shape(2) != Bdom.shape(1) then
+    halt("Mismatched shape in matrix-matrix multiplication");
+
+  const Cdom = _distributedDomainLike(if isDistributedDenseArr(A) then Adom
+                                      else Bdom,
+                                      Adom.dim(1), Bdom.dim(2));
+  var C: [Cdom] eltType;
+  const (acols, brows) = (Adom.dim(2), Bdom.dim(1));
+  const n = acols.size;
+
+  coforall loc in C.targetLocales() do on loc {
+    const myC = C.localSubdomain();
+    if myC.size > 0 {
+      const (rows, cols) = (myC.dim(1), myC.dim(2));
+      var Cl: [myC] eltType;
+      for klo in 0..#n by _panelSize {
+        const kn = min(_panelSize, n - klo);
+        const ak = acols.orderToIndex(klo).. by acols.stride #kn,
+              bk = brows.orderToIndex(klo).. by brows.stride #kn;
+        var Ap: [rows, ak] eltType = A[rows, ak];
+        var Bp: [bk, cols] eltType = B[bk, cols];
+        Cl += _matmatMult(Ap, Bp);
+      }
+      C[myC] = Cl;
+    }
+  }
 
   return C;
 }
 
+pragma "no doc"
+/*
+  Returns the indices of 'target' at the same positions as the indices of
+  'sub' are in 'whole'.
+*/
+private proc _alignedRange(sub: range(?), whole: range(?), target: range(?)) {
+  const step = (sub.stride / whole.stride) * target.stride;
+  const first = if sub.size == 0 then target.low
+                else target.orderToIndex(whole.indexOrder(sub.first));
+  return first.. by step #sub.size;
+}
+
+pragma "no doc"
+/*
+  Matrix-vector multiplication where A, X or both are distributed.  Each
+  locale multiplies the block of A it owns by the matching part of X,
+  fetched with one bulk transfer, and stores its partial result into the
+  calling locale's copy with another.  The partial results are then
+  summed into Y, which is local.
+*/
+private proc _matvecMultDist(A: [?Adom] ?eltType, X: [?Xdom] eltType,
+                             trans=false) {
+  if !trans {
+    if Adom.shape(2) != Xdom.shape(1) then
+      halt("Mismatched shape in matrix-vector multiplication");
+  } else {
+    if Adom.shape(1) != Xdom.shape(1) then
+      halt("Mismatched shape in matrix-vector multiplication");
+  }
+
+  const Ydom = if trans then {Adom.dim(2)} else {Adom.dim(1)};
+  // The dimensions of A that X and Y run along
+  const (xdim, ydim) = if trans then (Adom.dim(1), Adom.dim(2))
+                       else (Adom.dim(2), Adom.dim(1));
+  const targetLocs = if isDistributedDenseArr(A) then A.targetLocales()
+                     else X.targetLocales();
+  var partials: [0..#targetLocs.size] [Ydom] eltType;
+
+  coforall (loc, lid) in zip(targetLocs, 0..) do on loc {
+    // The block of A this locale works on: the one it owns, or if A is
+    // local, the rows or columns lined up with the part of X it owns.
+    const myA = if isDistributedDenseArr(A) then A.localSubdomain()
+                else if trans then
+                  {_alignedRange(X.localSubdomain().dim(1), Xdom.dim(1),
+                                 xdim), ydim}
+                else
+                  {ydim, _alignedRange(X.localSubdomain().dim(1),
+                                       Xdom.dim(1), xdim)};
+    if myA.size > 0 {
+      const (xr, yr) = if trans then (myA.dim(1), myA.dim(2))
+                       else (myA.dim(2), myA.dim(1));
+      var Al: [myA] eltType = A[myA];
+      var Xl: [xr] eltType = X[_alignedRange(xr, xdim, Xdom.dim(1))];
+      const Yl = _matvecMult(Al, Xl, trans);
+      partials[lid][_alignedRange(yr, ydim, Ydom.dim(1))] = Yl;
+    }
+  }
+
+  var Y: [Ydom] eltType;
+  forall (y, i) in zip(Y, Ydom) do
+    for p in partials.domain do
+      y += partials[p][i];
+  return Y;
+}
 
 /*
   Return the matrix ``A`` to the ``bth`` power, where ``b`` is a positive
@@ -725,7 +1023,8 @@ proc _matmatMult(A: [?Adom] ?eltType, B: [?Bdom] eltType)
 
     ``matPow`` will utilize the :mod:`BLAS` module for improved performance, if
     available. Compile with ``--set blasImpl=none`` to opt out of the
-    :mod:`BLAS` implementation.
+    :mod:`BLAS` implementation, in which case it uses the native tiled
+    multiplication described under :proc:`dot`.
 */
 proc matPow(A: [], b) where isNumeric(b) {
   // TODO -- flatten recursion into while-loop
@@ -1384,6 +1683,34 @@ proc isDenseMatrix(A: []) param : bool {
   return A.rank == 2 && isDenseArr(A);
 }
 
+pragma "no doc"
+/* Returns ``true`` if the array is dense and distributed with ``Block`` or
+   ``Cyclic``. */
+proc isDistributedDenseArr(A: []) param : bool {
+  return isDistributedDenseDom(A.domain);
+}
+
+pragma "no doc"
+/* Returns ``true`` if the domain is dense and distributed with ``Block`` or
+   ``Cyclic``. */
+proc isDistributedDenseDom(D: domain) param : bool {
+  use BlockDist, CyclicDist;
+  if !isRectangularDom(D) then
+    return false;
+  else if D.stridable then
+    return false;
+  else
+    return isSubtype(_to_borrowed(D.dist._value.type), Block) ||
+           isSubtype(_to_borrowed(D.dist._value.type), Cyclic);
+}
+
+pragma "no doc"
+/* Returns ``true`` if the array is a dense, 2-dimensional array distributed
+   with ``Block`` or ``Cyclic``. */
+proc isDistributedMatrix(A: []) param : bool {
+  return A.rank == 2 && isDistributedDenseArr(A);
+}
+
 // Work-around for #8543
 pragma "no doc"
 proc type _array.rank param {
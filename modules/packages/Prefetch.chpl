@@ -28,8 +28,29 @@ module Prefetch {
   inline proc prefetch(addr:c_void_ptr) {
     Prefetch_internal.chpl_prefetch(addr);
   }
+
+  /*
+    Prefetch `count` values into the remote data cache, starting with `x`
+    and continuing with the values `stride` elements apart from it in
+    memory, as when reading a column of a row-major array.  This only has
+    an effect for remote data in programs compiled with ``--cache-remote``.
+   */
+  proc prefetchStrided(const ref x, stride: int, count: int) {
+    const eltSize = c_sizeof(x.type);
+    Prefetch_internal.chpl_cache_prefetch_strided(
+                        __primitive("_wide_get_node", x),
+                        __primitive("_wide_get_addr", x),
+                        eltSize, stride * eltSize:int, count:size_t);
+  }
 }
 
 module Prefetch_internal {
   extern proc chpl_prefetch(addr: c_void_ptr);
+
+  pragma "insert line file info"
+  extern proc chpl_cache_prefetch_strided(node: chpl_nodeID_t,
+                                          raddr: c_void_ptr,
+                                          size: size_t,
+                                          stride: c_ptrdiff,
+                                          count: size_t);
 }
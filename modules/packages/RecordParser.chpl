@@ -200,8 +200,23 @@ class RecordReader {
     return rec;
   }
 
-  /* Yield the records read */
-  iter stream() {
+  /* Yield the records read.
+
+     In a ``forall`` loop, the rest of the file, from the channel's current
+     offset, is split into regions by :iter:`IO.file.recordRegions`, and
+     each region is matched by a different task with its own channel.
+     For that to work, every record must begin at the start of a line; a
+     record belongs to the region that holds the start of its first field.
+     The parallel version doesn't yield the records in file order, and it
+     doesn't advance the channel used to create this RecordReader.
+
+     :arg distributed: in a ``forall`` loop, whether to read the file from
+                       all locales; see :iter:`IO.file.records`
+     :arg chunkSize: in a ``forall`` loop, the approximate number of bytes
+                     each task reads at a time, or 0 to pick a size
+                     automatically
+   */
+  iter stream(distributed: bool = false, chunkSize: int = 0) {
     try! { // TODO -- should be throws, once that is working for iterators
       do {
         var (rec, once) = _get_internal();
@@ -211,6 +226,33 @@ class RecordReader {
     }
   }
 
+  pragma "no doc"
+  iter stream(param tag: iterKind, distributed: bool = false,
+              chunkSize: int = 0) where tag == iterKind.standalone {
+    const f = myReader._getFile();
+    forall (start, end) in f.recordRegions(0x0a, distributed, chunkSize,
+                                           myReader.offset()) {
+      try! { // TODO -- should be throws, once that is working for iterators
+        const lf = f._localCopy();
+        var r = lf.reader(locking=false, start=start);
+        var done = false;
+        while !done {
+          var rec: t;
+          done = true;
+          for m in r.matches(matchRegexp, num_fields, 1) {
+            // Only the records whose first field starts in this region
+            if num_fields > 0 && m(2).offset < end {
+              _fill(rec, r, m);
+              done = false;
+            }
+          }
+          if !done then yield rec;
+        }
+        r.close();
+      }
+    }
+  }
+
   /*
 
      An internal function that we use with all our user visible code.  When
@@ -231,23 +273,29 @@ class RecordReader {
         // Then break and dont return any record
         return (rec, false);
       }
-      for param n in 1..num_fields {
-        var tmp = getField(rec, n);
-        var s: string;
-        ref dst = getFieldRef(rec, n);
-        myReader.extractMatch(m(n + 1), s);
-        if s == "" then
-          dst = tmp;
-        else if tmp.type == string then
-          dst = s;
-        else
-          dst = s:tmp.type;
-        once = true;
-      }
+      _fill(rec, myReader, m);
+      once = num_fields > 0;
     }
     return (rec, once);
   }
 
+  // Set the fields of rec from the captures in the match m read from ch
+  pragma "no doc"
+  proc _fill(ref rec: t, ch, m) throws {
+    for param n in 1..num_fields {
+      var tmp = getField(rec, n);
+      var s: string;
+      ref dst = getFieldRef(rec, n);
+      ch.extractMatch(m(n + 1), s);
+      if s == "" then
+        dst = tmp;
+      else if tmp.type == string then
+        dst = s;
+      else
+        dst = s:tmp.type;
+    }
+  }
+
 }
 
 }
@@ -30,8 +30,9 @@ Comparators
 
 Comparators allow sorting data by a mechanism other than the
 default comparison operations between array elements. To use a comparator,
-define a record with either a ``key(a)`` or ``compare(a, b)`` method, and pass
-an instance of that record to the sort function (examples shown below).
+define a record with a ``key(a)``, ``compare(a, b)`` or ``keyPart(a, i)``
+method, and pass an instance of that record to the sort function (examples
+shown below).
 
 If both methods are implemented on the record passed as the comparator, the
 ``key(a)`` method will take priority over the ``compare(a, b)`` method.
@@ -130,6 +131,51 @@ implemented with a compare method:
   // This will output: -1, 2, 3, -4
   writeln(Array);
 
+.. _keypart-comparator:
+
+Key Part Comparator
+~~~~~~~~~~~~~~~~~~~
+
+The ``keyPart(a, i)`` method allows :proc:`sort` and :proc:`radixSort` to
+sort elements by examining their keys piece by piece rather than by comparing
+pairs of elements. It accepts 2 arguments: an element from the array being
+sorted and the 1-based index ``i`` of the key part requested. It returns a
+tuple ``(section, part)`` where ``section`` is an ``int(8)`` and ``part`` is
+an integral value. All calls must return the same tuple type.
+
+  ============== ==================================================
+  ``section``    Meaning
+  ============== ==================================================
+  ``0``          ``part`` holds part ``i`` of the key
+  ``< 0``        the key has fewer than ``i`` parts and sorts before
+                 any key that has a part ``i``
+  ``> 0``        the key has fewer than ``i`` parts and sorts after
+                 any key that has a part ``i``
+  ============== ==================================================
+
+Keys are ordered by comparing their parts in order, starting from part 1.
+As an example, a record storing a pair of integers can be sorted by its
+first and then its second field like so:
+
+.. code-block:: chapel
+
+  record Pair { var first, second: int; }
+
+  record PairComparator { }
+
+  proc PairComparator.keyPart(a: Pair, i: int) {
+    if i == 1 then return (0:int(8), a.first);
+    else if i == 2 then return (0:int(8), a.second);
+    else return (-1:int(8), 0);
+  }
+
+If the comparator also defines ``compare(a, b)``, it is used when comparison
+sorting is required and must order elements consistently with ``keyPart``.
+
+When no ``keyPart`` method is defined, :proc:`sort` derives the key parts
+itself for elements (or ``key(a)`` results) that are integral, real,
+``string``, or tuples of integral and real values.
+
 .. _reverse-comparator:
 
 Reverse Comparator
@@ -226,9 +272,32 @@ inline proc chpl_compare(a, b, comparator:?rec=defaultComparator) {
   // Use comparator.compare(a, b) if is defined by user
   } else if canResolveMethod(comparator, "compare", a, b) {
     return comparator.compare(a ,b);
+  // Compare the key parts from comparator.keyPart(a, i) if is defined by user
+  } else if canResolveMethod(comparator, "keyPart", a, 1) {
+    return chpl_compareByParts(a, b, comparator);
   } else {
-    compilerError("The comparator record requires a 'key(a)' or 'compare(a, b)' method");
+    compilerError("The comparator record requires a 'key(a)', 'compare(a, b)' or 'keyPart(a, i)' method");
+  }
+}
+
+
+pragma "no doc"
+/*
+   Compare a and b by the parts returned from comparator.keyPart, stopping
+   at the first part that differs or at the first key that runs out of parts.
+*/
+proc chpl_compareByParts(a, b, comparator:?rec) {
+  var i = 1;
+  while true {
+    const (sectionA, partA) = comparator.keyPart(a, i);
+    const (sectionB, partB) = comparator.keyPart(b, i);
+    if sectionA != 0 || sectionB != 0 then
+      return sectionA:int - sectionB:int;
+    if partA < partB then return -1;
+    if partB < partA then return 1;
+    i += 1;
   }
+  return 0;
 }
 
 
@@ -264,9 +333,19 @@ proc chpl_check_comparator(comparator, type eltType) {
     if !(isNumericType(comparetype)) then
       compilerError("The compare method must return a numeric type");
   }
+  else if canResolveMethod(comparator, "keyPart", data, 1) {
+    // Check return type of keyPart
+    type parttype = comparator.keyPart(data, 1).type;
+    if !isTupleType(parttype) then
+      compilerError("The keyPart method must return a tuple of (int(8), integral)");
+    else if parttype.size != 2 then
+      compilerError("The keyPart method must return a tuple of (int(8), integral)");
+    else if parttype(1) != int(8) || !isIntegralType(parttype(2)) then
+      compilerError("The keyPart method must return a tuple of (int(8), integral)");
+  }
   else {
     // If we make it this far, the passed comparator was defined incorrectly
-    compilerError("The comparator record requires a 'key(a)' or 'compare(a, b)' method");
+    compilerError("The comparator record requires a 'key(a)', 'compare(a, b)' or 'keyPart(a, i)' method");
   }
 }
 
@@ -281,9 +360,19 @@ proc chpl_check_comparator(comparator, type eltType) {
    :arg comparator: :ref:`Comparator <comparators>` record that defines how the
       data is sorted.
 
+   Integral, real, ``string`` and tuple-of-numeric elements, as well as
+   comparators that define ``key(a)`` returning such a type or that define
+   ``keyPart(a, i)``, are sorted with the parallel :proc:`radixSort`.
+   Other arrays are sorted with :proc:`quickSort`.
+
  */
 proc sort(Data: [?Dom] ?eltType, comparator:?rec=defaultComparator) {
-  quickSort(Data, comparator=comparator);
+  chpl_check_comparator(comparator, eltType);
+
+  if chpl_radixSortOk(eltType, comparator) then
+    radixSort(Data, comparator=comparator);
+  else
+    quickSort(Data, comparator=comparator);
 }
 
 
@@ -768,6 +857,404 @@ proc quickSort(Data: [?Dom] ?eltType, minlen=16, comparator:?rec=defaultComparat
 }
 
 
+/*
+   Sort the 1D array `Data` in-place using a parallel radix sort algorithm.
+
+   The elements are distributed into buckets by their most significant
+   digit first, with large buckets counted, distributed and recursively
+   sorted in parallel. Small buckets are finished serially, by a
+   least-significant-digit radix sort when every key has the same number of
+   digits and by a comparison sort otherwise.
+
+   The comparator must define ``keyPart(a, i)``, or the elements (or the
+   results of ``key(a)``) must be integral, real, ``string``, or tuples of
+   integral and real values. See :ref:`keypart-comparator`.
+
+   :arg Data: The array to be sorted
+   :type Data: [] `eltType`
+   :arg comparator: :ref:`Comparator <comparators>` record that defines how the
+      data is sorted.
+
+ */
+proc radixSort(Data: [?Dom] ?eltType, comparator:?rec=defaultComparator) {
+  chpl_check_comparator(comparator, eltType);
+  if !chpl_radixSortOk(eltType, comparator) then
+    compilerError("radixSort() requires a 'keyPart(a, i)' comparator or integral, real, string or tuple keys");
+
+  const n = Dom.size;
+  if n <= 1 then return;
+
+  const low = Dom.low,
+        stride = if Dom.stridable then abs(Dom.stride) else 1;
+  param fixedDigits = chpl_radixFixedDigits(eltType, comparator);
+
+  // Scratch space each pass distributes into, indexed by position in Data
+  var Temp: [0..#n] eltType;
+
+  _MSBRadixSort(Data, Temp, low, stride, 0, n-1, 0, comparator, fixedDigits);
+}
+
+
+pragma "no doc"
+/* Error message for multi-dimension arrays */
+proc radixSort(Data: [?Dom] ?eltType, comparator:?rec=defaultComparator)
+  where Dom.rank != 1 {
+    compilerError("radixSort() requires 1-D array");
+}
+
+
+/* Radix sort helpers */
+
+// Each pass sorts on one byte of the key. Bin 0 holds keys that ran out of
+// parts and sort before the rest, bins 1..radixBuckets hold the digit
+// values, and the last bin holds keys that ran out of parts and sort after.
+private param radixBits = 8,
+              radixBuckets = 1 << radixBits,
+              radixBins = radixBuckets + 2;
+
+// Ranges at most this long are sorted serially
+private param radixSerialCutoff = 1 << 14;
+
+// Ranges at most this long are sorted with an insertion sort
+private param radixInsertionCutoff = 16;
+
+// Minimum number of elements for each task in a parallel pass
+private param radixMinPerTask = 1 << 14;
+
+
+pragma "no doc"
+/*
+   Check at compile time whether elements of type eltType can be radix
+   sorted with comparator.
+*/
+proc chpl_radixSortOk(type eltType, comparator) param {
+  use Reflection;
+  const data: eltType;
+
+  if canResolveMethod(comparator, "keyPart", data, 1) then
+    return true;
+  else if canResolveMethod(comparator, "key", data) then
+    return chpl_radixKeyTypeOk(comparator.key(data).type);
+  else if comparator.type == DefaultComparator then
+    return chpl_radixKeyTypeOk(eltType);
+  else
+    return false;
+}
+
+pragma "no doc"
+proc chpl_radixSortOk(type eltType, comparator: ReverseComparator(?)) param {
+  return chpl_radixSortOk(eltType, comparator.comparator);
+}
+
+pragma "no doc"
+/* Key types for which chpl_defaultKeyPart is defined */
+proc chpl_radixKeyTypeOk(type t) param {
+  if isIntegralType(t) || isRealType(t) || t == string then
+    return true;
+  else if isTupleType(t) {
+    for param i in 1..t.size do
+      if !(isIntegralType(t(i)) || isRealType(t(i))) then
+        return false;
+    return true;
+  } else {
+    return false;
+  }
+}
+
+pragma "no doc"
+/*
+   Number of digits in every key, or 0 if keys can have different numbers
+   of digits.
+*/
+proc chpl_radixFixedDigits(type eltType, comparator) param {
+  use Reflection;
+  const data: eltType;
+
+  if canResolveMethod(comparator, "keyPart", data, 1) then
+    return 0;
+  else if canResolveMethod(comparator, "key", data) then
+    return chpl_radixKeyTypeDigits(comparator.key(data).type);
+  else
+    return chpl_radixKeyTypeDigits(eltType);
+}
+
+pragma "no doc"
+proc chpl_radixFixedDigits(type eltType, comparator: ReverseComparator(?)) param {
+  return chpl_radixFixedDigits(eltType, comparator.comparator);
+}
+
+pragma "no doc"
+proc chpl_radixKeyTypeDigits(type t) param {
+  if isIntegralType(t) || isRealType(t) then
+    return numBits(t) / radixBits;
+  else if isTupleType(t) then
+    return t.size * (64 / radixBits);
+  else
+    return 0;
+}
+
+pragma "no doc"
+/*
+   Return the (section, part) tuple for part i of a's key, using
+   comparator.keyPart if it is defined and otherwise the default key parts
+   of comparator.key(a) or of a itself.
+*/
+inline proc chpl_radixKeyPart(a, i:int, comparator:?rec) {
+  use Reflection;
+
+  if canResolveMethod(comparator, "keyPart", a, i) then
+    return comparator.keyPart(a, i);
+  else if canResolveMethod(comparator, "key", a) then
+    return chpl_defaultKeyPart(comparator.key(a), i);
+  else
+    return chpl_defaultKeyPart(a, i);
+}
+
+pragma "no doc"
+/* Reversing a key flips the ordering of both its sections and its parts */
+inline proc chpl_radixKeyPart(a, i:int, comparator: ReverseComparator(?)) {
+  const (section, part) = chpl_radixKeyPart(a, i, comparator.comparator);
+  return (-section, ~part);
+}
+
+pragma "no doc"
+/* Integral and real keys have a single part */
+inline proc chpl_defaultKeyPart(a, i:int) where isIntegral(a) || isReal(a) {
+  const bits = radixOrderedBits(a);
+  if i == 1 then
+    return (0:int(8), bits);
+  else
+    return (-1:int(8), 0:bits.type);
+}
+
+pragma "no doc"
+/* String keys have one part per byte */
+inline proc chpl_defaultKeyPart(a: string, i:int) {
+  if i > a.length then
+    return (-1:int(8), 0:uint(8));
+  else if a.locale_id == chpl_nodeID then
+    return (0:int(8), a.buff[i-1]);
+  else
+    return (0:int(8), a.localize().buff[i-1]);
+}
+
+pragma "no doc"
+/* Tuple keys have one part per component */
+inline proc chpl_defaultKeyPart(a, i:int) where isTuple(a) {
+  for param j in 1..a.size do
+    if i == j then
+      return (0:int(8), radixOrderedBits(a(j)):uint(64));
+  return (-1:int(8), 0:uint(64));
+}
+
+/*
+   Map x to an unsigned integer of the same width such that comparing the
+   results as unsigned integers orders them the same way as x.
+*/
+private inline proc radixOrderedBits(x: integral) {
+  type t = x.type;
+  if isUintType(t) then
+    return x;
+  else
+    return x:uint(numBits(t)) ^ (1:uint(numBits(t)) << (numBits(t) - 1));
+}
+
+private inline proc radixOrderedBits(x: real(?w)) {
+  var v = x;
+  const u = (c_ptrTo(v):c_ptr(uint(w)))[0];
+  param signBit = 1:uint(w) << (w - 1);
+  // Negative values order in reverse of their magnitude bits
+  if (u & signBit) != 0 then
+    return ~u;
+  else
+    return u | signBit;
+}
+
+/* Return the bin for digit d (counting from 0 at the most significant) */
+private inline proc radixBin(a, d:int, comparator) {
+  type partType = chpl_radixKeyPart(a, 1, comparator)(2).type;
+  param bytesPerPart = numBits(partType) / radixBits;
+
+  const (section, part) = chpl_radixKeyPart(a, 1 + d / bytesPerPart, comparator);
+  if section < 0 then
+    return 0;
+  else if section > 0 then
+    return radixBins - 1;
+
+  const shift = (bytesPerPart - 1 - d % bytesPerPart) * radixBits;
+  return 1 + ((radixOrderedBits(part) >> shift) & (radixBuckets - 1)):int;
+}
+
+/* Index in Data of position k */
+private inline proc radixIdx(low, stride, k:int) {
+  return low + (k * stride):low.type;
+}
+
+/*
+   Sort positions start..end of Data, whose keys are known to agree on the
+   digits before digit d.
+*/
+private proc _MSBRadixSort(Data: [], Temp: [], low, stride,
+                           start:int, end:int, in d:int, comparator,
+                           param fixedDigits:int) {
+  while true {
+    const n = end - start + 1;
+
+    if n <= 1 then
+      return;
+
+    if fixedDigits > 0 && d >= fixedDigits then
+      return;
+
+    if n <= radixInsertionCutoff {
+      _RadixInsertionSort(Data, low, stride, start, end, comparator);
+      return;
+    }
+
+    if fixedDigits > 0 && n <= radixSerialCutoff {
+      _LSBRadixSort(Data, Temp, low, stride, start, end, d, comparator,
+                    fixedDigits);
+      return;
+    }
+
+    const maxTasks = if dataParTasksPerLocale == 0 then here.maxTaskPar
+                     else dataParTasksPerLocale;
+    const nTasks = max(1, min(maxTasks, n / radixMinPerTask));
+
+    // Count the digits in each task's chunk of the range
+    var counts: [0..#nTasks, 0..#radixBins] int;
+    serial nTasks == 1 do coforall tid in 0..#nTasks with (ref counts) {
+      var myCounts: [0..#radixBins] int;
+      for k in radixChunk(start, n, nTasks, tid) do
+        myCounts[radixBin(Data[radixIdx(low, stride, k)], d, comparator)] += 1;
+      for b in 0..#radixBins do
+        counts[tid, b] = myCounts[b];
+    }
+
+    // Compute where each bin starts and where each task writes within it
+    var binStart: [0..radixBins] int;
+    var offsets: [0..#nTasks, 0..#radixBins] int;
+    var total = start;
+    for b in 0..#radixBins {
+      binStart[b] = total;
+      for tid in 0..#nTasks {
+        offsets[tid, b] = total;
+        total += counts[tid, b];
+      }
+    }
+    binStart[radixBins] = total;
+
+    // If every key has the same digit there's nothing to move: keys that
+    // have all run out of parts are equal, and others continue to the next
+    // digit.
+    var sameBin = -1;
+    for b in 0..#radixBins do
+      if binStart[b+1] - binStart[b] == n then
+        sameBin = b;
+    if sameBin == 0 || sameBin == radixBins - 1 then
+      return;
+    if sameBin != -1 {
+      d += 1;
+      continue;
+    }
+
+    // Distribute the range into Temp in bin order, then copy it back
+    serial nTasks == 1 do coforall tid in 0..#nTasks with (ref Temp) {
+      var myOffsets: [0..#radixBins] int;
+      for b in 0..#radixBins do
+        myOffsets[b] = offsets[tid, b];
+      for k in radixChunk(start, n, nTasks, tid) {
+        ref elt = Data[radixIdx(low, stride, k)];
+        const b = radixBin(elt, d, comparator);
+        Temp[myOffsets[b]] = elt;
+        myOffsets[b] += 1;
+      }
+    }
+    serial nTasks == 1 do forall k in start..end with (ref Data) do
+      Data[radixIdx(low, stride, k)] = Temp[k];
+
+    // Sort each bin on the next digit. Bins of keys that ran out of parts
+    // contain equal keys and are already sorted.
+    serial nTasks == 1 do forall b in 1..radixBuckets with (ref Data, ref Temp) do
+      _MSBRadixSort(Data, Temp, low, stride, binStart[b], binStart[b+1]-1,
+                    d + 1, comparator, fixedDigits);
+    return;
+  }
+}
+
+/*
+   Sort positions start..end of Data on digits d..fixedDigits-1 with a
+   serial least-significant-digit radix sort.
+*/
+private proc _LSBRadixSort(Data: [], Temp: [], low, stride,
+                           start:int, end:int, d:int, comparator,
+                           param fixedDigits:int) {
+  const n = end - start + 1;
+  var inTemp = false;
+
+  for digit in d..fixedDigits-1 by -1 {
+    var counts: [0..#radixBins] int;
+    if inTemp then
+      for k in start..end do
+        counts[radixBin(Temp[k], digit, comparator)] += 1;
+    else
+      for k in start..end do
+        counts[radixBin(Data[radixIdx(low, stride, k)], digit, comparator)] += 1;
+
+    // Skip digits that are the same for every key
+    if max reduce counts == n then
+      continue;
+
+    var offsets: [0..#radixBins] int;
+    var total = start;
+    for b in 0..#radixBins {
+      offsets[b] = total;
+      total += counts[b];
+    }
+
+    if inTemp {
+      for k in start..end {
+        const b = radixBin(Temp[k], digit, comparator);
+        Data[radixIdx(low, stride, offsets[b])] = Temp[k];
+        offsets[b] += 1;
+      }
+    } else {
+      for k in start..end {
+        ref elt = Data[radixIdx(low, stride, k)];
+        const b = radixBin(elt, digit, comparator);
+        Temp[offsets[b]] = elt;
+        offsets[b] += 1;
+      }
+    }
+    inTemp = !inTemp;
+  }
+
+  if inTemp then
+    for k in start..end do
+      Data[radixIdx(low, stride, k)] = Temp[k];
+}
+
+/* Sort positions start..end of Data with an insertion sort */
+private proc _RadixInsertionSort(Data: [], low, stride, start:int, end:int,
+                                 comparator) {
+  for i in start+1..end {
+    const val = Data[radixIdx(low, stride, i)];
+    var j = i - 1;
+    while j >= start &&
+          chpl_compare(val, Data[radixIdx(low, stride, j)], comparator) < 0 {
+      Data[radixIdx(low, stride, j+1)] = Data[radixIdx(low, stride, j)];
+      j -= 1;
+    }
+    Data[radixIdx(low, stride, j+1)] = val;
+  }
+}
+
+/* Positions in task tid's chunk of the n positions starting at start */
+private inline proc radixChunk(start:int, n:int, nTasks:int, tid:int) {
+  return start + n*tid/nTasks..start + n*(tid+1)/nTasks - 1;
+}
+
+
 /*
    Sort the 1D array `Data` in-place using a sequential selection sort
    algorithm.
@@ -892,8 +1379,12 @@ record ReverseComparator {
     // Compare defined
     } else if canResolveMethod(this.comparator, "compare", a, b) && canResolveMethod(this.comparator, "compare", a, b) {
       return this.comparator.compare(b, a);
+
+    // KeyPart defined
+    } else if canResolveMethod(this.comparator, "keyPart", a, 1) {
+      return chpl_compareByParts(b, a, this.comparator);
     } else {
-      compilerError("The comparator record requires a 'key(a)' or 'compare(a, b)' method");
+      compilerError("The comparator record requires a 'key(a)', 'compare(a, b)' or 'keyPart(a, i)' method");
     }
   }
 }
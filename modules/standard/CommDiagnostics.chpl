@@ -137,6 +137,26 @@
   was executed on locale 0, and a remote get and a remote put were
   executed on locale 1.
 
+  **Counting Communication by Source Location**
+
+  The aggregate counts say how much communication a program does, but
+  not which parts of it are responsible.  Counting can also attribute
+  each GET, PUT, and remote execution to the source line that initiated
+  it, along with the number of bytes it moved::
+
+    startCommDiagnosticsBySource();
+    // between start/stop calls, count comm ops by where they came from
+    stopCommDiagnosticsBySource();
+    // print the 10 source locations that did the most communication
+    printCommDiagnosticsBySource(10);
+
+  This turns on ordinary counting as well, so :proc:`getCommDiagnostics`
+  still works as usual.  The per-location counts are kept in a table of
+  fixed size on each thread; if a program initiates communication from
+  more distinct places than fit, the rest are reported together with a
+  line number of -1.  :proc:`resetCommDiagnostics` clears these counts
+  too.
+
   **Studying Communication During Module Initialization**
 
   It is hard for a programmer to determine exactly what happens during
@@ -164,6 +184,23 @@
   done by a single module during its initialization and teardown it is
   often necessary to run a small test program twice, once with that
   module present and once without it.
+
+  **Remote Data Cache Statistics**
+
+  When the remote data cache is enabled (``--cache-remote``), each
+  locale counts how often GETs hit in its cache, how often readahead and
+  prefetched data is used, and how much data is evicted or written back.
+  These are retrieved much like communication counts::
+
+    resetCacheStats();
+    // ... code that uses the cache ...
+    writeln(getCacheStats());
+
+  Setting the environment variable ``CHPL_RT_CACHE_ADAPTIVE`` lets each
+  cache grow or shrink and adjust how far it reads ahead according to
+  how well it is doing.  The statistics also report the sizes that the
+  caches have settled on.  With comm layers that do not have a cache,
+  all of the statistics are zero.
  */
 module CommDiagnostics
 {
@@ -348,6 +385,312 @@ module CommDiagnostics
   }
 
 
+  /*
+    Communication initiated from one source location.
+   */
+  record commDiagsSource {
+    /*
+      the source file
+     */
+    var file: string;
+    /*
+      the line in that file, or -1 for communication that could not be
+      attributed to a location
+     */
+    var line: int;
+    /*
+      the kind of operation, named as in :type:`chpl_commDiagnostics`
+     */
+    var kind: string;
+    /*
+      how many of these operations were initiated there
+     */
+    var count: uint(64);
+    /*
+      how many bytes those operations moved (for remote executions,
+      the size of the argument bundle)
+     */
+    var bytes: uint(64);
+  }
+
+  pragma "no doc"
+  extern record chpl_commDiagsSource {
+    var lineno: int(32);
+    var filename: int(32);
+    var kind: int(32);
+    var count: uint(64);
+    var bytes: uint(64);
+  }
+
+  private extern proc chpl_setCommDiagnosticsBySourceHere(flag: bool);
+
+  private extern proc chpl_getCommDiagnosticsBySourceHere(
+                        ref entries: c_ptr(chpl_commDiagsSource)): size_t;
+
+  private extern proc chpl_lookupFilename(idx: int(32)): c_string;
+
+  private proc commDiagsKindName(kind: int) {
+    use Reflection;
+
+    for param i in 1..numFields(chpl_commDiagnostics) do
+      if kind + 1 == i then
+        return getFieldName(chpl_commDiagnostics, i): string;
+    return "unknown";
+  }
+
+  // orders by source location, for merging
+  pragma "no doc"
+  record commDiagsSourceLocComparator {
+    proc compare(a: commDiagsSource, b: commDiagsSource) {
+      if a.file != b.file then return if a.file < b.file then -1 else 1;
+      if a.line != b.line then return (a.line - b.line): int;
+      if a.kind != b.kind then return if a.kind < b.kind then -1 else 1;
+      return 0;
+    }
+  }
+
+  // orders by count, largest first
+  pragma "no doc"
+  record commDiagsSourceCountComparator {
+    proc key(a: commDiagsSource) { return -(a.count: int); }
+  }
+
+  /*
+    Start counting communication operations across the whole program,
+    and attribute them to the source locations that initiated them.
+   */
+  proc startCommDiagnosticsBySource() {
+    for loc in Locales do on loc do
+      chpl_setCommDiagnosticsBySourceHere(true);
+    startCommDiagnostics();
+  }
+
+  /*
+    Stop counting communication operations across the whole program,
+    including by source location.
+   */
+  proc stopCommDiagnosticsBySource() {
+    stopCommDiagnostics();
+    for loc in Locales do on loc do
+      chpl_setCommDiagnosticsBySourceHere(false);
+  }
+
+  /*
+    Start counting communication operations initiated on this locale,
+    and attribute them to the source locations that initiated them.
+   */
+  proc startCommDiagnosticsBySourceHere() {
+    chpl_setCommDiagnosticsBySourceHere(true);
+    startCommDiagnosticsHere();
+  }
+
+  /*
+    Stop counting communication operations initiated on this locale,
+    including by source location.
+   */
+  proc stopCommDiagnosticsBySourceHere() {
+    stopCommDiagnosticsHere();
+    chpl_setCommDiagnosticsBySourceHere(false);
+  }
+
+  /*
+    Retrieve the communication counts for this locale by source
+    location.
+
+    :returns: counts for each source location and kind of operation,
+              largest count first
+    :rtype: `[] commDiagsSource`
+   */
+  proc getCommDiagnosticsBySourceHere() {
+    use Sort;
+
+    var entries: c_ptr(chpl_commDiagsSource);
+    const n = chpl_getCommDiagnosticsBySourceHere(entries): int;
+    var A: [0..#n] commDiagsSource;
+    for i in 0..#n {
+      const ref e = entries[i];
+      A[i].file = if e.lineno < 0 then "<other>"
+                  else chpl_lookupFilename(e.filename): string;
+      A[i].line = e.lineno;
+      A[i].kind = commDiagsKindName(e.kind);
+      A[i].count = e.count;
+      A[i].bytes = e.bytes;
+    }
+    c_free(entries);
+    sort(A, new commDiagsSourceCountComparator());
+    return A;
+  }
+
+  /*
+    Retrieve the communication counts for the whole program by source
+    location.  The counts for a location are summed over all the
+    locales that initiated communication from it.
+
+    :returns: counts for each source location and kind of operation,
+              largest count first
+    :rtype: `[] commDiagsSource`
+   */
+  proc getCommDiagnosticsBySource() {
+    use Sort;
+
+    var all: [0..-1] commDiagsSource;
+    for loc in Locales do on loc {
+      const A = getCommDiagnosticsBySourceHere();
+      on all do all.push_back(A);
+    }
+
+    sort(all, new commDiagsSourceLocComparator());
+    var merged: [0..-1] commDiagsSource;
+    const locCmp = new commDiagsSourceLocComparator();
+    for e in all {
+      if merged.size > 0 &&
+         locCmp.compare(merged[merged.domain.high], e) == 0 {
+        merged[merged.domain.high].count += e.count;
+        merged[merged.domain.high].bytes += e.bytes;
+      } else {
+        merged.push_back(e);
+      }
+    }
+    sort(merged, new commDiagsSourceCountComparator());
+    return merged;
+  }
+
+  /*
+    Print the source locations across the whole program that initiated
+    the most communication operations, one per line, with the number of
+    operations and bytes moved.
+
+    :arg n: the number of locations to print
+   */
+  proc printCommDiagnosticsBySource(n: int = 10) {
+    const A = getCommDiagnosticsBySource();
+    writeln("top remote operations by source location:");
+    for e in A[0..#min(n, A.size)] do
+      writeln("  ", e.file, ":", e.line, ": ", e.kind, ": ",
+              e.count, " ops, ", e.bytes, " bytes");
+  }
+
+
+  /* Remote data cache statistics for one locale.  Like
+     :type:`chpl_commDiagnostics`, this duplicates the runtime definition.
+   */
+  extern record chpl_cacheStats {
+    /*
+      GETs satisfied entirely from the cache
+     */
+    var get_hits: uint(64);
+    /*
+      GETs that had to fetch a page (or part of one)
+     */
+    var get_misses: uint(64);
+    /*
+      misses on pages that had been evicted recently, which a larger
+      cache would have hit on
+     */
+    var get_ghost_hits: uint(64);
+    /*
+      pages fetched by explicit prefetches
+     */
+    var prefetches: uint(64);
+    /*
+      pages fetched by sequential readahead
+     */
+    var readaheads: uint(64);
+    /*
+      pages fetched by readahead that a later GET used
+     */
+    var readahead_hits: uint(64);
+    /*
+      pages fetched by readahead that were dropped without being used
+     */
+    var readahead_unused: uint(64);
+    /*
+      pages evicted to make room for others
+     */
+    var evictions: uint(64);
+    /*
+      PUTs issued to write back dirty data
+     */
+    var dirty_flushes: uint(64);
+    /*
+      pages the caches on this locale can currently hold in total
+     */
+    var capacity_pages: uint(64);
+    /*
+      the largest sequential readahead, in bytes, any cache on this
+      locale currently does
+     */
+    var readahead_max_bytes: uint(64);
+
+    proc writeThis(c) {
+      use Reflection;
+
+      var first = true;
+      c <~> "(";
+      for param i in 1..numFields(chpl_cacheStats) {
+        const val = getField(this, i);
+        if val != 0 {
+          if first then first = false; else c <~> ", ";
+          c <~> getFieldName(chpl_cacheStats, i) <~> " = " <~> val;
+        }
+      }
+      if first then c <~> "<no cache activity>";
+      c <~> ")";
+    }
+  };
+
+  /*
+    The Chapel record type inherits the runtime definition of it.
+   */
+  type cacheStats = chpl_cacheStats;
+
+  private extern proc chpl_cache_stats_get_here(ref cs: cacheStats);
+
+  private extern proc chpl_cache_stats_reset_here();
+
+  /*
+    Reset the remote data cache event counts on all locales.  The
+    capacity and readahead sizes are not affected.
+   */
+  proc resetCacheStats() {
+    for loc in Locales do on loc do
+      resetCacheStatsHere();
+  }
+
+  /*
+    Reset the remote data cache event counts on the calling locale.
+   */
+  inline proc resetCacheStatsHere() {
+    chpl_cache_stats_reset_here();
+  }
+
+  /*
+    Retrieve remote data cache statistics for the whole program.
+
+    :returns: array of the statistics for each locale
+    :rtype: `[LocaleSpace] cacheStats`
+   */
+  proc getCacheStats() {
+    var D: [LocaleSpace] cacheStats;
+    for loc in Locales do on loc {
+      D(loc.id) = getCacheStatsHere();
+    }
+    return D;
+  }
+
+  /*
+    Retrieve remote data cache statistics for this locale.
+
+    :returns: statistics for the caches on this locale
+    :rtype: `cacheStats`
+   */
+  proc getCacheStatsHere() {
+    var cs: cacheStats;
+    chpl_cache_stats_get_here(cs);
+    return cs;
+  }
+
+
   /*
     If this is set, on-the-fly reporting of communication operations
     will be turned on before any module initialization begins and
@@ -934,8 +934,12 @@ private extern proc qio_channel_write_amt(threadsafe:c_int, ch:qio_channel_ptr_t
 private extern proc qio_channel_write_byte(threadsafe:c_int, ch:qio_channel_ptr_t, byte:uint(8)):syserr;
 
 private extern proc qio_channel_offset_unlocked(ch:qio_channel_ptr_t):int(64);
+private extern proc qio_channel_get_file(ch:qio_channel_ptr_t):qio_file_ptr_t;
 private extern proc qio_channel_advance(threadsafe:c_int, ch:qio_channel_ptr_t, nbytes:int(64)):syserr;
 private extern proc qio_channel_advance_past_byte(threadsafe:c_int, ch:qio_channel_ptr_t, byte:c_int):syserr;
+private extern proc qio_channel_begin_peek_record(threadsafe:c_int, ch:qio_channel_ptr_t, separator:c_int, ref ptr_out:c_ptr(uint(8)), ref len_out:int(64)):syserr;
+private extern proc qio_channel_end_peek_record(threadsafe:c_int, ch:qio_channel_ptr_t):syserr;
+private extern proc qio_channel_record_gen(ch:qio_channel_ptr_t):int(64);
 
 private extern proc qio_channel_mark(threadsafe:c_int, ch:qio_channel_ptr_t):syserr;
 private extern proc qio_channel_revert_unlocked(ch:qio_channel_ptr_t);
@@ -2230,6 +2234,19 @@ proc channel.offset():int(64) {
   return ret;
 }
 
+// Return the file that a channel reads or writes
+pragma "no doc"
+proc channel._getFile(): file {
+  var ret: file;
+  on this.home {
+    const fp = qio_channel_get_file(_channel_internal);
+    qio_file_retain(fp);
+    ret.home = here;
+    ret._file_internal = fp;
+  }
+  return ret;
+}
+
 /*
    Move a channel offset forward.
 
@@ -3453,6 +3470,137 @@ iter channel.lines() {
 }
 
 
+/*
+  A read-only view of bytes in a channel's buffer, as yielded by
+  :proc:`channel.recordViews`.  A view refers to the channel's data
+  directly rather than to a copy, so it is only valid until the iteration
+  moves on to the next record.  With bounds checking on, using a view (or
+  a copy of one) after that halts the program.  Use
+  :proc:`bytesView.toString` to keep the data.
+
+  A view must not be used after its channel has been closed, or on a
+  locale other than the channel's.
+ */
+record bytesView {
+  pragma "no doc"
+  var _ptr: c_ptr(uint(8));
+  pragma "no doc"
+  var _len: int;
+  pragma "no doc"
+  var _ch: qio_channel_ptr_t = QIO_CHANNEL_PTR_NULL;
+  pragma "no doc"
+  var _gen: int(64);
+
+  pragma "no doc"
+  inline proc _checkValid() {
+    if boundsChecking &&
+       (is_c_nil(_ch) || qio_channel_record_gen(_ch) != _gen) then
+      halt("bytesView used after the channel moved past its record");
+  }
+
+  /* The number of bytes in the view. */
+  inline proc size {
+    _checkValid();
+    return _len;
+  }
+
+  /* Return the byte at position `i`, which starts at 1. */
+  inline proc this(i: integral): uint(8) {
+    _checkValid();
+    if boundsChecking && (i < 1 || i > _len) then
+      HaltWrappers.boundsCheckHalt("bytesView index out of bounds: " + i);
+    return _ptr[i-1];
+  }
+
+  /* Iterate over the bytes in the view. */
+  iter these(): uint(8) {
+    _checkValid();
+    for i in 0..#_len do
+      yield _ptr[i];
+  }
+
+  /*
+    Return a pointer to the first byte in the view.  The pointer is only
+    valid as long as the view is.
+   */
+  inline proc ptr() {
+    _checkValid();
+    return _ptr;
+  }
+
+  /*
+    Return the position of the first `b` in the view, starting at 1, or 0
+    if there is none.
+   */
+  proc find(b: uint(8)): int {
+    extern proc memchr(s: c_void_ptr, c: c_int, n: size_t): c_void_ptr;
+    _checkValid();
+    const p = memchr(_ptr: c_void_ptr, b: c_int, _len: size_t);
+    if p == c_nil then return 0;
+    return (p: c_intptr - _ptr: c_intptr): int + 1;
+  }
+
+  /* Copy the bytes in the view into a new string. */
+  proc toString(): string {
+    _checkValid();
+    return new string(_ptr, _len, _len+1, isowned=true, needToCopy=true);
+  }
+
+  pragma "no doc"
+  proc writeThis(f) {
+    try! f.write(toString());
+  }
+}
+
+/*
+  Iterate over the records in a channel, where each record ends with
+  ``separator`` (by default ``\n``) or at the end of the input.  Each
+  record is yielded as a :record:`bytesView` that includes its separator,
+  if it has one.
+
+  Unlike :proc:`channel.lines`, this doesn't allocate a string for every
+  record or copy the data.  If the channel is reading an mmap'd file (for
+  example, one opened with the ``IOHINT_CACHED`` or ``IOHINT_PARALLEL``
+  hint), every view points into the mapping.  Otherwise a record that
+  crosses the boundary between two parts of the channel's buffer is copied
+  into scratch space belonging to the channel, which is reused from record
+  to record.
+
+  Only serial iteration is supported, and no other task may use the
+  channel during the iteration.  This iterator must be called on the
+  locale where the channel was created.
+
+  :yields: the records in the channel
+ */
+iter channel.recordViews(separator: uint(8) = 0x0a) const ref : bytesView {
+  if writing then compilerError("recordViews on write-only channel");
+  if this.home != here then
+    halt("channel.recordViews must be called on the locale of the channel");
+
+  var view: bytesView;
+  view._ch = _channel_internal;
+
+  while true {
+    var err: syserr = ENOERR;
+
+    try! this.lock();
+    err = qio_channel_begin_peek_record(false, _channel_internal,
+                                        separator:c_int,
+                                        view._ptr, view._len);
+    view._gen = qio_channel_record_gen(_channel_internal);
+    if !err then
+      qio_channel_end_peek_record(false, _channel_internal);
+    this.unlock();
+
+    if err == EEOF then
+      break;
+    else if err then
+      try! this._ch_ioerror(err, "in channel.recordViews");
+
+    yield view;
+  }
+}
+
 pragma "no doc"
 proc _can_stringify_direct(t) param : bool {
   if (t.type == string ||
@@ -4665,7 +4813,7 @@ proc file.localesForRegion(start:int(64), end:int(64)) {
 
   proc findloc(loc:string, locs:c_ptr(c_string), end:int) {
     for i in 0..end-1 {
-      if (loc == locs[i]) then
+      if (loc == locs[i]:string) then
         return true;
     }
     return false;
@@ -4698,6 +4846,202 @@ proc file.localesForRegion(start:int(64), end:int(64)) {
   return ret;
 }
 
+// Return the offset of the first record that starts at or after 'pos':
+// just past the first 'separator' at or after pos-1, or the file length
+// if there is no such separator.
+pragma "no doc"
+proc file._alignToRecord(pos: int(64), separator: uint(8),
+                         fileLen: int(64)): int(64) {
+  if pos <= 0 then return 0;
+  if pos >= fileLen then return fileLen;
+
+  var ret = fileLen;
+  var r = try! this.reader(locking=false, start=pos-1, hints=IOHINT_NONE,
+                           style=this._style);
+  for v in r.recordViews(separator) {
+    ret = pos - 1 + v.size;
+    break;
+  }
+  try! r.close();
+  return ret;
+}
+
+// Yield the records (as strings) that start in start..end-1, which
+// should both be aligned by file._alignToRecord().
+pragma "no doc"
+iter file._recordsInRegion(start: int(64), end: int(64), separator: uint(8)) {
+  var pos = start;
+  var r = try! this.reader(locking=false, start=start,
+                           hints=IOHINT_SEQUENTIAL, style=this._style);
+  for v in r.recordViews(separator) {
+    if pos >= end then break;
+    pos += v.size;
+    yield v.toString();
+  }
+  try! r.close();
+}
+
+// The chunk size for file.recordRegions()
+pragma "no doc"
+proc file._recordChunkSize(chunkSize: int, distributed: bool,
+                           start: int(64), fileLen: int(64)): int(64) {
+  const useLocales = if distributed then numLocales else 1;
+  var size = if chunkSize > 0 then chunkSize
+             else max((fileLen - start) / (useLocales * here.maxTaskPar * 4),
+                      1 << 16);
+  const (stripeStart, stripeEnd) = try! this.getchunk();
+  const stripe = stripeEnd - stripeStart;
+  if stripe > 0 && stripe < fileLen then
+    size = ((size + stripe - 1) / stripe) * stripe;
+  return size;
+}
+
+// Return a file that refers to the same OS file as 'this' but that can
+// be read from the current locale without communication, when possible.
+pragma "no doc"
+proc file._localCopy(): file {
+  if this.home == here then return this;
+  try {
+    return open(this.path, iomode.r);
+  } catch {
+    return this;
+  }
+}
+
+/*
+   Split the part of the file starting at ``start`` into regions that
+   each hold whole records ending in ``separator``, and yield the
+   regions in parallel as ``(regionStart, regionEnd)`` byte offsets.
+   This is the leader that :iter:`file.records` uses; it is available for
+   other parallel readers of record-oriented files.
+
+   The file is first cut into chunks of ``chunkSize`` bytes, rounded up to
+   a multiple of the chunk size reported by :proc:`file.getchunk` if there
+   is one.  A ``chunkSize`` of 0 picks a size that gives each task a few
+   chunks.  Each chunk boundary is then moved forward to the start of the
+   next record, so that every record is in exactly one region.  Tasks
+   claim chunks dynamically, so a region that takes longer to process
+   doesn't hold up the others.
+
+   If ``distributed`` is true, each chunk is assigned to one of the
+   locales that :proc:`file.localesForRegion` reports for it, balancing
+   the number of chunks per locale, and each region is yielded on its
+   locale.  Otherwise all of the regions are yielded on the current
+   locale.
+
+   :arg separator: the byte that ends each record
+   :arg distributed: whether to spread the regions over locales
+   :arg chunkSize: the approximate size of each region in bytes
+   :arg start: the offset at which to start, which should be the start
+               of a record
+   :yields: tuples of (regionStart, regionEnd) offsets
+ */
+iter file.recordRegions(separator: uint(8) = 0x0a, distributed: bool = false,
+                        chunkSize: int = 0, start: int(64) = 0): 2*int(64) {
+  const fileLen = try! this.length();
+  const size = this._recordChunkSize(chunkSize, distributed, start, fileLen);
+  var s = this._alignToRecord(start, separator, fileLen);
+  var pos = start;
+  while pos < fileLen {
+    pos = min(pos + size, fileLen);
+    const e = this._alignToRecord(pos, separator, fileLen);
+    if s < e then yield (s, e);
+    s = max(s, e);
+  }
+}
+
+pragma "no doc"
+iter file.recordRegions(param tag: iterKind, separator: uint(8) = 0x0a,
+                        distributed: bool = false, chunkSize: int = 0,
+                        start: int(64) = 0): 2*int(64)
+    where tag == iterKind.standalone {
+  const fileLen = try! this.length();
+  if start >= fileLen then return;
+
+  const useLocales = if distributed then numLocales else 1;
+  const size = this._recordChunkSize(chunkSize, distributed, start, fileLen);
+  const numChunks = (fileLen - start + size - 1) / size;
+
+  proc chunkStart(i) return min(start + i*size, fileLen);
+
+  // Which locale reads each chunk
+  var owner: [0..#numChunks] int;
+  if useLocales > 1 {
+    var load: [LocaleSpace] int;
+    for i in 0..#numChunks {
+      var pick = -1;
+      for loc in this.localesForRegion(chunkStart(i), chunkStart(i+1)) do
+        if pick == -1 || load[loc.id] < load[pick] then
+          pick = loc.id;
+      owner[i] = pick;
+      load[pick] += 1;
+    }
+  } else {
+    owner = here.id;
+  }
+
+  coforall loc in Locales do on loc {
+    if (|| reduce (owner == here.id)) {
+      const myOwner = owner;
+      const f = this._localCopy();
+      var nextChunk: atomic int;
+      coforall tid in 0..#here.maxTaskPar {
+        while true {
+          const i = nextChunk.fetchAdd(1);
+          if i >= numChunks then break;
+          if myOwner[i] != here.id then continue;
+          const s = f._alignToRecord(chunkStart(i), separator, fileLen),
+                e = f._alignToRecord(chunkStart(i+1), separator, fileLen);
+          if s < e then yield (s, e);
+        }
+      }
+    }
+  }
+}
+
+/*
+   Iterate over the records in a file, where each record ends with
+   ``separator`` (by default ``\n``) or at the end of the file.  Each
+   record is yielded as a string that includes its separator, if it has
+   one.
+
+   In a ``forall`` loop the file is split into regions by
+   :iter:`file.recordRegions` and the records in each region are read by a
+   different task, possibly on a different locale if ``distributed`` is
+   true.  Records are yielded in file order only by the serial version.
+   This iterator may be used in serial or non-zippered parallel contexts,
+   because the number of records in each region isn't known ahead of
+   time.
+
+   When ``distributed`` is true, each locale other than the one the file
+   was opened on reopens the file by its path, so the file must be
+   visible to all of the locales (for example, on a shared file system).
+
+   :arg separator: the byte that ends each record
+   :arg distributed: whether to read the file from all locales
+   :arg chunkSize: the approximate number of bytes each task reads at a
+                   time; 0 (the default) picks a size based on the file
+                   size and the number of tasks
+   :yields: the records in the file
+ */
+iter file.records(separator: uint(8) = 0x0a, distributed: bool = false,
+                  chunkSize: int = 0): string {
+  const fileLen = try! this.length();
+  for r in this._recordsInRegion(0, fileLen, separator) do
+    yield r;
+}
+
+pragma "no doc"
+iter file.records(param tag: iterKind, separator: uint(8) = 0x0a,
+                  distributed: bool = false, chunkSize: int = 0): string
+    where tag == iterKind.standalone {
+  forall (s, e) in this.recordRegions(separator, distributed, chunkSize) {
+    const f = this._localCopy();
+    for r in f._recordsInRegion(s, e, separator) do
+      yield r;
+  }
+}
+
 
 /*
 
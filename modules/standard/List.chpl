@@ -18,7 +18,14 @@
  */
 
 /*
-  This module provides a simple singly linked list.
+  This module provides a simple list that stores its elements contiguously.
+
+  Elements are kept in a single buffer that grows geometrically, so
+  appending an element takes amortized constant time, elements can be
+  accessed by position in constant time, and the list can be iterated over
+  in parallel.  This makes :record:`list` a good choice for accumulating
+  results one at a time, especially when the final number of elements can
+  be estimated ahead of time and passed to :proc:`~list.reserve`.
 
   .. note::
 
@@ -26,24 +33,23 @@
  */
 module List {
 
-pragma "no doc"
-class listNode {
-  type eltType;
-  var data: eltType;
-  var next: unmanaged listNode(eltType);
-}
+  // Number of elements a list has room for after its first allocation
+  private proc listMinCapacity param return 8;
 
 
   pragma "no doc"
   proc =(ref l1: list(?t), const ref l2: list(?t2)) {
     l1.destroy();
+    l1.reserve(l2.length);
     for i in l2 do
       l1.append(i);
   }
 
 
 /*
-  A singly linked list.
+  A list of elements stored contiguously in memory.
+
+  Positions in the list start at 1.
 
   .. note::
 
@@ -52,31 +58,32 @@ class listNode {
  */
 record list {
   /*
-    The type of the data stored in every node.
+    The type of the data stored in the list.
    */
   type eltType;
   pragma "no doc"
-  pragma "owned"
-  var first: unmanaged listNode(eltType);
+  var _data: _ddata(eltType);
+  pragma "no doc"
+  var _capacity: int;
+  // Position in _data of the first element.  Removing elements from the
+  // front of the list advances it rather than moving the other elements.
   pragma "no doc"
-  pragma "owned"
-  var last: unmanaged listNode(eltType);
+  var _head: int;
   /*
-    The number of nodes in the list.
+    The number of elements in the list.
    */
   var length: int;
 
   pragma "no doc"
-  proc init(type eltType, first : unmanaged listNode(eltType) = nil, last : unmanaged listNode(eltType) = nil) {
+  proc init(type eltType) {
     this.eltType = eltType;
-    this.first = first;
-    this.last = last;
   }
 
   pragma "no doc"
   proc init=(l : this.type) {
     this.eltType = l.eltType;
     this.complete();
+    reserve(l.length);
     for i in l do
       this.append(i);
   }
@@ -88,30 +95,111 @@ record list {
     return length;
   }
 
+  /*
+    The number of elements the list can hold before it must allocate more
+    memory.
+   */
+  proc capacity {
+    return _capacity - _head;
+  }
+
+  /*
+    Make room for at least `n` elements in total, so that appending up to
+    `n` - :proc:`~list.size` elements will not allocate memory.
+   */
+  proc ref reserve(n: int) {
+    if n > capacity then
+      _realloc(n, 0);
+  }
+
+  // Like reserve(), but grows geometrically so that repeated calls take
+  // amortized constant time per element.
+  pragma "no doc"
+  proc ref _reserveGrow(n: int) {
+    if n > capacity then
+      _realloc(max(n, 2*_capacity), 0);
+  }
+
+  /*
+    Return (a reference to) the element at position `i`.
+   */
+  pragma "reference to const when const this"
+  inline proc this(i: integral) ref {
+    if boundsChecking && (i < 1 || i > length) then
+      HaltWrappers.boundsCheckHalt("list index out of bounds: " + i);
+    return _data[_head + (i - 1):int];
+  }
+
   /*
     Iterate over the list, yielding each element.
 
     :ytype: eltType
    */
-  iter these() {
-    var tmp = first;
-    while tmp != nil {
-      yield tmp.data;
-      tmp = tmp.next;
+  pragma "reference to const when const this"
+  iter these() ref {
+    for i in _head..#length do
+      yield _data[i];
+  }
+
+  pragma "no doc"
+  pragma "reference to const when const this"
+  iter these(param tag: iterKind) ref where tag == iterKind.standalone {
+    use DSIUtil;
+
+    const numChunks = if __primitive("task_get_serial") then
+                      1 else _computeNumChunks(length);
+
+    if numChunks <= 1 {
+      for i in _head..#length do
+        yield _data[i];
+    } else {
+      coforall chunk in 0..#numChunks {
+        const (lo, hi) = _computeBlock(length, numChunks, chunk, length-1);
+        for i in lo..hi do
+          yield _data[_head+i];
+      }
+    }
+  }
+
+  pragma "no doc"
+  iter these(param tag: iterKind) where tag == iterKind.leader {
+    use DSIUtil;
+
+    const numChunks = if __primitive("task_get_serial") then
+                      1 else _computeNumChunks(length);
+
+    if numChunks <= 1 {
+      yield (0..#length,);
+    } else {
+      coforall chunk in 0..#numChunks {
+        const (lo, hi) = _computeBlock(length, numChunks, chunk, length-1);
+        yield (lo..hi,);
+      }
     }
   }
 
+  pragma "no doc"
+  pragma "reference to const when const this"
+  iter these(param tag: iterKind, followThis) ref
+    where tag == iterKind.follower {
+    if followThis.size != 1 then
+      compilerError("list follower iterator requires a 1-tuple");
+
+    const r = followThis(1);
+    if boundsChecking && r.length > 0 && (r.low < 0 || r.high >= length) then
+      HaltWrappers.boundsCheckHalt("zippered iteration over a list of length " +
+                                   length + " with " + r.length + " indices");
+    for i in r do
+      yield _data[_head+i];
+  }
+
   /*
     Append `e` to the list.
    */
   proc ref append(e : eltType) {
-    if last {
-      last.next = new unmanaged listNode(eltType, e);
-      last = last.next;
-    } else {
-      first = new unmanaged listNode(eltType, e);
-      last = first;
-    }
+    if _head + length == _capacity then
+      _makeRoomAtBack();
+    _data[_head+length] = e;
     length += 1;
   }
   /*
@@ -126,6 +214,7 @@ record list {
    */
   //TODO: merge the append overloads
   proc append(e: eltType, es: eltType ...?k) {
+    _reserveGrow(length + 1 + k);
     append(e);
     for param i in 1..k do
       append(es(i));
@@ -135,9 +224,10 @@ record list {
     Prepend `e` to the list.
    */
   proc prepend(e : eltType) {
-    first = new unmanaged listNode(eltType, e, first);
-    if last == nil then
-      last = first;
+    if _head == 0 then
+      _makeRoomAtFront();
+    _head -= 1;
+    _data[_head] = e;
     length += 1;
   }
 
@@ -153,31 +243,46 @@ record list {
     Append all the elements in `l` to the end of the list.
    */
   proc concat(l: list(eltType)) {
+    _reserveGrow(length + l.length);
     for e in l do
       append(e);
   }
 
+  /*
+    Append all the elements of the array `x` to the end of the list.
+   */
+  proc ref extend(x: [] eltType) {
+    _reserveGrow(length + x.size);
+    for (i, e) in zip(_head+length.., x) do
+      _data[i] = e;
+    length += x.size;
+  }
+
   /*
     Remove the first encountered instance of `x` from the list.
     Does nothing if `x` is not present in the list.
    */
   proc ref remove(x: eltType) {
-    var tmp = first,
-        prev: first.type = nil;
-    while tmp != nil && tmp.data != x {
-      prev = tmp;
-      tmp = tmp.next;
-    }
-    if tmp != nil {
-      if prev != nil then
-        prev.next = tmp.next;
-      if first == tmp then
-        first = tmp.next;
-      if last == tmp then
-        last = prev;
-      delete tmp;
-      length -= 1;
+    var pos = _head;
+    while pos < _head + length && _data[pos] != x do
+      pos += 1;
+    if pos == _head + length then
+      return;
+
+    // Close the gap from whichever side has fewer elements to move
+    if pos - _head < length / 2 {
+      for i in _head+1..pos by -1 do
+        _data[i] <=> _data[i-1];
+      _clearSlot(_head);
+      _head += 1;
+    } else {
+      for i in pos.._head+length-2 do
+        _data[i] <=> _data[i+1];
+      _clearSlot(_head+length-1);
     }
+    length -= 1;
+    if length == 0 then
+      _head = 0;
   }
 
   /*
@@ -188,31 +293,108 @@ record list {
      if boundsChecking && length < 1 {
        HaltWrappers.boundsCheckHalt("pop_front on empty list");
      }
-     var oldfirst = first;
-     var newfirst = first.next;
-     var ret = oldfirst.data;
-     first = newfirst;
-     if last == oldfirst then last = newfirst;
+     var ret: eltType;
+     ret <=> _data[_head];
+     _head += 1;
      length -= 1;
-     delete oldfirst;
+     if length == 0 then _head = 0;
      return ret;
    }
 
   /*
-    Delete every node in the list.
+     Remove the last element from the list and return it.
+     It is an error to call this function on an empty list.
+   */
+   proc pop_back():eltType {
+     if boundsChecking && length < 1 {
+       HaltWrappers.boundsCheckHalt("pop_back on empty list");
+     }
+     var ret: eltType;
+     ret <=> _data[_head+length-1];
+     length -= 1;
+     if length == 0 then _head = 0;
+     return ret;
+   }
+
+  /*
+    Delete every element in the list and free its memory.
    */
   proc destroy() {
-    var current = first;
-    while (current != nil) {
-      var next = current.next;
-      delete current;
-      current = next;
+    if _data != nil {
+      param needsDestroy = __primitive("needs auto destroy",
+                                       __primitive("deref", _data[0]));
+      if needsDestroy then
+        for i in 0..#_capacity do
+          chpl__autoDestroy(_data[i]);
+      _ddata_free(_data, _capacity);
     }
-    first = nil;
-    last = nil;
+    _data = nil;
+    _capacity = 0;
+    _head = 0;
     length = 0;
   }
 
+  // Called when there is no free slot after the last element.  Moves the
+  // elements back to split the free slots between the two ends if there
+  // are any, or else doubles the buffer.
+  pragma "no doc"
+  proc ref _makeRoomAtBack() {
+    if length < _capacity then
+      _moveElements((_capacity - length) / 2);
+    else
+      _realloc(max(2*_capacity, listMinCapacity), 0);
+  }
+
+  // Called when there is no free slot before the first element.  Like
+  // _makeRoomAtBack(), only grows the buffer when it is full.
+  pragma "no doc"
+  proc ref _makeRoomAtFront() {
+    if length < _capacity {
+      _moveElements((_capacity - length + 1) / 2);
+    } else {
+      const newCapacity = max(2*_capacity, listMinCapacity);
+      _realloc(newCapacity, (newCapacity - length + 1) / 2);
+    }
+  }
+
+  // Move the elements within the buffer so that the first one is at
+  // position 'newHead'.  The loops run in the direction that never
+  // overwrites an element that hasn't been moved yet.
+  pragma "no doc"
+  proc ref _moveElements(newHead: int) {
+    if newHead < _head {
+      for i in 0..#length do
+        _data[newHead+i] <=> _data[_head+i];
+    } else if newHead > _head {
+      for i in 0..#length by -1 do
+        _data[newHead+i] <=> _data[_head+i];
+    }
+    _head = newHead;
+  }
+
+  // Move the elements to a new buffer of 'newCapacity' slots, with the
+  // first element at position 'newHead'.
+  pragma "no doc"
+  proc ref _realloc(newCapacity: int, newHead: int) {
+    var newData = _ddata_allocate(eltType, newCapacity);
+    for i in 0..#length do
+      newData[newHead+i] <=> _data[_head+i];
+    const oldLength = length;
+    destroy();
+    _data = newData;
+    _capacity = newCapacity;
+    _head = newHead;
+    length = oldLength;
+  }
+
+  // Reset a slot no longer holding an element to the default value so
+  // that anything the old value refers to can be freed.
+  pragma "no doc"
+  inline proc ref _clearSlot(i: int) {
+    var empty: eltType;
+    _data[i] <=> empty;
+  }
+
   /*
     Destructor
    */
@@ -70,6 +70,19 @@
     If during execution the amount of allocated memory exceeds this
     limit on any locale, halt the program with a message saying so.
 
+  ``memSample``: `uint`:
+    If the value is greater than 0 (zero), enable memory tracking in
+    sampling mode.  Rather than tracking every allocation, only about
+    one allocation per this many bytes allocated is tracked, each
+    standing for the allocations around it.  This costs much less than
+    tracking everything, and the reports, statistics, and ``memMax``
+    limit are then estimates that account for the allocations not
+    tracked.  Allocations are attributed to source lines as usual.
+
+  ``memSampleByCount``: `bool`:
+    In sampling mode, track about one in ``memSample`` allocations
+    rather than one per ``memSample`` bytes.
+
   The following two config variables do not enable memory tracking;
   they only modify how it is done.
 
@@ -51,6 +51,7 @@
 
      * :mod:`PCGRandom`
      * :mod:`NPBRandom`
+     * :mod:`PhiloxRandom`
 
    .. note::
 
@@ -75,15 +76,17 @@ module Random {
   use RandomSupport;
   use NPBRandom;
   use PCGRandom;
+  use PhiloxRandom;
 
 
   /* Select between different supported RNG algorithms.
-     See :mod:`PCGRandom` and :mod:`NPBRandom` for details on
-     these algorithms.
+     See :mod:`PCGRandom`, :mod:`NPBRandom` and :mod:`PhiloxRandom` for
+     details on these algorithms.
    */
   enum RNG {
     PCG = 1,
-    NPB = 2
+    NPB = 2,
+    Philox = 3
   }
 
   /* The default RNG. The current default is PCG - see :mod:`PCGRandom`. */
@@ -206,6 +209,8 @@ module Random {
       return new owned RandomStream(seed=seed, parSafe=parSafe, eltType=eltType);
     else if algorithm == RNG.NPB then
       return new owned NPBRandomStream(seed=seed, parSafe=parSafe, eltType=eltType);
+    else if algorithm == RNG.Philox then
+      return new owned PhiloxRandomStream(seed=seed, parSafe=parSafe, eltType=eltType);
     else
       compilerError("Unknown random number generator");
   }
@@ -661,6 +666,9 @@ module Random {
       else return (numBits(t)+31) / 32;
     }
 
+    // Arrays with more elements than this are shuffled in parallel.
+    private param parallelShuffleMinSize = 1 << 16;
+
     /*
 
       Models a stream of pseudorandom numbers generated by the PCG random number
@@ -819,6 +827,19 @@ module Random {
         PCGRandomStreamPrivate_rngs = randlc_skipto(eltType, seed, n);
       }
 
+      // Advance the stream past the next n values, which the caller will
+      // compute itself, and return the position of the first of them.
+      pragma "no doc"
+      proc PCGRandomStreamPrivate_reserve(n: integral): int(64) {
+        if parSafe then
+          PCGRandomStreamPrivate_lock$ = true;
+        const start = PCGRandomStreamPrivate_count;
+        PCGRandomStreamPrivate_skipToNth_noLock(start + n.safeCast(int(64)));
+        if parSafe then
+          PCGRandomStreamPrivate_lock$;
+        return start;
+      }
+
       /*
         Returns the next value in the random stream.
 
@@ -977,12 +998,25 @@ module Random {
         return _choice(this, arr, size=size, replace=replace, prob=prob);
       }
 
-      /* Randomly shuffle a 1-D array. */
+      /* Randomly shuffle a 1-D array.
+
+         Arrays with more than a few tens of thousands of elements are
+         shuffled in parallel, and distributed arrays are shuffled with
+         each locale working on the elements it owns.  The result depends
+         only on the seed, the position in the stream and the size of the
+         array, not on the number of tasks or locales.
+       */
       proc shuffle(arr: [?D] ?eltType ) {
 
         if D.rank != 1 then
           compilerError("Shuffle requires 1-D array");
 
+        if D.size > parallelShuffleMinSize {
+          PCGRandomPrivate_shuffle(arr, seed,
+                                   PCGRandomStreamPrivate_reserve(2*D.size));
+          return;
+        }
+
         const low = D.low,
               high = D.high,
               stride = D.stride;
@@ -1024,6 +1058,9 @@ module Random {
       /* Produce a random permutation, storing it in a 1-D array.
          The resulting array will include each value from low..high
          exactly once, where low and high refer to the array's domain.
+
+         Like :proc:`shuffle`, large and distributed arrays are handled in
+         parallel.
          */
       proc permutation(arr: [] eltType) {
         var low = arr.domain.dim(1).low;
@@ -1034,6 +1071,14 @@ module Random {
         //if arr.domain.dim(1).stridable then
         //  compilerError("Permutation requires non-stridable 1-D array");
 
+        if !arr.domain.stridable && arr.size > parallelShuffleMinSize {
+          forall (x, i) in zip(arr, arr.domain) do
+            x = i;
+          PCGRandomPrivate_shuffle(arr, seed,
+                                   PCGRandomStreamPrivate_reserve(2*arr.size));
+          return;
+        }
+
         if parSafe then
           PCGRandomStreamPrivate_lock$ = true;
 
@@ -1419,6 +1464,172 @@ module Random {
       }
     }
 
+    // The parallel shuffle aims for buckets of this many elements, but
+    // uses no more than maxShuffleBuckets of them.
+    private param shuffleBucketSize = 1 << 12,
+                  maxShuffleBuckets = 1 << 10;
+
+    // Returns the indices of r at orders lo..#len.
+    private inline proc orderSlice(r: range(?), lo: int, len: int) {
+      return (r # (lo + len)) # -len;
+    }
+
+    //
+    // Returns, in order, the numbers of the blocks of arr whose first
+    // element is stored on this locale.  Block b starts at order
+    // starts[b]; empty blocks are left out.  If arr cannot report a single
+    // local subdomain, all blocks are given to its first target locale.
+    //
+    private proc localBlocks(arr: [?D], starts: [] int, sizes: [] int) {
+      var blocks: [starts.domain] int;
+      var n = 0;
+      for b in starts.domain {
+        if sizes[b] == 0 then continue;
+        var mine: bool;
+        if arr.hasSingleLocalSubdomain() then
+          mine = arr.localSubdomain().contains(D.dim(1).orderToIndex(starts[b]));
+        else
+          mine = here == arr.targetLocales()[arr.targetLocales().domain.low];
+        if mine {
+          blocks[n] = b;
+          n += 1;
+        }
+      }
+      const ret = blocks[0..#n];
+      return ret;
+    }
+
+    // Fills bucket with the buckets that the elements of a chunk go to,
+    // using the values of the stream starting at position pos.
+    private proc chunkBuckets(type idxType, seed: int(64), pos: int(64),
+                              nBuckets: int, ref bucket: [] int) {
+      var cursor = randlc_skipto(idxType, seed, pos);
+      for (b, i) in zip(bucket, 0..) do
+        b = randlc_bounded(idxType, cursor, seed, pos + i,
+                           0:idxType, (nBuckets-1):idxType):int;
+    }
+
+    //
+    // Shuffle a 1-D array in parallel, using the 2*arr.size values of the
+    // stream starting at position start.  This is a bucketed scatter and
+    // local shuffle (Sanders, "Random Permutations on Distributed, External
+    // and Hierarchical Memory", 1998):
+    //
+    //  1. The array is split into chunks of consecutive elements.  Each
+    //     chunk sends each of its elements to a random bucket, using the
+    //     value at the element's position in the stream.
+    //  2. The buckets are laid out one after the other in a temporary
+    //     array, and each chunk copies the elements it sends to each bucket
+    //     there with a single bulk transfer.
+    //  3. Each bucket is fetched with a bulk transfer, shuffled locally with
+    //     Fisher-Yates, and stored back to the same positions of arr.
+    //
+    // Assigning elements to buckets uniformly at random and then shuffling
+    // each bucket uniformly gives a uniform permutation.  Chunks and buckets
+    // are handled on the locale that owns their first element, and their
+    // number only depends on the size of the array, so the result does not
+    // depend on how many tasks or locales did the work.
+    //
+    pragma "no doc"
+    proc PCGRandomPrivate_shuffle(arr: [?D] ?eltType, seed: int(64),
+                                  start: int(64)) {
+      type idxType = D.idxType;
+      const r = D.dim(1),
+            n = D.size;
+      const nBuckets = min(maxShuffleBuckets,
+                           max(1, divceil(n, shuffleBucketSize))),
+            chunkSize = divceil(n, nBuckets),
+            nChunks = divceil(n, chunkSize);
+      const Chunks = {0..#nChunks};
+      const chunkStarts: [Chunks] int = [c in Chunks] c * chunkSize,
+            chunkSizes: [Chunks] int = [c in Chunks] min(chunkSize,
+                                                         n - c*chunkSize);
+
+      // counts[c*nBuckets + b] is the number of elements chunk c sends to
+      // bucket b.  Each chunk stores its counts with one transfer.
+      var counts: [0..#nChunks*nBuckets] int;
+      coforall loc in arr.targetLocales() do on loc {
+        forall c in localBlocks(arr, chunkStarts, chunkSizes) {
+          const len = chunkSizes[c];
+          var bucket: [0..#len] int;
+          var myCounts: [0..#nBuckets] int;
+          chunkBuckets(idxType, seed, start + chunkStarts[c], nBuckets,
+                       bucket);
+          for b in bucket do
+            myCounts[b] += 1;
+          counts[c*nBuckets..#nBuckets] = myCounts;
+        }
+      }
+
+      // Lay the buckets out in order, and the contributions to each bucket
+      // in chunk order, turning counts into offsets into tmp
+      const Buckets = {0..#nBuckets};
+      var bucketStarts, bucketSizes: [Buckets] int;
+      var offset = 0;
+      for b in Buckets {
+        bucketStarts[b] = offset;
+        for c in Chunks {
+          const cnt = counts[c*nBuckets + b];
+          counts[c*nBuckets + b] = offset;
+          offset += cnt;
+        }
+        bucketSizes[b] = offset - bucketStarts[b];
+      }
+
+      var tmp: [D] eltType;
+      coforall loc in arr.targetLocales() do on loc {
+        forall c in localBlocks(arr, chunkStarts, chunkSizes) {
+          const lo = chunkStarts[c],
+                len = chunkSizes[c];
+          const src: [0..#len] eltType = arr[orderSlice(r, lo, len)];
+          var bucket: [0..#len] int;
+          var offsets: [0..#nBuckets] int = counts[c*nBuckets..#nBuckets];
+          chunkBuckets(idxType, seed, start + lo, nBuckets, bucket);
+
+          // Sort this chunk's elements by bucket, keeping their order
+          var bucketLo, next: [0..#nBuckets] int;
+          for b in bucket do
+            next[b] += 1;
+          var sum = 0;
+          for (bl, cnt) in zip(bucketLo, next) {
+            bl = sum;
+            sum += cnt;
+            cnt = bl;
+          }
+          var sorted: [0..#len] eltType;
+          for (x, b) in zip(src, bucket) {
+            sorted[next[b]] = x;
+            next[b] += 1;
+          }
+
+          for b in 0..#nBuckets {
+            const cnt = next[b] - bucketLo[b];
+            if cnt > 0 then
+              tmp[orderSlice(r, offsets[b], cnt)] = sorted[bucketLo[b]..#cnt];
+          }
+        }
+      }
+
+      coforall loc in arr.targetLocales() do on loc {
+        forall b in localBlocks(arr, bucketStarts, bucketSizes) {
+          const lo = bucketStarts[b],
+                len = bucketSizes[b];
+          const pos = start + n + lo;
+          var elts: [0..#len] eltType = tmp[orderSlice(r, lo, len)];
+          var cursor = randlc_skipto(idxType, seed, pos);
+
+          // Fisher-Yates shuffle
+          for i in 0..#len by -1 {
+            const k = randlc_bounded(idxType, cursor, seed,
+                                     pos + len-1 - i, 0:idxType, i:idxType);
+            elts[i] <=> elts[k:int];
+          }
+
+          arr[orderSlice(r, lo, len)] = elts;
+        }
+      }
+    }
+
 
   } // close module PCGRandom
 
@@ -2669,6 +2880,606 @@ module Random {
 
   } // close module NPBRandom
 
+  /*
+     Counter-based Random Number Generator
+
+     This module provides the Philox4x32-10 random number generator described
+     in the paper `Parallel Random Numbers: As Easy as 1, 2, 3` by
+     J. K. Salmon, M. A. Moraes, R. O. Dror, and D. E. Shaw (SC11), and used
+     in the Random123 library.  See http://www.deshawresearch.com/resources_random123.html
+
+     A counter-based RNG has no state other than its key, which is computed
+     from the seed.  The `n`-th value of a stream is a function of the seed
+     and `n` alone, so skipping to any position in the stream takes constant
+     time, and values can be generated in any order, or by any number of
+     tasks at once, without changing them.  This makes
+     :proc:`PhiloxRandomStream.fillRandom` and
+     :proc:`PhiloxRandomStream.iterate` as cheap in parallel, and on
+     distributed arrays, as they are serially.
+
+     Each call to the generator produces four 32-bit words from a 128-bit
+     counter.  These make up four values of 32 bits or less, two 64-bit
+     values, or one `complex(128)`.  The generator has been shown by its
+     authors to pass the TestU01 BigCrush suite.
+
+     Like :mod:`PCGRandom`, this generator is not suitable for generating key
+     material for encryption.
+
+     .. note::
+
+       The interface provided by this module is expected to change.
+  */
+  module PhiloxRandom {
+
+    use RandomSupport;
+
+    /*
+      Models a stream of pseudorandom numbers generated by the Philox4x32-10
+      counter-based RNG.  See the module-level notes for :mod:`PhiloxRandom`
+      for details on the RNG used.
+
+      Generated integers cover the full value range of the integer.  Reals
+      are in [0, 1), with 53 bits of precision for `real(64)` and 24 for
+      `real(32)`.  Imaginary and complex numbers are generated likewise.
+    */
+    class PhiloxRandomStream {
+      /*
+        Specifies the type of value generated by the PhiloxRandomStream.
+        All numeric types are supported: `int`, `uint`, `real`, `imag`,
+        `complex`, and `bool` types of all sizes.
+      */
+      type eltType;
+
+      /*
+        The seed value for the PRNG.  It can be any int(64) value.
+      */
+      const seed: int(64);
+
+      /*
+        Indicates whether or not the PhiloxRandomStream needs to be
+        parallel-safe by default.  If multiple tasks interact with it in
+        an uncoordinated fashion, this must be set to `true`.  If it will
+        only be called from a single task, or if only one task will call
+        into it at a time, setting to `false` will reduce overhead related
+        to ensuring mutual exclusion.
+      */
+      param parSafe: bool = true;
+
+      /*
+        Creates a new stream of random numbers using the specified seed
+        and parallel safety.
+
+        :arg eltType: The element type to be generated.
+        :type eltType: `type`
+
+        :arg seed: The seed to use for the PRNG.  Defaults to
+          `currentTime` from :type:`~RandomSupport.SeedGenerator`.
+          Can be any int(64) value.
+        :type seed: `int(64)`
+
+        :arg parSafe: The parallel safety setting.  Defaults to `true`.
+        :type parSafe: `bool`
+
+      */
+      proc init(type eltType,
+                seed: int(64) = SeedGenerator.currentTime,
+                param parSafe: bool = true) {
+        this.eltType = eltType;
+        this.seed = seed;
+        this.parSafe = parSafe;
+        this.complete();
+        if !isNumericType(eltType) && !isBoolType(eltType) then
+          compilerError("PhiloxRandomStream only supports numeric and bool eltTypes");
+      }
+
+      pragma "no doc"
+      proc PhiloxRandomStreamPrivate_getNext_noLock(type resultType) {
+        PhiloxRandomStreamPrivate_count += 1;
+        return philoxValue(resultType, eltType, philoxKey(seed),
+                           (PhiloxRandomStreamPrivate_count - 2):uint(64));
+      }
+
+      pragma "no doc"
+      proc PhiloxRandomStreamPrivate_getNext_noLock(type resultType,
+                                                    min: resultType,
+                                                    max: resultType) {
+        PhiloxRandomStreamPrivate_count += 1;
+        return philoxBounded(resultType, eltType, philoxKey(seed),
+                             (PhiloxRandomStreamPrivate_count - 2):uint(64),
+                             min, max);
+      }
+
+      /*
+        Returns the next value in the random stream.
+
+        :arg resultType: the type of the result. Defaults to :type:`eltType`.
+          `resultType` must be the same or a smaller size number.
+        :returns: The next value in the random stream as type `resultType`.
+       */
+      proc getNext(type resultType=eltType): resultType {
+        if parSafe then
+          PhiloxRandomStreamPrivate_lock$ = true;
+        const result = PhiloxRandomStreamPrivate_getNext_noLock(resultType);
+        if parSafe then
+          PhiloxRandomStreamPrivate_lock$;
+        return result;
+      }
+
+      /*
+        Return the next random value but within a particular range.
+        Returns a number in [`min`, `max`] (inclusive) for integers, and
+        in [`min`, `max`) for real, imaginary and complex numbers.  Halts if
+        checks are enabled and ``min > max``.
+
+        Integers are generated without bias, by rejecting the few values
+        that would bias the result.  Each rejected value is replaced by one
+        computed from a separate counter, so the position of later values
+        in the stream is unaffected.
+       */
+      proc getNext(min: eltType, max: eltType): eltType {
+        return getNext(eltType, min, max);
+      }
+
+      /*
+        As with getNext(min, max) but allows specifying the result type.
+       */
+      proc getNext(type resultType,
+                   min: resultType, max: resultType): resultType {
+        if parSafe then
+          PhiloxRandomStreamPrivate_lock$ = true;
+
+        if boundsChecking && min > max then
+          HaltWrappers.boundsCheckHalt("Cannot generate random numbers within empty range: [" + min + ", " + max + "]");
+
+        const result = PhiloxRandomStreamPrivate_getNext_noLock(resultType,
+                                                                min, max);
+        if parSafe then
+          PhiloxRandomStreamPrivate_lock$;
+        return result;
+      }
+
+      /*
+        Advances/rewinds the stream to the `n`-th value in the sequence.
+        The first value is with n=1.  n must be > 0, otherwise an
+        IllegalArgumentError is thrown.  This takes constant time.
+
+        :arg n: The position in the stream to skip to.  Must be > 0.
+        :type n: `integral`
+       */
+      proc skipToNth(n: integral) throws {
+        if n <= 0 then
+          throw new owned IllegalArgumentError("PhiloxRandomStream.skipToNth(n) called with non-positive 'n' value " + n);
+        if parSafe then
+          PhiloxRandomStreamPrivate_lock$ = true;
+        PhiloxRandomStreamPrivate_count = n;
+        if parSafe then
+          PhiloxRandomStreamPrivate_lock$;
+      }
+
+      /*
+        Advance/rewind the stream to the `n`-th value and return it
+        (advancing the stream by one).  n must be > 0, otherwise an
+        IllegalArgumentError is thrown.  This is equivalent to
+        :proc:`skipToNth()` followed by :proc:`getNext()`.
+
+        :arg n: The position in the stream to skip to.  Must be > 0.
+        :type n: `integral`
+
+        :returns: The `n`-th value in the random stream as type :type:`eltType`.
+       */
+      proc getNth(n: integral): eltType throws {
+        if (n <= 0) then
+          throw new owned IllegalArgumentError("PhiloxRandomStream.getNth(n) called with non-positive 'n' value " + n);
+        if parSafe then
+          PhiloxRandomStreamPrivate_lock$ = true;
+        PhiloxRandomStreamPrivate_count = n;
+        const result = PhiloxRandomStreamPrivate_getNext_noLock(eltType);
+        if parSafe then
+          PhiloxRandomStreamPrivate_lock$;
+        return result;
+      }
+
+      /*
+        Fill the argument array with pseudorandom values.  This method is
+        identical to the standalone :proc:`~Random.fillRandom` procedure,
+        except that it consumes random values from the
+        :class:`PhiloxRandomStream` object on which it's invoked rather
+        than creating a new stream for the purpose of the call.
+
+        :arg arr: The array to be filled
+        :type arr: [] :type:`eltType`
+      */
+      proc fillRandom(arr: [] eltType) {
+        forall (x, r) in zip(arr, iterate(arr.domain, arr.eltType)) do
+          x = r;
+      }
+
+      pragma "no doc"
+      proc fillRandom(arr: []) {
+        compilerError("PhiloxRandomStream(eltType=", eltType:string,
+                      ") can only be used to fill arrays of ", eltType:string);
+      }
+
+      /*
+        Returns a random sample from a given 1-D array, ``arr``.  See
+        :proc:`PCGRandom.RandomStream.choice` for the arguments.
+      */
+      proc choice(arr: [], size:?sizeType=_void, replace=true, prob:?probType=_void)
+        throws
+      {
+        return _choice(this, arr, size=size, replace=replace, prob=prob);
+      }
+
+      /* Randomly shuffle a 1-D array. */
+      proc shuffle(arr: [?D] ?eltType) {
+        if D.rank != 1 then
+          compilerError("Shuffle requires 1-D array");
+
+        const n = D.size,
+              start = PhiloxRandomStreamPrivate_reserve(n),
+              r = D.dim(1),
+              key = philoxKey(seed);
+
+        // Fisher-Yates shuffle
+        for i in 0..#n by -1 {
+          const k = philoxBounded(D.idxType, this.eltType, key,
+                                  (start - 1 + n-1 - i):uint(64),
+                                  0:D.idxType, i:D.idxType);
+          arr[r.orderToIndex(i)] <=> arr[r.orderToIndex(k:int)];
+        }
+      }
+
+      /* Produce a random permutation, storing it in a 1-D array.
+         The resulting array will include each value from low..high
+         exactly once, where low and high refer to the array's domain.
+         */
+      proc permutation(arr: [] eltType) {
+        if arr.domain.rank != 1 then
+          compilerError("Permutation requires 1-D array");
+
+        forall (x, i) in zip(arr, arr.domain.dim(1).low..) do
+          x = i;
+        shuffle(arr);
+      }
+
+      /*
+
+         Returns an iterable expression for generating `D.numIndices` random
+         numbers. The RNG state will be immediately advanced by `D.numIndices`
+         before the iterable expression yields any values.
+
+         The returned iterable expression is useful in parallel contexts,
+         including standalone and zippered iteration. The domain will determine
+         the parallelization strategy.  Each follower computes its values
+         directly from their positions in the stream, a generator call at a
+         time.
+
+         :arg D: a domain
+         :arg resultType: the type of number to yield
+         :return: an iterable expression yielding random `resultType` values
+
+       */
+      pragma "fn returns iterator"
+      proc iterate(D: domain, type resultType=eltType) {
+        const start = PhiloxRandomStreamPrivate_reserve(D.numIndices);
+        return PhiloxRandomPrivate_iterate(resultType, eltType, D, seed,
+                                           start);
+      }
+
+      // Forward the leader iterator as well.
+      pragma "no doc"
+      pragma "fn returns iterator"
+      proc iterate(D: domain, type resultType=eltType, param tag)
+        where tag == iterKind.leader
+      {
+        // Note that proc iterate() for the serial case (i.e. the one above)
+        // is going to be invoked as well, so we should not be taking
+        // any actions here other than the forwarding.
+        const start = PhiloxRandomStreamPrivate_count;
+        return PhiloxRandomPrivate_iterate(resultType, eltType, D, seed,
+                                           start, tag);
+      }
+
+      pragma "no doc"
+      override proc writeThis(f) {
+        f <~> "PhiloxRandomStream(eltType=";
+        f <~> eltType:string;
+        f <~> ", parSafe=";
+        f <~> parSafe;
+        f <~> ", seed=";
+        f <~> seed;
+        f <~> ")";
+      }
+
+      ///////////////////////////////////////////////////////// CLASS PRIVATE //
+      //
+      // It is the intent that once Chapel supports the notion of
+      // 'private', everything in this class declared below this line will
+      // be made private to this class.
+      //
+
+      // Advance the stream past the next n values, which the caller will
+      // compute itself, and return the position of the first of them.
+      pragma "no doc"
+      proc PhiloxRandomStreamPrivate_reserve(n: integral): int(64) {
+        if parSafe then
+          PhiloxRandomStreamPrivate_lock$ = true;
+        const start = PhiloxRandomStreamPrivate_count;
+        PhiloxRandomStreamPrivate_count += n.safeCast(int(64));
+        if parSafe then
+          PhiloxRandomStreamPrivate_lock$;
+        return start;
+      }
+
+      pragma "no doc"
+      var PhiloxRandomStreamPrivate_lock$: sync bool;
+      pragma "no doc"
+      var PhiloxRandomStreamPrivate_count: int(64) = 1;
+    }
+
+
+    ////////////////////////////////////////////////////////// MODULE PRIVATE //
+    //
+    // It is the intent that once Chapel supports the notion of 'private',
+    // everything declared below this line will be made private to this
+    // module.
+    //
+
+    //
+    // Philox4x32 multipliers and Weyl sequence constants for the key
+    //
+    private param philoxM0 = 0xD2511F53:uint(32),
+                  philoxM1 = 0xCD9E8D57:uint(32),
+                  philoxW0 = 0x9E3779B9:uint(32),
+                  philoxW1 = 0xBB67AE85:uint(32);
+
+    private param philoxRounds = 10;
+
+    // How many 32-bit words does a value of this type use?
+    private proc numWords(type t) param {
+      if isBoolType(t) then return 1;
+      else return (numBits(t)+31) / 32;
+    }
+
+    private inline proc philoxKey(seed: int(64)) {
+      const useed = seed:uint(64);
+      return (useed:uint(32), (useed >> 32):uint(32));
+    }
+
+    //
+    // Philox4x32-10 bijection: each round multiplies two of the counter
+    // words, and mixes the high halves of the products with the other two
+    // words and the key.  There are no branches, so the compiler can
+    // schedule independent calls side by side.
+    //
+    pragma "no doc"
+    inline proc philox4x32(in ctr: 4*uint(32), in key: 2*uint(32)) {
+      for param r in 1..philoxRounds {
+        if r > 1 {
+          key(1) += philoxW0;
+          key(2) += philoxW1;
+        }
+        const p0 = philoxM0:uint(64) * ctr(1):uint(64),
+              p1 = philoxM1:uint(64) * ctr(3):uint(64);
+        ctr = ((p1 >> 32):uint(32) ^ ctr(2) ^ key(1), p1:uint(32),
+               (p0 >> 32):uint(32) ^ ctr(4) ^ key(2), p0:uint(32));
+      }
+      return ctr;
+    }
+
+    // The generator output that holds (0-based) value i of a stream of
+    // eltType.  'retry' selects the outputs used in place of rejected
+    // bounded values.
+    private inline proc philoxBlock(type eltType, key: 2*uint(32),
+                                    i: uint(64), retry: uint(32) = 0) {
+      param perBlock = 4 / numWords(eltType);
+      const b = if retry == 0 then i / perBlock else i;
+      return philox4x32((b:uint(32), (b >> 32):uint(32), retry,
+                         (retry != 0):uint(32)), key);
+    }
+
+    // The word of the block that value i of a stream of eltType starts at
+    private inline proc philoxLane(type eltType, i: uint(64)) {
+      param w = numWords(eltType);
+      return ((i % (4 / w)) * w):int + 1;
+    }
+
+    private inline proc words64(blk: 4*uint(32), lane: int): uint(64) {
+      return (blk(lane):uint(64) << 32) | blk(lane+1):uint(64);
+    }
+
+    // Random reals in [0, 1), using the top 53 (or 24) bits of x
+    private inline proc toReal64(x: uint(64)): real(64) {
+      return (x >> 11):real(64) * 0.5**53;
+    }
+    private inline proc toReal32(x: uint(32)): real(32) {
+      return (x >> 8):real(32) * (0.5**24):real(32);
+    }
+
+    // Convert the words of a block starting at lane into resultType
+    private inline proc fromBlock(type resultType, blk: 4*uint(32),
+                                  lane: int): resultType {
+      if resultType == complex(128) {
+        return (toReal64(words64(blk, lane)),
+                toReal64(words64(blk, lane+2))):complex(128);
+      } else if resultType == complex(64) {
+        return (toReal32(blk(lane)), toReal32(blk(lane+1))):complex(64);
+      } else if resultType == imag(64) {
+        return _r2i(toReal64(words64(blk, lane)));
+      } else if resultType == imag(32) {
+        return _r2i(toReal32(blk(lane)));
+      } else if resultType == real(64) {
+        return toReal64(words64(blk, lane));
+      } else if resultType == real(32) {
+        return toReal32(blk(lane));
+      } else if resultType == uint(64) || resultType == int(64) {
+        return words64(blk, lane):resultType;
+      } else if isBoolType(resultType) {
+        return (blk(lane) >> 31) != 0;
+      } else {
+        return (blk(lane) >> (32 - numBits(resultType))):resultType;
+      }
+    }
+
+    private proc checkResultType(type resultType, type eltType) {
+      if numWords(resultType) > numWords(eltType) then
+        compilerError("PhiloxRandomStream cannot produce " +
+                      resultType:string + " from a stream of " +
+                      eltType:string);
+    }
+
+    // Returns (0-based) value i of a stream of eltType, as resultType
+    pragma "no doc"
+    proc philoxValue(type resultType, type eltType, key: 2*uint(32),
+                     i: uint(64)): resultType {
+      checkResultType(resultType, eltType);
+      return fromBlock(resultType, philoxBlock(eltType, key, i),
+                       philoxLane(eltType, i));
+    }
+
+    // Returns an unsigned integer x with 0 <= x <= bound, unbiased, from
+    // value i of a stream of eltType.  Rejected values are replaced by
+    // outputs of the generator at counters that the rest of the stream does
+    // not use.
+    private proc boundedBits(type uintType, type eltType, key: 2*uint(32),
+                             i: uint(64), bound: uintType): uintType {
+      param w = if uintType == uint(64) then 2 else 1;
+      var blk = philoxBlock(eltType, key, i),
+          lane = philoxLane(eltType, i);
+      var x = if w == 2 then words64(blk, lane) else blk(lane);
+      if bound == max(uintType) then return x;
+
+      const range = bound + 1,
+            threshold = (0:uintType - range) % range;
+      var retry = 1:uint(32);
+      while x < threshold {
+        blk = philoxBlock(eltType, key, i, retry);
+        x = if w == 2 then words64(blk, 1) else blk(1);
+        retry += 1;
+      }
+      return x % range;
+    }
+
+    // Returns (0-based) value i of a stream of eltType, as a resultType
+    // in [min, max] for integers or [min, max) otherwise
+    pragma "no doc"
+    proc philoxBounded(type resultType, type eltType, key: 2*uint(32),
+                       i: uint(64), min: resultType,
+                       max: resultType): resultType {
+      checkResultType(resultType, eltType);
+      if isBoolType(resultType) {
+        compilerError("bounded rand with boolean type");
+      } else if isIntegralType(resultType) {
+        type uintType = if numBits(resultType) == 64 then uint(64)
+                        else uint(32);
+        if numWords(uintType) > numWords(eltType) then
+          compilerError("PhiloxRandomStream cannot produce bounded " +
+                        resultType:string + " from a stream of " +
+                        eltType:string);
+        type bitsType = uint(numBits(resultType));
+        const bound = (max:bitsType - min:bitsType):uintType;
+        return (boundedBits(uintType, eltType, key, i, bound) +
+                min:uintType):resultType;
+      } else if isComplexType(resultType) {
+        const x = philoxValue(resultType, eltType, key, i);
+        return ((max.re-min.re)*x.re + min.re,
+                (max.im-min.im)*x.im + min.im):resultType;
+      } else {
+        const x = philoxValue(resultType, eltType, key, i);
+        return (max-min)*x + min;
+      }
+    }
+
+    //
+    // iterate over outer ranges in tuple of ranges
+    //
+    private iter outer(ranges, param dim: int = 1) {
+      if dim + 1 == ranges.size {
+        for i in ranges(dim) do
+          yield (i,);
+      } else if dim + 1 < ranges.size {
+        for i in ranges(dim) do
+          for j in outer(ranges, dim+1) do
+            yield (i, (...j));
+      } else {
+        yield 0; // 1D case is a noop
+      }
+    }
+
+    //
+    // Yield n values of a stream of eltType, starting at (0-based) value
+    // first.  Each generator call covers several consecutive values.
+    //
+    private iter philoxValues(type resultType, type eltType,
+                              key: 2*uint(32), first: uint(64), n: int) {
+      param w = numWords(eltType);
+      var i = first,
+          lane = philoxLane(eltType, first);
+      var blk = philoxBlock(eltType, key, i);
+      for 1..n {
+        if lane > 4 {
+          blk = philoxBlock(eltType, key, i);
+          lane = 1;
+        }
+        yield fromBlock(resultType, blk, lane);
+        i += 1;
+        lane += w;
+      }
+    }
+
+    //
+    // PhiloxRandomStream iterator implementation
+    //
+    pragma "no doc"
+    iter PhiloxRandomPrivate_iterate(type resultType, type eltType,
+                                     D: domain, seed: int(64),
+                                     start: int(64)) {
+      checkResultType(resultType, eltType);
+      for x in philoxValues(resultType, eltType, philoxKey(seed),
+                            (start-1):uint(64), D.numIndices) do
+        yield x;
+    }
+
+    pragma "no doc"
+    iter PhiloxRandomPrivate_iterate(type resultType, type eltType,
+                                     D: domain, seed: int(64),
+                                     start: int(64), param tag: iterKind)
+          where tag == iterKind.leader {
+      for block in D.these(tag=iterKind.leader) do
+        yield block;
+    }
+
+    pragma "no doc"
+    iter PhiloxRandomPrivate_iterate(type resultType, type eltType,
+                                     D: domain, seed: int(64),
+                                     start: int(64), param tag: iterKind,
+                                     followThis)
+          where tag == iterKind.follower {
+      checkResultType(resultType, eltType);
+      const key = philoxKey(seed);
+      const ZD = computeZeroBasedDomain(D);
+      const innerRange = followThis(ZD.rank);
+      for outer in outer(followThis) {
+        var myStart = start - 1;
+        if ZD.rank > 1 then
+          myStart += ZD.indexOrder(((...outer), innerRange.low)).safeCast(int(64));
+        else
+          myStart += ZD.indexOrder(innerRange.low).safeCast(int(64));
+        if !innerRange.stridable {
+          for x in philoxValues(resultType, eltType, key,
+                                myStart:uint(64), innerRange.size) do
+            yield x;
+        } else {
+          myStart -= innerRange.low.safeCast(int(64));
+          for i in innerRange do
+            yield philoxValue(resultType, eltType, key,
+                              (myStart + i.safeCast(int(64))):uint(64));
+        }
+      }
+    }
+
+  } // close module PhiloxRandom
+
 
 
 } // close module Random
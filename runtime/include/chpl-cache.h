@@ -25,6 +25,49 @@
 #include "chpl-comm.h" // to get HAS_CHPL_CACHE_FNS via chpl-comm-task-decls.h
 #include "chpl-tasks.h"
 
+//
+// Remote data cache statistics for a node.  The counts are summed over
+// the node's caches (one per thread); the gauges describe their current
+// configuration.  These are available (and always zero) even when the
+// comm layer has no remote data cache.
+//
+#define CHPL_CACHE_STATS_COUNTS(MACRO) \
+  MACRO(get_hits) \
+  MACRO(get_misses) \
+  MACRO(get_ghost_hits) \
+  MACRO(prefetches) \
+  MACRO(readaheads) \
+  MACRO(readahead_hits) \
+  MACRO(readahead_unused) \
+  MACRO(evictions) \
+  MACRO(dirty_flushes)
+
+#define CHPL_CACHE_STATS_GAUGES(MACRO) \
+  MACRO(capacity_pages) \
+  MACRO(readahead_max_bytes)
+
+#define CHPL_CACHE_STATS_VARS_ALL(MACRO) \
+  CHPL_CACHE_STATS_COUNTS(MACRO) \
+  CHPL_CACHE_STATS_GAUGES(MACRO)
+
+typedef struct _chpl_cacheStats {
+#define _CACHE_STATS_DECL(csv) uint64_t csv;
+  CHPL_CACHE_STATS_VARS_ALL(_CACHE_STATS_DECL)
+#undef _CACHE_STATS_DECL
+} chpl_cacheStats;
+
+// Fill in *cs with this node's statistics, counting events since the last
+// call to chpl_cache_stats_reset_here().
+void chpl_cache_stats_get_here(chpl_cacheStats* cs);
+void chpl_cache_stats_reset_here(void);
+
+// Prefetch 'count' objects of 'size' bytes each, 'stride' bytes apart,
+// starting at 'raddr' on 'node', into the calling task's cache.  Does
+// nothing if the cache is not in use or the data is local.
+void chpl_cache_prefetch_strided(c_nodeid_t node, void* raddr,
+                                 size_t size, ptrdiff_t stride, size_t count,
+                                 int ln, int32_t fn);
+
 #ifdef HAS_CHPL_CACHE_FNS
 // This is a cache for remote data.
 
@@ -25,6 +25,19 @@
 
 #include "chpl-atomics.h"
 #include "chpl-comm.h"
+#include "chpl-thread-local-storage.h"
+
+//
+// Each thread counts the communication it initiates in its own set of
+// counters, so that counting doesn't make all the threads on a node
+// fight over the cache lines holding shared counters.  Only the owning
+// thread updates a set, and readers sum over all of them.
+//
+// When counting by source location is also turned on, each thread also
+// attributes its GETs, PUTs, and executeOns (and the bytes they move)
+// to the source line that initiated them, in a small hash table of its
+// own.  Those are merged when they're read, too.
+//
 
 typedef struct _chpl_atomic_commDiagnostics {
 #define _COMM_DIAGS_DECL_ATOMIC(cdv) atomic_uint_least64_t cdv;
@@ -32,32 +45,49 @@ typedef struct _chpl_atomic_commDiagnostics {
 #undef _COMM_DIAGS_DECL_ATOMIC
 } chpl_atomic_commDiagnostics;
 
-chpl_atomic_commDiagnostics chpl_comm_diags_counters;
-atomic_int_least16_t chpl_comm_diags_disable_flag;
+typedef enum {
+#define _COMM_DIAGS_KIND(cdv) chpl_comm_diags_kind_ ## cdv,
+  CHPL_COMM_DIAGS_VARS_ALL(_COMM_DIAGS_KIND)
+#undef _COMM_DIAGS_KIND
+  chpl_comm_diags_num_kinds
+} chpl_comm_diags_kind_t;
+
+struct chpl_comm_diags_src_table;
+
+typedef struct chpl_comm_diags_thread {
+  struct chpl_comm_diags_thread* next;
+  chpl_atomic_commDiagnostics counters;
+  struct chpl_comm_diags_src_table* src;
+} chpl_comm_diags_thread_t;
+
+extern CHPL_TLS_DECL(chpl_comm_diags_thread_t*, chpl_comm_diags_thread);
+extern atomic_int_least16_t chpl_comm_diags_disable_flag;
+extern int chpl_comm_diags_by_source;
+
+void chpl_comm_diags_init(void);
+void chpl_comm_diags_reset(void);
+void chpl_comm_diags_copy(chpl_commDiagnostics* cd);
+chpl_comm_diags_thread_t* chpl_comm_diags_thread_new(void);
+void chpl_comm_diags_src_record(chpl_comm_diags_thread_t* t,
+                                chpl_comm_diags_kind_t kind, size_t size,
+                                int32_t ln, int32_t fn);
 
 static inline
-void chpl_comm_diags_init(void) {
-#define _COMM_DIAGS_INIT(cdv) \
-        atomic_init_uint_least64_t(&chpl_comm_diags_counters.cdv, 0);
-  CHPL_COMM_DIAGS_VARS_ALL(_COMM_DIAGS_INIT);
-#undef _COMM_DIAGS_INIT
-  atomic_init_int_least16_t(&chpl_comm_diags_disable_flag, 0);
+chpl_comm_diags_thread_t* chpl_comm_diags_thread_here(void) {
+  chpl_comm_diags_thread_t* t =
+    (chpl_comm_diags_thread_t*) CHPL_TLS_GET(chpl_comm_diags_thread);
+  return (t == NULL) ? chpl_comm_diags_thread_new() : t;
 }
 
+//
+// Only the owning thread updates a counter, so it doesn't need an
+// atomic read-modify-write.
+//
 static inline
-void chpl_comm_diags_reset(void) {
-#define _COMM_DIAGS_RESET(cdv) \
-        atomic_store_uint_least64_t(&chpl_comm_diags_counters.cdv, 0);
- CHPL_COMM_DIAGS_VARS_ALL(_COMM_DIAGS_RESET);
-#undef _COMM_DIAGS_RESET
-}
-
-static inline
-void chpl_comm_diags_copy(chpl_commDiagnostics* cd) {
-#define _COMM_DIAGS_COPY(cdv) \
-        cd->cdv = atomic_load_uint_least64_t(&chpl_comm_diags_counters.cdv);
-  CHPL_COMM_DIAGS_VARS_ALL(_COMM_DIAGS_COPY);
-#undef _COMM_DIAGS_COPY
+void chpl_comm_diags_bump(atomic_uint_least64_t* ctr) {
+  atomic_store_explicit_uint_least64_t(ctr,
+    atomic_load_explicit_uint_least64_t(ctr, memory_order_relaxed) + 1,
+    memory_order_relaxed);
 }
 
 static inline
@@ -110,9 +140,34 @@ void chpl_comm_diags_verbose_printf(const char* format, ...) {
 #define chpl_comm_diags_incr(_ctr)                                      \
   do {                                                                  \
     if (chpl_comm_diagnostics && chpl_comm_diags_is_enabled()) {        \
-      atomic_uint_least64_t* ctrAddr = &chpl_comm_diags_counters._ctr;  \
-      (void) atomic_fetch_add_uint_least64_t(ctrAddr, 1);               \
+      chpl_comm_diags_thread_t* _t = chpl_comm_diags_thread_here();     \
+      chpl_comm_diags_bump(&_t->counters._ctr);                         \
     }                                                                   \
   } while(0)
 
+//
+// Like chpl_comm_diags_incr(), but for operations that can also be
+// attributed to a source location.
+//
+#define chpl_comm_diags_incr_src(_ctr, size, ln, fn)                    \
+  do {                                                                  \
+    if (chpl_comm_diagnostics && chpl_comm_diags_is_enabled()) {        \
+      chpl_comm_diags_thread_t* _t = chpl_comm_diags_thread_here();     \
+      chpl_comm_diags_bump(&_t->counters._ctr);                         \
+      if (chpl_comm_diags_by_source)                                    \
+        chpl_comm_diags_src_record(_t, chpl_comm_diags_kind_ ## _ctr,   \
+                                   size, ln, fn);                       \
+    }                                                                   \
+  } while(0)
+
+static inline
+size_t chpl_comm_diags_strd_bytes(size_t* count, int32_t strlevels,
+                                  size_t elemSize) {
+  size_t bytes = elemSize;
+  int32_t i;
+  for (i = 0; i <= strlevels; i++)
+    bytes *= count[i];
+  return bytes;
+}
+
 #endif
@@ -0,0 +1,168 @@
+/*
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _chpl_comm_unordered_h_
+#define _chpl_comm_unordered_h_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "chpltypes.h"
+#include "chpl-comm-impl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//
+// Unordered operations.
+//
+// Unordered GETs, PUTs, and atomic updates may be buffered by the
+// runtime and so may complete in any order with respect to each other
+// and to other communication.  They are only guaranteed to be complete
+// after a fence.  chpl_comm_*_unordered_fence() completes those begun
+// by any task on this node, and chpl_comm_*_unordered_task_fence()
+// completes those begun by the calling task.
+//
+// The comm layers share a portable implementation of these, in
+// chpl-comm-unordered.c.  It gives each thread a window of outstanding
+// non-blocking GETs and PUTs, and per-node buffers of atomic updates
+// that are shipped to their target node in a single message when
+// they fill up or are fenced.  A comm layer that has a native version
+// of the unordered GET (ugni) defines CHPL_COMM_IMPL_UNORDERED_GET in
+// its chpl-comm-impl.h and supplies that instead.
+// CHPL_RT_COMM_UNORDERED_AMO_BUFF_SIZE sets how many atomic updates a
+// thread buffers for one node (default 256, capped by what fits in one
+// message).
+//
+
+void chpl_comm_unordered_init(void);
+
+void chpl_comm_get_unordered(void* addr, c_nodeid_t node, void* raddr,
+                             size_t size, int32_t typeIndex, int32_t commID,
+                             int ln, int32_t fn);
+void chpl_comm_get_unordered_fence(void);
+void chpl_comm_get_unordered_task_fence(void);
+
+// The source data is copied before this returns, so the caller may
+// reuse it right away.
+void chpl_comm_put_unordered(void* addr, c_nodeid_t node, void* raddr,
+                             size_t size, int32_t typeIndex, int32_t commID,
+                             int ln, int32_t fn);
+void chpl_comm_put_unordered_fence(void);
+void chpl_comm_put_unordered_task_fence(void);
+
+//
+// Unordered non-fetching updates of processor atomics (that is, when
+// CHPL_NETWORK_ATOMICS=none).  The target is *object on the given node
+// and the operand is *operand on this one.  These aren't available
+// with a comm layer that defines CHPL_COMM_IMPL_UNORDERED_GET, since
+// such a layer does remote atomics its own way.
+//
+#ifndef CHPL_COMM_IMPL_UNORDERED_GET
+
+#define DECL_CHPL_COMM_PROC_ATOMIC_UNORDERED(op, type)                  \
+  void chpl_comm_proc_atomic_ ## op ## _unordered_ ## type              \
+         (void* operand, c_nodeid_t node, void* object,                 \
+          int ln, int32_t fn);
+
+#define DECL_CHPL_COMM_PROC_ATOMIC_UNORDERED_INT(op)                    \
+  DECL_CHPL_COMM_PROC_ATOMIC_UNORDERED(op, int32)                       \
+  DECL_CHPL_COMM_PROC_ATOMIC_UNORDERED(op, int64)                       \
+  DECL_CHPL_COMM_PROC_ATOMIC_UNORDERED(op, uint32)                      \
+  DECL_CHPL_COMM_PROC_ATOMIC_UNORDERED(op, uint64)
+
+DECL_CHPL_COMM_PROC_ATOMIC_UNORDERED_INT(and)
+DECL_CHPL_COMM_PROC_ATOMIC_UNORDERED_INT(or)
+DECL_CHPL_COMM_PROC_ATOMIC_UNORDERED_INT(xor)
+DECL_CHPL_COMM_PROC_ATOMIC_UNORDERED_INT(add)
+DECL_CHPL_COMM_PROC_ATOMIC_UNORDERED_INT(sub)
+DECL_CHPL_COMM_PROC_ATOMIC_UNORDERED(add, real32)
+DECL_CHPL_COMM_PROC_ATOMIC_UNORDERED(add, real64)
+DECL_CHPL_COMM_PROC_ATOMIC_UNORDERED(sub, real32)
+DECL_CHPL_COMM_PROC_ATOMIC_UNORDERED(sub, real64)
+
+#undef DECL_CHPL_COMM_PROC_ATOMIC_UNORDERED_INT
+#undef DECL_CHPL_COMM_PROC_ATOMIC_UNORDERED
+
+void chpl_comm_proc_atomic_unordered_fence(void);
+void chpl_comm_proc_atomic_unordered_task_fence(void);
+
+//
+// A buffered atomic update, as shipped to its target node.
+//
+typedef enum {
+  chpl_comm_amo_and,
+  chpl_comm_amo_or,
+  chpl_comm_amo_xor,
+  chpl_comm_amo_add
+} chpl_comm_amo_op_t;
+
+typedef enum {
+  chpl_comm_amo_int32,
+  chpl_comm_amo_int64,
+  chpl_comm_amo_uint32,
+  chpl_comm_amo_uint64,
+  chpl_comm_amo_real32,
+  chpl_comm_amo_real64
+} chpl_comm_amo_type_t;
+
+typedef struct {
+  void* object;
+  union {
+    int32_t  i32;
+    int64_t  i64;
+    uint32_t u32;
+    uint64_t u64;
+    float    r32;
+    double   r64;
+  } operand;
+  uint8_t op;    // chpl_comm_amo_op_t
+  uint8_t type;  // chpl_comm_amo_type_t
+} chpl_comm_amo_unordered_t;
+
+//
+// Apply n buffered updates whose targets are on this node.  Comm
+// layers call this when a batch arrives; it may be called from an AM
+// handler, since it only does processor atomic operations.
+//
+void chpl_comm_amo_unordered_apply(chpl_comm_amo_unordered_t* v, size_t n);
+
+//
+// Supplied by the comm layer: apply n buffered updates on the given
+// (remote) node, returning once they are done.  The layer may send the
+// whole buffer in one message if it fits in chpl_comm_impl_amo_max_batch()
+// updates, which the caller guarantees n does not exceed.
+//
+void chpl_comm_impl_amo_unordered_send(c_nodeid_t node,
+                                       chpl_comm_amo_unordered_t* v, size_t n);
+size_t chpl_comm_impl_amo_max_batch(void);
+
+#endif // CHPL_COMM_IMPL_UNORDERED_GET
+
+//
+// Complete all of the calling task's unordered operations of any kind.
+// This is called at the end of every forall loop and every task.
+//
+void chpl_comm_unordered_task_fence(void);
+
+#ifdef __cplusplus
+} // end extern "C"
+#endif
+
+#endif // _chpl_comm_unordered_h_
@@ -26,6 +26,7 @@
 #include "chplsys.h"
 #include "chpltypes.h"
 #include "chpl-comm-impl.h"
+#include "chpl-comm-unordered.h"
 #include "chpl-comm-heap-macros.h"
 #include "chpl-tasks.h"
 #include "chpl-comm-task-decls.h"
@@ -104,6 +105,18 @@ chpl_task_bundle_t* chpl_comm_on_bundle_task_bundle(chpl_comm_on_bundle_t* a)
   return &a->task_bundle;
 }
 
+//
+// Record the source location of an executeOn in its bundle, so that
+// the comm layer can attribute it there.
+//
+static inline
+void chpl_comm_on_bundle_set_lineinfo(chpl_comm_on_bundle_t* a,
+                                      int lineno, int32_t filename)
+{
+  a->task_bundle.lineno = lineno;
+  a->task_bundle.filename = filename;
+}
+
 //
 // Call a chpl_ftable[] function in a task.
 //
@@ -533,6 +546,26 @@ void chpl_gen_stopCommDiagnosticsHere(void);
 void chpl_resetCommDiagnosticsHere(void);
 void chpl_getCommDiagnosticsHere(chpl_commDiagnostics *cd);
 
+//
+// Communication counts attributed to one source location.  'kind' is
+// the index of the corresponding counter in chpl_commDiagnostics.  An
+// entry with lineno -1 holds whatever couldn't be attributed because a
+// thread's table was full.
+//
+typedef struct _chpl_commDiagsSource {
+  int32_t lineno;
+  int32_t filename;
+  int32_t kind;
+  uint64_t count;
+  uint64_t bytes;
+} chpl_commDiagsSource;
+
+void chpl_setCommDiagnosticsBySourceHere(chpl_bool on);
+
+// Returns the number of entries in *entries, which the caller must
+// free with chpl_mem_free().
+size_t chpl_getCommDiagnosticsBySourceHere(chpl_commDiagsSource** entries);
+
 void* chpl_get_global_serialize_table(int64_t idx);
 
 #else // LAUNCHER
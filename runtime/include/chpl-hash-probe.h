@@ -0,0 +1,84 @@
+/*
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ * 
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ * 
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// Support for hash tables that locate slots by probing groups of one-byte
+// control words (one per slot) at a time, as done by the default
+// associative domain.  A group is CHPL_HASH_PROBE_GROUP_SIZE consecutive
+// control bytes; the functions below compare all of them against a value
+// at once using SSE2 where available and a portable loop otherwise.
+//
+// Tables that are updated concurrently claim a slot by changing its
+// control byte with chpl_hash_probe_claim() and, once the slot's contents
+// are written, make it visible with chpl_hash_probe_publish().  The acquire
+// fence in chpl_hash_probe_match() pairs with the release in the latter.
+//
+
+#ifndef _chpl_hash_probe_h_
+#define _chpl_hash_probe_h_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#if defined(__SSE2__) && !defined(CHPL_HASH_PROBE_C)
+#include <emmintrin.h>
+#define CHPL_HASH_PROBE_SSE2 1
+#endif
+
+#define CHPL_HASH_PROBE_GROUP_SIZE 16
+
+//
+// Returns a mask with bit i set if group[i] == ctrl, for each of the
+// CHPL_HASH_PROBE_GROUP_SIZE bytes of the group.
+//
+static inline uint32_t chpl_hash_probe_match(const uint8_t* group,
+                                             uint8_t ctrl) {
+#ifdef CHPL_HASH_PROBE_SSE2
+  __m128i g = _mm_loadu_si128((const __m128i*) group);
+  __m128i c = _mm_set1_epi8((char) ctrl);
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  return (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(g, c));
+#else
+  uint32_t mask = 0;
+  int i;
+  for (i = 0; i < CHPL_HASH_PROBE_GROUP_SIZE; i++)
+    mask |= (uint32_t) (group[i] == ctrl) << i;
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  return mask;
+#endif
+}
+
+//
+// Atomically changes *ctrl from 'expected' to 'desired', returning whether
+// it did so.
+//
+static inline bool chpl_hash_probe_claim(uint8_t* ctrl,
+                                         uint8_t expected, uint8_t desired) {
+  return __atomic_compare_exchange_n(ctrl, &expected, desired, false,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+}
+
+//
+// Stores 'value' to *ctrl, ordered after all earlier writes to the slot.
+//
+static inline void chpl_hash_probe_publish(uint8_t* ctrl, uint8_t value) {
+  __atomic_store_n(ctrl, value, __ATOMIC_RELEASE);
+}
+
+#endif // _chpl_hash_probe_h_
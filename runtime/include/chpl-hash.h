@@ -0,0 +1,71 @@
+/*
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ * 
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ * 
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// Hash functions for the default hashes of strings, records, and tuples.
+//
+// chpl_hash_bytes() hashes a buffer 8 or 16 bytes at a time with a
+// multiply-and-fold mix in the style of wyhash, keeping three independent
+// lanes going for long inputs.  chpl_hash_combine() merges the hash of a
+// record or tuple field into the hash of the fields before it; unlike an
+// xor of rotations, its result depends on every bit of both inputs, so
+// records whose fields differ slightly don't collide or cluster.
+//
+
+#ifndef _chpl_hash_h_
+#define _chpl_hash_h_
+
+#include <stdint.h>
+
+#define CHPL_HASH_SECRET0 UINT64_C(0xa0761d6478bd642f)
+#define CHPL_HASH_SECRET1 UINT64_C(0xe7037ed1a0b428db)
+#define CHPL_HASH_SECRET2 UINT64_C(0x8ebc6af09c88c6e3)
+#define CHPL_HASH_SECRET3 UINT64_C(0x589965cc75374cc3)
+
+//
+// Returns the high and low halves of the 128-bit product of a and b,
+// xor'ed together.
+//
+static inline uint64_t chpl_hash_mix(uint64_t a, uint64_t b) {
+#ifdef __SIZEOF_INT128__
+  __uint128_t r = (__uint128_t) a * b;
+  return (uint64_t) r ^ (uint64_t) (r >> 64);
+#else
+  uint64_t ha = a >> 32, hb = b >> 32, la = (uint32_t) a, lb = (uint32_t) b;
+  uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+  uint64_t t = rl + (rm0 << 32);
+  uint64_t lo = t + (rm1 << 32);
+  uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + (t < rl) + (lo < t);
+  return lo ^ hi;
+#endif
+}
+
+uint64_t chpl_hash_bytes(const void* key, int64_t len, uint64_t seed);
+
+//
+// Combines the hash 'h' of field number 'fieldnum' with the hash 'acc'
+// of the preceding fields.
+//
+static inline uint64_t chpl_hash_combine(uint64_t h, uint64_t acc,
+                                         int64_t fieldnum) {
+  return chpl_hash_mix(h ^ CHPL_HASH_SECRET1,
+                       acc ^ (CHPL_HASH_SECRET0 + (uint64_t) fieldnum));
+}
+
+#endif // _chpl_hash_h_
@@ -44,4 +44,18 @@ typedef struct chpl__inPlaceBuffer_t {
 uint8_t* chpl__getInPlaceBufferData(chpl__inPlaceBuffer* buf);
 uint8_t* chpl__getInPlaceBufferDataForWrite(chpl__inPlaceBuffer* buf);
 
+//
+// Byte string search, for string.find() and friends.  These return the
+// 0-based offset of the first (or for rfind, last) occurrence of the
+// needle in the haystack, or -1 if there is none.  chpl_bytes_count()
+// counts occurrences, including overlapping ones.  The needle must not
+// be empty.
+//
+int64_t chpl_bytes_find(const uint8_t* hay, int64_t hayLen,
+                        const uint8_t* needle, int64_t needleLen);
+int64_t chpl_bytes_rfind(const uint8_t* hay, int64_t hayLen,
+                         const uint8_t* needle, int64_t needleLen);
+int64_t chpl_bytes_count(const uint8_t* hay, int64_t hayLen,
+                         const uint8_t* needle, int64_t needleLen);
+
 #endif
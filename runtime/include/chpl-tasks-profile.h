@@ -0,0 +1,72 @@
+/*
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _chpl_tasks_profile_h_
+#define _chpl_tasks_profile_h_
+
+#include <stdint.h>
+#include <time.h>
+#include "chpltypes.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//
+// Task profiling.
+//
+// When the CHPL_RT_TASK_PROFILE environment variable is set to a file
+// name root, each locale records when every task on it was created,
+// began, and ended, on which thread it ran, and how long it waited on
+// sync variables.  The tasking callbacks supply the task events, and
+// the tasking layers report sync variable waits directly.  Events go
+// into per-thread ring buffers that only their own thread writes, so
+// recording takes no locks.  At exit each locale writes its events to
+// '<root>-<nodeID>.json' in the Chrome trace event format, which can be
+// viewed with chrome://tracing or Perfetto.
+//
+// CHPL_RT_TASK_PROFILE_EVENTS sets the number of events each thread
+// keeps (default 65536).  If a thread records more than that, its
+// oldest events are lost and the trace says how many.
+//
+
+extern chpl_bool chpl_task_profiling;
+
+void chpl_task_profile_init(void);
+void chpl_task_profile_exit(void);
+
+static inline
+uint64_t chpl_task_profile_now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+//
+// Record that the current task waited on a sync variable from time
+// 'start' (as returned by chpl_task_profile_now()) until now.
+//
+void chpl_task_profile_sync_wait(uint64_t start,
+                                 int32_t lineno, int32_t filename);
+
+#ifdef __cplusplus
+} // end extern "C"
+#endif
+
+#endif // _chpl_tasks_profile_h_
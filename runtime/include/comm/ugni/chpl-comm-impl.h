@@ -59,14 +59,10 @@ chpl_bool chpl_comm_impl_regMemFree(void* p, size_t size);
 #include "chpl-comm-native-atomics.h"
 
 //
-// Unordered ops
+// Unordered ops: we have our own unordered GETs (declared in
+// chpl-comm-unordered.h) and atomics, using chained transactions.
 //
-void chpl_comm_get_unordered(void *addr, c_nodeid_t node, void* raddr,
-                             size_t size, int32_t typeIndex, int32_t commID,
-                             int ln, int32_t fn);
-
-void chpl_comm_get_unordered_fence(void);
-void chpl_comm_get_unordered_task_fence(void);
+#define CHPL_COMM_IMPL_UNORDERED_GET
 
 //
 // Internal statistics gathering and reporting.
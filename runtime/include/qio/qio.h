@@ -827,6 +827,11 @@ typedef struct qio_channel_s {
   // for the common case of very few marks.
   int64_t mark_space[MARK_INITIAL_STACK_SZ];
 
+  // For records that qio_channel_begin_peek_record() can't return in place.
+  uint8_t* record_scratch;
+  int64_t record_scratch_size;
+  int64_t record_gen; // count of begin_peek_record() calls
+
   qio_style_t style;
 } qio_channel_t;
 
@@ -1271,6 +1276,31 @@ qioerr qio_channel_end_peek_cached(const int threadsafe, qio_channel_t* ch, void
 
 qioerr qio_channel_advance_past_byte(const int threadsafe, qio_channel_t* ch, int byte);
 
+/* Find the next record in a read channel -- the bytes up to and including
+ * the next 'separator', or up to the end of the input -- and advance past
+ * it.  On return *ptr_out points to the record and *len_out is its length.
+ * When the whole record is in one part of the channel's buffer (always the
+ * case for a file that has been mmap'd), *ptr_out points into the buffer
+ * itself.  Otherwise the record is copied into scratch space that belongs
+ * to the channel and is reused for later records.  Returns EEOF if there
+ * is no more input.  No other channel calls may be made until
+ * qio_channel_end_peek_record(), and the record is only valid until the
+ * next call that reads from the channel.  You don't have to call
+ * end_peek_record if this returns an error.
+ */
+qioerr qio_channel_begin_peek_record(const int threadsafe, qio_channel_t* ch, int separator, uint8_t** ptr_out, int64_t* len_out);
+
+/* Return how many times qio_channel_begin_peek_record() has been called,
+ * so a caller can tell whether a record it was given is still current.
+ */
+static inline
+int64_t qio_channel_record_gen(qio_channel_t* ch)
+{
+  return ch->record_gen;
+}
+
+qioerr qio_channel_end_peek_record(const int threadsafe, qio_channel_t* ch);
+
 qioerr qio_channel_begin_peek_buffer(const int threadsafe, qio_channel_t* ch, int64_t require, int writing, qbuffer_t** buf_out, qbuffer_iter_t* start_out, qbuffer_iter_t* end_out);
 
 qioerr qio_channel_end_peek_buffer(const int threadsafe, qio_channel_t* ch, int64_t advance);
@@ -48,6 +48,8 @@
 #include "chpl-file-utils.h"
 #include <chplfp.h>
 #include "chplglob.h"
+#include "chpl-hash.h"
+#include "chpl-hash-probe.h"
 #include "chplio.h"
 #include "chplmath.h"
 #include "chpl-init.h"
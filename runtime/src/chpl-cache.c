@@ -244,6 +244,46 @@ the sequence number of the last acquire barrier. If a task performs a GET but
 finds a cache entry with a minimum sequence number before its last acquire
 barrier, it must invalidate that cache line and do a new GET.
 
+== Adaptive Sizing and Statistics ==
+
+With CHPL_RT_CACHE_ADAPTIVE set, each cache allocates room for more pages
+than it starts out using, and every ADAPTIVE_WINDOW gets it reconsiders how
+many pages to use and how far to read ahead. Misses on pages that are still
+recorded in Aout ("ghost hits") would have been hits in a larger cache, so
+when they are common the cache grows. When most gets miss but few are ghost
+hits, data is not being reused and the cache shrinks. Sequential readahead
+grows while the pages it brings in are mostly read and shrinks when they
+are mostly evicted unread or when many operations are pending.
+
+Each cache counts hits, misses, readahead outcomes, evictions, and
+write-behind PUTs; chpl_cache_stats_get_here() sums them over the node.
+
+== Strided and Gather Prefetching ==
+
+Sequential readahead does nothing for a task that reads, say, a column of
+a row-major array, or the same few neighbors of each element in a stencil.
+To handle these, each cache also remembers the distances between the last
+few GETs of up to PATTERN_STREAMS streams. A single loop usually mixes
+several streams, e.g. the array elements it is after with GETs of the
+array's metadata and of the variables it updates, so a GET joins the
+stream whose pattern predicted it, or else the closest stream (within
+PATTERN_REGION_SIZE bytes) of GETs from the same source line on the same
+node. A GET that fits no stream starts a new one in place of the least
+recently used. When the latest PATTERN_MAX_PERIOD or fewer distances in
+a stream repeat (a constant stride is a period of 1) and at least one of
+them skips over a cache line, the cache predicts the stream's next
+accesses by continuing the pattern and prefetches PATTERN_PREFETCH_ITERS
+repetitions ahead. Each prediction that comes true lets it prefetch one
+more; the first GET in the stream that breaks the pattern stops it until
+a pattern is seen again. Since the cache is per-thread and tasks do not
+migrate between threads, this tracks each task's streams as long as it
+runs alone on its thread. Predictions are only prefetched from memory
+that chpl_comm_addr_gettable() says is safe to read, so there is no
+pattern prefetching when the comm layer has no segment information.
+
+chpl_cache_prefetch_strided() lets a program request the same kind of
+prefetch directly when it knows its access pattern in advance.
+
 Lastly, since the implementation uses thread-local storage for the cache, it
 requires that tasks not move between threads. Tasks could move between threads
 if we had a way to notify the cache that they were about to do so (in which
@@ -279,12 +319,14 @@ use.
 #include "chpl-atomics.h"
 #include "chpl-thread-local-storage.h" // CHPL_TLS_DECL etc
 #include "chpl-cache.h"
+#include "chpl-env.h"
 #include "chpl-linefile-support.h"
 #include "sys.h" // sys_page_size()
 #include "chpl-comm-compiler-macros.h"
 #include "chpl-comm-no-warning-macros.h" // No warnings for chpl_comm_get etc.
 #include <string.h> // memcpy, memset, etc.
 #include <assert.h>
+#include <pthread.h>
 
 
 #ifdef HAS_CHPL_CACHE_FNS
@@ -333,6 +375,7 @@ typedef int16_t readahead_distance_t;
 // When prefetching, what is the maximum number of pages
 // we are willing to prefetch? This is also the maximum
 // readahead window size for sequential access.
+// (Adaptive caches change these limits at runtime.)
 #define MAX_PAGES_PER_PREFETCH 2
 
 // Should we enable sequential readahead?
@@ -342,6 +385,22 @@ typedef int16_t readahead_distance_t;
 #define ENABLE_READAHEAD_TRIGGER_SEQUENTIAL 0
 #define MAX_SEQUENTIAL_READAHEAD_BYTES (MAX_PAGES_PER_PREFETCH*CACHEPAGE_SIZE)
 
+// Adaptive caches can use up to ADAPTIVE_MAX_GROWTH times as many pages as
+// they start with and read ahead up to ADAPTIVE_MAX_READAHEAD_PAGES.
+// They adapt after every ADAPTIVE_WINDOW gets.
+#define ADAPTIVE_MAX_GROWTH 4
+#define ADAPTIVE_MAX_READAHEAD_PAGES 8
+#define ADAPTIVE_WINDOW 1024
+
+// Should GETs that follow a repeating pattern of distances trigger
+// prefetching? See "Strided and Gather Prefetching" above.
+#define ENABLE_PATTERN_PREFETCH 1
+#define PATTERN_MAX_PERIOD 4
+#define PATTERN_HISTORY (2*PATTERN_MAX_PERIOD)
+#define PATTERN_PREFETCH_ITERS 4
+#define PATTERN_STREAMS 8
+#define PATTERN_REGION_SIZE (1024*1024)
+
 //#define TIME
 //#define TRACE
 //#define DEBUG
@@ -502,6 +561,8 @@ struct cache_entry_s {
   // Readahead information.
   readahead_distance_t readahead_skip;
   readahead_distance_t readahead_len; // == 0 if this page doesn't trigger readahead.
+  // Set when readahead filled this page and no get has used it yet.
+  int8_t readahead_unread;
   // These are the queue links. Am is LRU but Ain and Aout are FIFO
   struct cache_entry_s* next; // next entry in Ain/Aout/Am
   struct cache_entry_s* prev; // previous entry in An/Aout/Am
@@ -568,6 +629,40 @@ struct top_entry_s {
   struct cache_entry_s* bottom_index[BOTTOM_SIZE];
 };
 
+// Event counters and gauges for one cache. Only the thread that owns the
+// cache updates them, but chpl_cache_stats_get_here() reads them from
+// other threads.
+typedef struct {
+#define _CACHE_STATS_DECL_ATOMIC(csv) atomic_uint_least64_t csv;
+  CHPL_CACHE_STATS_VARS_ALL(_CACHE_STATS_DECL_ATOMIC)
+#undef _CACHE_STATS_DECL_ATOMIC
+} cache_stats_t;
+
+#define CACHE_STATS_SET(cache, csv, val) \
+  atomic_store_explicit_uint_least64_t(&(cache)->stats.csv, (val), \
+                                       memory_order_relaxed)
+
+#define CACHE_STATS_GET(cache, csv) \
+  atomic_load_explicit_uint_least64_t(&(cache)->stats.csv, \
+                                      memory_order_relaxed)
+
+#define CACHE_STATS_INCR(cache, csv) \
+  CACHE_STATS_SET(cache, csv, CACHE_STATS_GET(cache, csv) + 1)
+
+// A stream of GETs for strided and gather prefetching.  deltas[0] is the
+// most recent distance between GETs in the stream.
+struct pattern_stream_s {
+  c_nodeid_t node; // -1 if unused
+  int ln;
+  int32_t fn;
+  raddr_t last_addr;
+  intptr_t deltas[PATTERN_HISTORY];
+  int ndeltas;
+  int period; // 0 if the recent distances don't repeat
+  int ahead; // how many predicted GETs have been prefetched
+  uint64_t last_use;
+};
+
 struct rdcache_s {
   // A 2Q cache.
   // See "2Q: A Low Overhead High Performance Buffer Management
@@ -585,6 +680,11 @@ struct rdcache_s {
   c_nodeid_t last_cache_miss_read_node;
   raddr_t last_cache_miss_read_addr;
 
+  // The distances between recent GETs in each stream, to enable strided
+  // and gather prefetching. pattern_clock orders the streams' last uses.
+  struct pattern_stream_s pattern_streams[PATTERN_STREAMS];
+  uint64_t pattern_clock;
+
   // The variable names Ain Aout and Am come from the 2Q paper
 
   // Ain is a FIFO queue storing entries initially as they go into
@@ -666,12 +766,54 @@ struct rdcache_s {
   int max_top_entries;
   struct cache_entry_base_s* free_top_nodes_head; // a linked list.
 
+  // How many of the max_pages can hold data at once, and how many do.
+  // page_limit is max_pages unless the cache is adaptive.
+  int adaptive;
+  int min_page_limit;
+  int page_limit;
+  int pages_in_use;
+
+  // Sequential readahead extends up to readahead_max_bytes, and a
+  // prefetch brings in at most prefetch_max_pages.
+  int readahead_max_bytes;
+  int prefetch_max_pages;
+
+  // Events during the current adaptation window.
+  unsigned int window_gets;
+  unsigned int window_misses;
+  unsigned int window_ghost_hits;
+  unsigned int window_readahead_hits;
+  unsigned int window_readahead_unused;
+
+  cache_stats_t stats;
+
+  // All of the caches on this node, for summing statistics.
+  struct rdcache_s* next_cache;
+  struct rdcache_s* prev_cache;
+
   // The entry into the 'pointer tree' hashtable structure.
   struct top_entry_s* top_index_list[TOP_SIZE];
 };
 
 static void validate_cache(struct rdcache_s* tree);
 
+// Set with CHPL_RT_CACHE_ADAPTIVE
+static int cache_adaptive = 0;
+
+// Limit the number of pages holding data to 'limit', scaling the 2Q
+// queues to match. If this shrinks the cache, pages are evicted the next
+// time one is needed.
+static
+void cache_set_page_limit(struct rdcache_s* cache, int limit)
+{
+  cache->page_limit = limit;
+  cache->ain_max = limit / 4; // 2Q: "Kin should be 25% of page slots"
+  cache->aout_max = limit / 2; // 2Q: "Kout should hold identifiers for as
+                               // many pages as would fit in 50% of the
+                               // buffer"
+  CACHE_STATS_SET(cache, capacity_pages, limit);
+}
+
 
 static
 struct rdcache_s* cache_create(void) {
@@ -690,9 +832,10 @@ struct rdcache_s* cache_create(void) {
 
   size_t total_size = 0;
   size_t allocated_size = 0;
-  unsigned int pending_len = MAX_PENDING; 
+  unsigned int pending_len = MAX_PENDING;
   unsigned char* buffer;
   unsigned char* pages;
+  int start_pages;
 
   cache_pages = CACHE_PAGES_PER_NODE * chpl_numNodes;
   if( cache_pages < MIN_CACHE_DATA_SIZE/CACHEPAGE_SIZE )
@@ -700,6 +843,16 @@ struct rdcache_s* cache_create(void) {
   if( cache_pages > MAX_CACHE_DATA_SIZE/CACHEPAGE_SIZE )
     cache_pages = MAX_CACHE_DATA_SIZE/CACHEPAGE_SIZE;
 
+  // An adaptive cache starts out using cache_pages pages but allocates
+  // room to grow. Pages it has never used are never touched, so they
+  // don't take up physical memory.
+  start_pages = cache_pages;
+  if( cache_adaptive ) {
+    cache_pages *= ADAPTIVE_MAX_GROWTH;
+    if( cache_pages > MAX_CACHE_DATA_SIZE/CACHEPAGE_SIZE )
+      cache_pages = MAX_CACHE_DATA_SIZE/CACHEPAGE_SIZE;
+  }
+
   ain_pages = cache_pages / 4; // 2Q: "Kin should be 25% of page slots"
   aout_pages = cache_pages / 2; // 2Q: "Kout should hold identifiers for as
                                 // many pages as would fit in 50% of the
@@ -766,6 +919,11 @@ struct rdcache_s* cache_create(void) {
 
   c->last_cache_miss_read_node = -1;
   c->last_cache_miss_read_addr = 0;
+  for( i = 0; i < PATTERN_STREAMS; i++ ) {
+    c->pattern_streams[i].node = -1;
+    c->pattern_streams[i].last_use = 0;
+  }
+  c->pattern_clock = 0;
 
   c->max_pages = cache_pages;
   c->max_entries = n_entries;
@@ -796,6 +954,23 @@ struct rdcache_s* cache_create(void) {
   }
 
 
+  c->adaptive = cache_adaptive;
+  c->min_page_limit = start_pages;
+  c->pages_in_use = 0;
+  c->readahead_max_bytes = MAX_SEQUENTIAL_READAHEAD_BYTES;
+  c->prefetch_max_pages = MAX_PAGES_PER_PREFETCH;
+  c->window_gets = 0;
+  c->window_misses = 0;
+  c->window_ghost_hits = 0;
+  c->window_readahead_hits = 0;
+  c->window_readahead_unused = 0;
+#define _CACHE_STATS_INIT(csv) atomic_init_uint_least64_t(&c->stats.csv, 0);
+  CHPL_CACHE_STATS_VARS_ALL(_CACHE_STATS_INIT)
+#undef _CACHE_STATS_INIT
+  CACHE_STATS_SET(c, readahead_max_bytes, c->readahead_max_bytes);
+  c->next_cache = NULL;
+  c->prev_cache = NULL;
+
   c->ain_max = ain_pages;
   c->ain_current = 0;
   c->ain_head = NULL;
@@ -849,6 +1024,9 @@ struct rdcache_s* cache_create(void) {
   // clear top_index_list.
   memset(&c->top_index_list[0], 0, sizeof(struct top_entry_s*) * TOP_SIZE);
 
+  // sets ain_max and aout_max again, for the starting size
+  cache_set_page_limit(c, start_pages);
+
   if( VERIFY ) validate_cache(c);
 
   return c;
@@ -1168,6 +1346,7 @@ void ain_evict(struct rdcache_s* cache, struct cache_entry_s* dont_evict_me)
   // immediately wait for them to complete, before we modify the contents
   // of Ain in any way (or reuse the associated page).
   flush_entry(cache, y, FLUSH_EVICT, 0, CACHEPAGE_SIZE);
+  CACHE_STATS_INCR(cache, evictions);
 
   DOUBLE_REMOVE_TAIL(cache, ain);
   cache->ain_current--;
@@ -1206,6 +1385,7 @@ void am_evict(struct rdcache_s *cache, struct cache_entry_s* dont_evict_me) {
   // immediately wait for them to complete, before we modify the contents
   // of Ain in any way (or reuse the associated page).
   flush_entry(cache, y, FLUSH_EVICT, 0, CACHEPAGE_SIZE);
+  CACHE_STATS_INCR(cache, evictions);
 
   DOUBLE_REMOVE_TAIL(cache, am_lru);
   cache->am_current--;
@@ -1291,17 +1471,24 @@ struct cache_entry_s* allocate_entry(struct rdcache_s* cache)
 }
 
 
-// Make sure there is a free page on the free list,
-// but don't evict a page with an ongoing operation..
+// Make sure there is a free page on the free list (and room under the
+// page limit), but don't evict a page with an ongoing operation..
 static
 void ensure_free_page(struct rdcache_s* cache, struct cache_entry_s* dont_evict_me)
 {
+  int before;
+
   // If there are free page slots, then use a free page slot.
-  if( cache->free_pages_head ) {
+  if( cache->free_pages_head && cache->pages_in_use < cache->page_limit ) {
     return;
   }
 
-  reclaim(cache, dont_evict_me);
+  // Reclaiming once is enough unless an adaptive cache just shrank.
+  do {
+    before = cache->pages_in_use;
+    reclaim(cache, dont_evict_me);
+  } while( cache->pages_in_use >= cache->page_limit &&
+           cache->pages_in_use < before );
 
   assert( cache->free_pages_head );
 }
@@ -1312,10 +1499,12 @@ unsigned char* allocate_page(struct rdcache_s* cache)
   struct page_list_s* page_list_entry;
   unsigned char* ret;
 
-  if( ! cache->free_pages_head ) ensure_free_page(cache, NULL);
+  if( ! cache->free_pages_head || cache->pages_in_use >= cache->page_limit )
+    ensure_free_page(cache, NULL);
 
   page_list_entry = cache->free_pages_head;
   SINGLE_POP_HEAD(cache, free_pages);
+  cache->pages_in_use++;
 
   ret = page_list_entry->page;
   page_list_entry->page = NULL;
@@ -1742,6 +1931,7 @@ void flush_entry(struct rdcache_s* cache, struct cache_entry_s* entry, int op,
 
           // Save the handle in the list of pending requests.
           entry->max_put_sequence_number = pending_push(cache, handle);
+          CACHE_STATS_INCR(cache, dirty_flushes);
 
           // Move past this region of 1s in dirty bits.
           start = got_skip + got_len;
@@ -1772,6 +1962,15 @@ void flush_entry(struct rdcache_s* cache, struct cache_entry_s* entry, int op,
     }
   }
 
+  // Readahead into this page was wasted if no get used it before now.
+  if( ((op & FLUSH_DO_EVICT) ||
+       ((op & FLUSH_DO_INVALIDATE) && len == CACHEPAGE_SIZE)) &&
+      entry->readahead_unread ) {
+    entry->readahead_unread = 0;
+    CACHE_STATS_INCR(cache, readahead_unused);
+    cache->window_readahead_unused++;
+  }
+
   // If invalidating, clear valid bits.
   if( op & FLUSH_DO_INVALIDATE ) {
     if( len == CACHEPAGE_SIZE ) {
@@ -1795,6 +1994,7 @@ void flush_entry(struct rdcache_s* cache, struct cache_entry_s* entry, int op,
     free_page_list_entry->page = page;
     SINGLE_POP_HEAD(cache, free_page_list_entries);
     SINGLE_PUSH_HEAD(cache, free_page_list_entry, free_pages);
+    cache->pages_in_use--;
   }
 
 #ifdef DUMP
@@ -1879,6 +2079,7 @@ struct cache_entry_s* make_entry(struct rdcache_s* tree,
     bottom_match->queue = QUEUE_AM;
     bottom_match->readahead_skip = 0;
     bottom_match->readahead_len = 0;
+    bottom_match->readahead_unread = 0;
     // Set the page to the one the caller already allocated
     bottom_match->page = page;
     // Clear the valid lines
@@ -1905,6 +2106,7 @@ struct cache_entry_s* make_entry(struct rdcache_s* tree,
     bottom_tmp->queue = QUEUE_AIN;
     bottom_tmp->readahead_skip = 0;
     bottom_tmp->readahead_len = 0;
+    bottom_tmp->readahead_unread = 0;
 
     bottom_tmp->next = NULL;
     bottom_tmp->prev = NULL;
@@ -2084,6 +2286,63 @@ int is_congested(struct rdcache_s* cache)
   return have > 3 * cache->pending_len / 2;
 }
 
+// Resize an adaptive cache and its readahead according to what happened
+// during the window that just ended.
+static
+void cache_adapt(struct rdcache_s* cache)
+{
+  unsigned int gets = cache->window_gets;
+  unsigned int misses = cache->window_misses;
+  unsigned int ghosts = cache->window_ghost_hits;
+  unsigned int ra_hits = cache->window_readahead_hits;
+  unsigned int ra_unused = cache->window_readahead_unused;
+  int pending = fifo_circleb_count(cache->pending_first_entry,
+                                   cache->pending_last_entry,
+                                   cache->pending_len);
+  int limit = cache->page_limit;
+  int ra_max = cache->readahead_max_bytes;
+
+  // Ghost hits would have been hits in a larger cache. Lots of misses
+  // without ghost hits mean the data isn't being reused, so a smaller
+  // cache would do as well.
+  if( ghosts * 8 > gets ) {
+    limit = 2 * limit;
+    if( limit > cache->max_pages ) limit = cache->max_pages;
+  } else if( misses * 2 > gets && ghosts * 64 < gets ) {
+    limit = limit / 2;
+    if( limit < cache->min_page_limit ) limit = cache->min_page_limit;
+  }
+  if( limit != cache->page_limit ) {
+    INFO_PRINT(("%i cache page limit %i -> %i\n",
+                (int) chpl_nodeID, cache->page_limit, limit));
+    cache_set_page_limit(cache, limit);
+  }
+
+  // Read ahead less when the network is backed up or readahead is mostly
+  // wasted, and more when it is mostly used.
+  if( 4 * pending > 3 * (int) cache->pending_len || ra_unused > ra_hits ) {
+    ra_max = ra_max / 2;
+    if( ra_max < CACHEPAGE_SIZE ) ra_max = CACHEPAGE_SIZE;
+  } else if( ra_hits > 4 * ra_unused ) {
+    ra_max = 2 * ra_max;
+    if( ra_max > ADAPTIVE_MAX_READAHEAD_PAGES * CACHEPAGE_SIZE )
+      ra_max = ADAPTIVE_MAX_READAHEAD_PAGES * CACHEPAGE_SIZE;
+  }
+  if( ra_max != cache->readahead_max_bytes ) {
+    cache->readahead_max_bytes = ra_max;
+    cache->prefetch_max_pages = ra_max / CACHEPAGE_SIZE;
+    if( cache->prefetch_max_pages < MAX_PAGES_PER_PREFETCH )
+      cache->prefetch_max_pages = MAX_PAGES_PER_PREFETCH;
+    CACHE_STATS_SET(cache, readahead_max_bytes, ra_max);
+  }
+
+  cache->window_gets = 0;
+  cache->window_misses = 0;
+  cache->window_ghost_hits = 0;
+  cache->window_readahead_hits = 0;
+  cache->window_readahead_unused = 0;
+}
+
 static
 void cache_get(struct rdcache_s* cache,
                 unsigned char * addr,
@@ -2123,8 +2382,8 @@ void cache_get_trigger_readahead(struct rdcache_s* cache,
   if( ENABLE_READAHEAD && skip && ! is_congested(cache) ) {
     next_ra_length = 2 * len;
 
-    if( next_ra_length > MAX_SEQUENTIAL_READAHEAD_BYTES )
-      next_ra_length = MAX_SEQUENTIAL_READAHEAD_BYTES;
+    if( next_ra_length > cache->readahead_max_bytes )
+      next_ra_length = cache->readahead_max_bytes;
 
     if( skip < 0 )
       next_ra_length = - next_ra_length;
@@ -2211,6 +2470,159 @@ void cache_get_trigger_readahead(struct rdcache_s* cache,
   }
 }
 
+// Prefetch the GETs predicted by a stream's pattern, starting after the
+// last one already prefetched, if the network is not too busy.
+static
+void cache_get_trigger_pattern(struct rdcache_s* cache,
+                               struct pattern_stream_s* stream,
+                               size_t size,
+                               cache_seqn_t last_acquire,
+                               int32_t commID, int ln, int32_t fn)
+{
+  int period = stream->period;
+  int want = PATTERN_PREFETCH_ITERS * period;
+  raddr_t prefetch_raddr = stream->last_addr;
+  int pending;
+  int i;
+
+  for( i = 1; i <= want; i++ ) {
+    // The i'th GET from now should repeat the distance seen 'period'
+    // GETs before it.
+    prefetch_raddr += stream->deltas[period - 1 - (i - 1) % period];
+    if( i <= stream->ahead ) continue;
+
+    pending = fifo_circleb_count(cache->pending_first_entry,
+                                 cache->pending_last_entry,
+                                 cache->pending_len);
+    if( 2 * pending > (int) cache->pending_len ) break;
+
+    // Don't prefetch past the end of the remote object.
+    if( ! chpl_comm_addr_gettable(stream->node, (void*) prefetch_raddr,
+                                  size) ) break;
+
+    INFO_PRINT(("%i pattern prefetch %i:%p period %i\n",
+                (int) chpl_nodeID, (int) stream->node,
+                (void*) prefetch_raddr, period));
+    cache_get(cache, NULL /* prefetch */, stream->node, prefetch_raddr, size,
+              last_acquire, 0, commID, ln, fn);
+    stream->ahead = i;
+  }
+}
+
+// Find the stream a GET belongs to: the one whose pattern predicted it,
+// or else the closest one nearby from the same source line. Returns NULL
+// after starting a new stream (replacing the least recently used one)
+// if there is no such stream.
+static
+struct pattern_stream_s* cache_get_pattern_stream(struct rdcache_s* cache,
+                                                  c_nodeid_t node,
+                                                  raddr_t raddr,
+                                                  int ln, int32_t fn)
+{
+  struct pattern_stream_s* s;
+  struct pattern_stream_s* closest = NULL;
+  struct pattern_stream_s* lru = &cache->pattern_streams[0];
+  uintptr_t dist, closest_dist = 0;
+  int i;
+
+  for( i = 0; i < PATTERN_STREAMS; i++ ) {
+    s = &cache->pattern_streams[i];
+    if( s->last_use < lru->last_use ) lru = s;
+    if( s->node != node ) continue;
+
+    if( s->period &&
+        s->last_addr + s->deltas[s->period - 1] == raddr ) {
+      closest = s;
+      break;
+    }
+
+    if( s->ln == ln && s->fn == fn ) {
+      dist = raddr > s->last_addr ? raddr - s->last_addr
+                                  : s->last_addr - raddr;
+      if( dist < PATTERN_REGION_SIZE &&
+          (closest == NULL || dist < closest_dist) ) {
+        closest = s;
+        closest_dist = dist;
+      }
+    }
+  }
+
+  if( closest == NULL ) {
+    lru->node = node;
+    lru->ln = ln;
+    lru->fn = fn;
+    lru->last_addr = raddr;
+    lru->ndeltas = 0;
+    lru->period = 0;
+    lru->ahead = 0;
+    lru->last_use = ++cache->pattern_clock;
+    return NULL;
+  }
+
+  closest->last_use = ++cache->pattern_clock;
+  return closest;
+}
+
+// Record a GET in the access history of its stream, and if it continues
+// (or starts) a repeating pattern, prefetch what the pattern predicts.
+static
+void cache_get_observe_pattern(struct rdcache_s* cache,
+                               c_nodeid_t node,
+                               raddr_t raddr, size_t size,
+                               cache_seqn_t last_acquire,
+                               int32_t commID, int ln, int32_t fn)
+{
+  struct pattern_stream_s* stream;
+  intptr_t delta;
+  int period, i, skips_lines;
+
+  stream = cache_get_pattern_stream(cache, node, raddr, ln, fn);
+  if( stream == NULL ) return;
+
+  delta = (intptr_t) (raddr - stream->last_addr);
+  stream->last_addr = raddr;
+
+  if( stream->period ) {
+    if( delta == stream->deltas[stream->period - 1] ) {
+      // As predicted; one fewer of the prefetched GETs is still ahead.
+      if( stream->ahead > 0 ) stream->ahead--;
+    } else {
+      stream->period = 0;
+      stream->ahead = 0;
+    }
+  }
+
+  memmove(&stream->deltas[1], &stream->deltas[0],
+          (PATTERN_HISTORY - 1) * sizeof(stream->deltas[0]));
+  stream->deltas[0] = delta;
+  if( stream->ndeltas < PATTERN_HISTORY ) stream->ndeltas++;
+
+  // Look for the shortest period that repeats at least twice.
+  // Patterns that stay within a cache line (such as sequential access)
+  // are left to readahead.
+  for( period = 1;
+       stream->period == 0 && period <= PATTERN_MAX_PERIOD &&
+       2 * period <= stream->ndeltas;
+       period++ ) {
+    skips_lines = 0;
+    for( i = 0; i < period; i++ ) {
+      if( stream->deltas[i] != stream->deltas[i + period] )
+        break;
+      if( stream->deltas[i] >= CACHELINE_SIZE ||
+          stream->deltas[i] <= -CACHELINE_SIZE )
+        skips_lines = 1;
+    }
+    if( i == period && skips_lines ) {
+      stream->period = period;
+      stream->ahead = 0;
+    }
+  }
+
+  if( stream->period )
+    cache_get_trigger_pattern(cache, stream, size, last_acquire,
+                              commID, ln, fn);
+}
+
 static
 int should_readahead_extend(uint64_t* valid,
                             uintptr_t skip, uintptr_t len )
@@ -2261,11 +2673,16 @@ void cache_get(struct rdcache_s* cache,
 
   assert(chpl_nodeID != node); // should be handled in chpl_gen_comm_prefetch.
 
-  // And don't do anything if it's a zero-length 
+  // And don't do anything if it's a zero-length
   if( size == 0 ) {
     return;
   }
 
+  if( cache->adaptive && ! isprefetch &&
+      ++cache->window_gets >= ADAPTIVE_WINDOW ) {
+    cache_adapt(cache);
+  }
+
   // first_page = raddr of start of first needed page
   ra_first_page = round_down_to_mask(raddr, CACHEPAGE_MASK);
   // last_page = raddr of start of last needed page
@@ -2278,8 +2695,8 @@ void cache_get(struct rdcache_s* cache,
 
   // If the request is too large to reasonably fit in the cache, limit
   // the amount of data prefetched. (or do nothing?)
-  if( isprefetch && (ra_last_page-ra_first_page)/CACHEPAGE_SIZE+1 > MAX_PAGES_PER_PREFETCH ) {
-    ra_last_page = ra_first_page + CACHEPAGE_SIZE*MAX_PAGES_PER_PREFETCH;
+  if( isprefetch && (ra_last_page-ra_first_page)/CACHEPAGE_SIZE+1 > cache->prefetch_max_pages ) {
+    ra_last_page = ra_first_page + CACHEPAGE_SIZE*cache->prefetch_max_pages;
   }
 
   // Try to find it in the cache. Go through one page at a time.
@@ -2300,7 +2717,13 @@ void cache_get(struct rdcache_s* cache,
 
 
     // Ignore entries in Aout for now.
-    if( entry && ! entry->page ) entry = NULL;
+    if( entry && ! entry->page ) {
+      if( ! isprefetch ) {
+        CACHE_STATS_INCR(cache, get_ghost_hits);
+        cache->window_ghost_hits++;
+      }
+      entry = NULL;
+    }
 
     if( entry ) {
       // Is this cache line available for use, based on when we
@@ -2405,6 +2828,12 @@ void cache_get(struct rdcache_s* cache,
         // If the cache line is in Am, move it to the front of Am.
         use_entry(cache, entry);
         if( ! isprefetch ) {
+          CACHE_STATS_INCR(cache, get_hits);
+          if( entry->readahead_unread ) {
+            entry->readahead_unread = 0;
+            CACHE_STATS_INCR(cache, readahead_hits);
+            cache->window_readahead_hits++;
+          }
       
           //printf("cache hit on page %i:%p %p ra_len %i\n", 
           //       node, (void*) ra_page, (void*) requested_start,
@@ -2495,6 +2924,16 @@ void cache_get(struct rdcache_s* cache,
                     (ra_line - ra_page) >> CACHELINE_BITS,
                     (ra_line_end - ra_line) >> CACHELINE_BITS);
 
+    if( ! isprefetch ) {
+      CACHE_STATS_INCR(cache, get_misses);
+      cache->window_misses++;
+    } else if( sequential_readahead_length != 0 ) {
+      CACHE_STATS_INCR(cache, readaheads);
+      entry->readahead_unread = 1;
+    } else {
+      CACHE_STATS_INCR(cache, prefetches);
+    }
+
     if( ! isprefetch ) {
       // This will increment next request number so cache events are recorded.
       sn = cache->next_request_number;
@@ -2674,6 +3113,14 @@ static struct rdcache_s* cache_create(void);
 CHPL_TLS_DECL(struct rdcache_s*,cache_remote_data);
 static pthread_key_t pthread_cache_info_key; // stores struct rdcache_s*
 
+// The caches on this node, so that statistics can be summed over them,
+// along with counts from caches that have been destroyed and the counts
+// as of the last chpl_cache_stats_reset_here().
+static pthread_mutex_t all_caches_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct rdcache_s* all_caches_head = NULL;
+static chpl_cacheStats destroyed_caches_stats;
+static chpl_cacheStats reset_stats;
+
 static
 struct rdcache_s* tls_cache_remote_data(void) {
   struct rdcache_s *cache = CHPL_TLS_GET(cache_remote_data);
@@ -2681,10 +3128,35 @@ struct rdcache_s* tls_cache_remote_data(void) {
     cache = cache_create();
     CHPL_TLS_SET(cache_remote_data, cache);
     pthread_setspecific(pthread_cache_info_key, cache);
+
+    pthread_mutex_lock(&all_caches_lock);
+    cache->next_cache = all_caches_head;
+    if( all_caches_head ) all_caches_head->prev_cache = cache;
+    all_caches_head = cache;
+    pthread_mutex_unlock(&all_caches_lock);
   }
   return cache;
 }
 
+// Sum the statistics of the live caches and destroyed_caches_stats.
+// Expects all_caches_lock to be held.
+static
+void cache_stats_sum(chpl_cacheStats* cs)
+{
+  struct rdcache_s* c;
+  uint64_t val;
+
+  *cs = destroyed_caches_stats;
+  for( c = all_caches_head; c; c = c->next_cache ) {
+#define _CACHE_STATS_ADD(csv) cs->csv += CACHE_STATS_GET(c, csv);
+    CHPL_CACHE_STATS_COUNTS(_CACHE_STATS_ADD)
+#undef _CACHE_STATS_ADD
+    cs->capacity_pages += CACHE_STATS_GET(c, capacity_pages);
+    val = CACHE_STATS_GET(c, readahead_max_bytes);
+    if( val > cs->readahead_max_bytes ) cs->readahead_max_bytes = val;
+  }
+}
+
 static
 chpl_cache_taskPrvData_t* task_private_cache_data(void)
 {
@@ -2696,6 +3168,18 @@ static
 void destroy_pthread_local_cache(void* arg)
 {
   struct rdcache_s* s = (struct rdcache_s*) arg;
+
+  // Keep the counts from this cache, but not its gauges.
+  pthread_mutex_lock(&all_caches_lock);
+#define _CACHE_STATS_RETIRE(csv) \
+  destroyed_caches_stats.csv += CACHE_STATS_GET(s, csv);
+  CHPL_CACHE_STATS_COUNTS(_CACHE_STATS_RETIRE)
+#undef _CACHE_STATS_RETIRE
+  if( s->prev_cache ) s->prev_cache->next_cache = s->next_cache;
+  else all_caches_head = s->next_cache;
+  if( s->next_cache ) s->next_cache->prev_cache = s->prev_cache;
+  pthread_mutex_unlock(&all_caches_lock);
+
   cache_destroy(s);
 }
 
@@ -2718,6 +3202,8 @@ void chpl_cache_do_init(void)
     // The second key we never read but create so that we
     // can free the cache when the thread exits.
     pthread_key_create(&pthread_cache_info_key, &destroy_pthread_local_cache);
+
+    cache_adaptive = chpl_env_rt_get_bool("CACHE_ADAPTIVE", false);
     inited = 1;
   }
 }
@@ -2833,6 +3319,11 @@ void chpl_cache_comm_get(void *addr, c_nodeid_t node, void* raddr,
   cache_get(cache, addr, node, (raddr_t)raddr, size, task_local->last_acquire,
             0, commID, ln, fn);
 
+  if( ENABLE_PATTERN_PREFETCH ) {
+    cache_get_observe_pattern(cache, node, (raddr_t)raddr, size,
+                              task_local->last_acquire, commID, ln, fn);
+  }
+
   return;
 }
 
@@ -2849,6 +3340,37 @@ void chpl_cache_comm_prefetch(c_nodeid_t node, void* raddr,
   cache_get(cache, NULL, node, (raddr_t)raddr, size, task_local->last_acquire,
             0, CHPL_COMM_UNKNOWN_ID, ln, fn);
 }
+
+void chpl_cache_prefetch_strided(c_nodeid_t node, void* raddr,
+                                 size_t size, ptrdiff_t stride, size_t count,
+                                 int ln, int32_t fn)
+{
+  struct rdcache_s* cache;
+  chpl_cache_taskPrvData_t* task_local;
+  raddr_t prefetch_raddr = (raddr_t) raddr;
+  size_t max_count;
+  size_t i;
+
+  if( ! chpl_cache_enabled() || node == chpl_nodeID ) return;
+
+  cache = tls_cache_remote_data();
+  task_local = task_private_cache_data();
+  TRACE_PRINT(("%d: in chpl_cache_prefetch_strided\n", chpl_nodeID));
+  chpl_comm_diags_verbose_rdma("prefetch", node, size * count, ln, fn);
+
+  // Prefetching more than half of the cache would evict the start of
+  // the prefetched data before it could be used.
+  max_count = cache->page_limit / 2;
+  if( stride != 0 && (size_t) (stride < 0 ? -stride : stride) < CACHEPAGE_SIZE )
+    max_count *= CACHEPAGE_SIZE / (stride < 0 ? -stride : stride);
+  if( count > max_count ) count = max_count;
+
+  for( i = 0; i < count; i++ ) {
+    cache_get(cache, NULL, node, prefetch_raddr, size,
+              task_local->last_acquire, 0, CHPL_COMM_UNKNOWN_ID, ln, fn);
+    prefetch_raddr += stride;
+  }
+}
 void chpl_cache_comm_get_strd(void *addr, void *dststr, c_nodeid_t node,
                               void *raddr, void *srcstr, void *count,
                               int32_t strlevels, size_t elemSize,
@@ -2896,6 +3418,23 @@ void chpl_cache_comm_put_strd(void *addr, void *dststr, c_nodeid_t node,
 #endif
 }
 
+void chpl_cache_stats_get_here(chpl_cacheStats* cs)
+{
+  pthread_mutex_lock(&all_caches_lock);
+  cache_stats_sum(cs);
+#define _CACHE_STATS_SINCE_RESET(csv) cs->csv -= reset_stats.csv;
+  CHPL_CACHE_STATS_COUNTS(_CACHE_STATS_SINCE_RESET)
+#undef _CACHE_STATS_SINCE_RESET
+  pthread_mutex_unlock(&all_caches_lock);
+}
+
+void chpl_cache_stats_reset_here(void)
+{
+  pthread_mutex_lock(&all_caches_lock);
+  cache_stats_sum(&reset_stats);
+  pthread_mutex_unlock(&all_caches_lock);
+}
+
 // This is for debugging.
 void chpl_cache_print(void)
 {
@@ -2936,6 +3475,20 @@ void chpl_cache_set_enabled(int enabled)
 }
 */
 
+#else // HAS_CHPL_CACHE_FNS
+
+// Without a remote data cache there is nothing to report.
+void chpl_cache_stats_get_here(chpl_cacheStats* cs)
+{
+  memset(cs, 0, sizeof(*cs));
+}
+
+void chpl_cache_stats_reset_here(void) { }
+
+void chpl_cache_prefetch_strided(c_nodeid_t node, void* raddr,
+                                 size_t size, ptrdiff_t stride, size_t count,
+                                 int ln, int32_t fn) { }
+
 #endif
 // end ifdef HAS_CHPL_CACHE_FNS
 
@@ -26,10 +26,162 @@
 
 #include "chpl-comm.h"
 #include "chpl-comm-diags.h"
+#include "chpl-mem.h"
 
+#include <pthread.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+
+CHPL_TLS_DECL(chpl_comm_diags_thread_t*, chpl_comm_diags_thread);
+atomic_int_least16_t chpl_comm_diags_disable_flag;
+int chpl_comm_diags_by_source;
+
+// all threads' counters
+static pthread_mutex_t diags_threads_lock = PTHREAD_MUTEX_INITIALIZER;
+static chpl_comm_diags_thread_t* diags_threads;
+
+
+//
+// Per-thread source location tables.  These use open addressing on a
+// key made from the line, file, and kind.  The owner fills in an
+// entry's counts before publishing its key, so readers can tell which
+// entries are complete.  When a table fills up, further locations are
+// counted in 'other'.
+//
+#define SRC_TABLE_SIZE 1024      // must be a power of 2
+#define SRC_KEY_USED   ((uint64_t) 1 << 63)
+
+typedef struct {
+  atomic_uint_least64_t key;
+  atomic_uint_least64_t count;
+  atomic_uint_least64_t bytes;
+} src_entry_t;
+
+struct chpl_comm_diags_src_table {
+  src_entry_t entries[SRC_TABLE_SIZE];
+  atomic_uint_least64_t other_count[chpl_comm_diags_num_kinds];
+  atomic_uint_least64_t other_bytes[chpl_comm_diags_num_kinds];
+};
+
+static inline
+uint64_t src_key(chpl_comm_diags_kind_t kind, int32_t ln, int32_t fn) {
+  return SRC_KEY_USED
+         | ((uint64_t) (uint32_t) fn << 36)
+         | ((uint64_t) kind << 32)
+         | (uint32_t) ln;
+}
+
+
+void chpl_comm_diags_init(void) {
+  CHPL_TLS_INIT(chpl_comm_diags_thread);
+  atomic_init_int_least16_t(&chpl_comm_diags_disable_flag, 0);
+}
+
+
+chpl_comm_diags_thread_t* chpl_comm_diags_thread_new(void) {
+  chpl_comm_diags_thread_t* t;
+
+  t = (chpl_comm_diags_thread_t*) chpl_mem_alloc(sizeof(*t),
+                                                 CHPL_RT_MD_COMM_UTIL, 0, 0);
+#define _COMM_DIAGS_INIT(cdv) \
+        atomic_init_uint_least64_t(&t->counters.cdv, 0);
+  CHPL_COMM_DIAGS_VARS_ALL(_COMM_DIAGS_INIT);
+#undef _COMM_DIAGS_INIT
+  t->src = NULL;
+
+  pthread_mutex_lock(&diags_threads_lock);
+  t->next = diags_threads;
+  diags_threads = t;
+  pthread_mutex_unlock(&diags_threads_lock);
+
+  CHPL_TLS_SET(chpl_comm_diags_thread, t);
+  return t;
+}
+
+
+void chpl_comm_diags_src_record(chpl_comm_diags_thread_t* t,
+                                chpl_comm_diags_kind_t kind, size_t size,
+                                int32_t ln, int32_t fn) {
+  struct chpl_comm_diags_src_table* tbl = t->src;
+  const uint64_t key = src_key(kind, ln, fn);
+  uint64_t i, probe;
+
+  if (tbl == NULL) {
+    tbl = (struct chpl_comm_diags_src_table*)
+          chpl_mem_calloc(1, sizeof(*tbl), CHPL_RT_MD_COMM_UTIL, 0, 0);
+    t->src = tbl;
+  }
+
+  i = (key * UINT64_C(0x9E3779B97F4A7C15)) >> 54;   // top 10 bits
+  for (probe = 0; probe < SRC_TABLE_SIZE; probe++) {
+    src_entry_t* e = &tbl->entries[(i + probe) & (SRC_TABLE_SIZE - 1)];
+    uint64_t k = atomic_load_explicit_uint_least64_t(&e->key,
+                                                     memory_order_relaxed);
+    if (k == key) {
+      chpl_comm_diags_bump(&e->count);
+      atomic_store_explicit_uint_least64_t(&e->bytes,
+        atomic_load_explicit_uint_least64_t(&e->bytes, memory_order_relaxed)
+        + size, memory_order_relaxed);
+      return;
+    }
+    if (k == 0) {
+      atomic_store_explicit_uint_least64_t(&e->count, 1,
+                                           memory_order_relaxed);
+      atomic_store_explicit_uint_least64_t(&e->bytes, size,
+                                           memory_order_relaxed);
+      atomic_store_explicit_uint_least64_t(&e->key, key,
+                                           memory_order_release);
+      return;
+    }
+  }
+
+  chpl_comm_diags_bump(&tbl->other_count[kind]);
+  atomic_store_explicit_uint_least64_t(&tbl->other_bytes[kind],
+    atomic_load_explicit_uint_least64_t(&tbl->other_bytes[kind],
+                                        memory_order_relaxed)
+    + size, memory_order_relaxed);
+}
+
+
+void chpl_comm_diags_reset(void) {
+  chpl_comm_diags_thread_t* t;
+  int i;
+
+  pthread_mutex_lock(&diags_threads_lock);
+  for (t = diags_threads; t != NULL; t = t->next) {
+#define _COMM_DIAGS_RESET(cdv) \
+        atomic_store_uint_least64_t(&t->counters.cdv, 0);
+    CHPL_COMM_DIAGS_VARS_ALL(_COMM_DIAGS_RESET);
+#undef _COMM_DIAGS_RESET
+    if (t->src != NULL) {
+      for (i = 0; i < SRC_TABLE_SIZE; i++)
+        atomic_store_uint_least64_t(&t->src->entries[i].key, 0);
+      for (i = 0; i < chpl_comm_diags_num_kinds; i++) {
+        atomic_store_uint_least64_t(&t->src->other_count[i], 0);
+        atomic_store_uint_least64_t(&t->src->other_bytes[i], 0);
+      }
+    }
+  }
+  pthread_mutex_unlock(&diags_threads_lock);
+}
+
+
+void chpl_comm_diags_copy(chpl_commDiagnostics* cd) {
+  chpl_comm_diags_thread_t* t;
+
+  memset(cd, 0, sizeof(*cd));
+  pthread_mutex_lock(&diags_threads_lock);
+  for (t = diags_threads; t != NULL; t = t->next) {
+#define _COMM_DIAGS_COPY(cdv) \
+        cd->cdv += atomic_load_uint_least64_t(&t->counters.cdv);
+    CHPL_COMM_DIAGS_VARS_ALL(_COMM_DIAGS_COPY);
+#undef _COMM_DIAGS_COPY
+  }
+  pthread_mutex_unlock(&diags_threads_lock);
+}
 
 
 void chpl_startVerboseComm() {
@@ -96,3 +248,88 @@ void chpl_resetCommDiagnosticsHere() {
 void chpl_getCommDiagnosticsHere(chpl_commDiagnostics *cd) {
   chpl_comm_diags_copy(cd);
 }
+
+
+void chpl_setCommDiagnosticsBySourceHere(chpl_bool on) {
+  chpl_comm_diags_by_source = on ? 1 : 0;
+}
+
+
+static int cmp_src(const void* a, const void* b) {
+  const chpl_commDiagsSource* x = (const chpl_commDiagsSource*) a;
+  const chpl_commDiagsSource* y = (const chpl_commDiagsSource*) b;
+  if (x->filename != y->filename)
+    return (x->filename < y->filename) ? -1 : 1;
+  if (x->lineno != y->lineno)
+    return (x->lineno < y->lineno) ? -1 : 1;
+  if (x->kind != y->kind)
+    return (x->kind < y->kind) ? -1 : 1;
+  return 0;
+}
+
+
+size_t chpl_getCommDiagnosticsBySourceHere(chpl_commDiagsSource** entries) {
+  chpl_comm_diags_thread_t* t;
+  chpl_commDiagsSource* v;
+  size_t n, max, i, j;
+  int k;
+
+  pthread_mutex_lock(&diags_threads_lock);
+
+  // Gather every thread's entries, then sort and combine them.
+  max = 0;
+  for (t = diags_threads; t != NULL; t = t->next) {
+    if (t->src != NULL)
+      max += SRC_TABLE_SIZE + chpl_comm_diags_num_kinds;
+  }
+  v = (chpl_commDiagsSource*)
+      chpl_mem_allocMany((max == 0) ? 1 : max, sizeof(v[0]),
+                         CHPL_RT_MD_COMM_UTIL, 0, 0);
+
+  n = 0;
+  for (t = diags_threads; t != NULL; t = t->next) {
+    if (t->src == NULL)
+      continue;
+    for (i = 0; i < SRC_TABLE_SIZE; i++) {
+      src_entry_t* e = &t->src->entries[i];
+      uint64_t key = atomic_load_explicit_uint_least64_t(&e->key,
+                                                       memory_order_acquire);
+      if (key == 0)
+        continue;
+      v[n].lineno = (int32_t) (uint32_t) key;
+      v[n].kind = (int32_t) ((key >> 32) & 0xf);
+      v[n].filename = (int32_t) ((key & ~SRC_KEY_USED) >> 36);
+      v[n].count = atomic_load_explicit_uint_least64_t(&e->count,
+                                                       memory_order_relaxed);
+      v[n].bytes = atomic_load_explicit_uint_least64_t(&e->bytes,
+                                                       memory_order_relaxed);
+      n++;
+    }
+    for (k = 0; k < chpl_comm_diags_num_kinds; k++) {
+      uint64_t cnt = atomic_load_uint_least64_t(&t->src->other_count[k]);
+      if (cnt == 0)
+        continue;
+      v[n].lineno = -1;
+      v[n].filename = 0;
+      v[n].kind = k;
+      v[n].count = cnt;
+      v[n].bytes = atomic_load_uint_least64_t(&t->src->other_bytes[k]);
+      n++;
+    }
+  }
+
+  pthread_mutex_unlock(&diags_threads_lock);
+
+  qsort(v, n, sizeof(v[0]), cmp_src);
+  for (i = 0, j = 0; i < n; i++) {
+    if (j > 0 && cmp_src(&v[j - 1], &v[i]) == 0) {
+      v[j - 1].count += v[i].count;
+      v[j - 1].bytes += v[i].bytes;
+    } else {
+      v[j++] = v[i];
+    }
+  }
+
+  *entries = v;
+  return j;
+}
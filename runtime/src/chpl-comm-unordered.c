@@ -0,0 +1,563 @@
+/*
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// Portable unordered GETs, PUTs, and atomic updates (see
+// chpl-comm-unordered.h).
+//
+#include "chplrt.h"
+
+#include "chpl-atomics.h"
+#include "chpl-comm.h"
+#include "chpl-comm-unordered.h"
+#include "chpl-comm-no-warning-macros.h" // we call chpl_comm_put directly
+#include "chpl-env.h"
+#include "chpl-mem.h"
+#include "chpl-tasks.h"
+#include "chpl-thread-local-storage.h"
+#include "error.h"
+
+#include <pthread.h>
+#include <string.h>
+
+
+//
+// How many non-blocking GETs and PUTs a thread may have outstanding,
+// and how much PUT source data it may hold, before it waits for them.
+//
+#define MAX_UNORDERED_RMA 64
+#define UNORDERED_PUT_SPACE (8 * 1024)
+
+//
+// How many atomic updates a thread buffers for one node before it
+// ships them there.  The comm layer may limit this further.
+//
+#define DFLT_UNORDERED_AMO_BUFF 256
+
+typedef struct {
+  int                      num_rma;     // outstanding GETs and PUTs
+  chpl_comm_nb_handle_t    rma[MAX_UNORDERED_RMA];
+  void*                    put_src[MAX_UNORDERED_RMA]; // PUT source copies
+} rma_batch_t;
+
+//
+// The lock is never held across a comm call, since the comm layer may
+// yield while it waits (e.g., gasnet with qthreads) and another task on
+// the same thread could then block on the lock forever.  Instead, a
+// full batch of operations is taken out of the info while it is locked
+// and completed after it is unlocked.  in_flight counts the batches
+// being completed, so that fences can wait for them too.
+//
+typedef struct unordered_info_s {
+  struct unordered_info_s* next;        // list of all threads' infos
+  pthread_mutex_t          lock;        // other threads may fence us
+  atomic_uint_least32_t    in_flight;   // taken batches not yet completed
+
+  rma_batch_t              rma;
+  size_t                   put_used;    // bytes of PUT source copies held
+
+#ifndef CHPL_COMM_IMPL_UNORDERED_GET
+  size_t*                     amo_cnt;  // per-node buffered update count
+  chpl_comm_amo_unordered_t** amo_buf;  // per-node buffers, made on demand
+#endif
+} unordered_info_t;
+
+static pthread_mutex_t   unordered_infos_lock = PTHREAD_MUTEX_INITIALIZER;
+static unordered_info_t* unordered_infos;
+static size_t            amo_buff_size;
+
+CHPL_TLS_DECL(unordered_info_t*, unordered_info);
+
+
+void chpl_comm_unordered_init(void) {
+  CHPL_TLS_INIT(unordered_info);
+
+#ifndef CHPL_COMM_IMPL_UNORDERED_GET
+  amo_buff_size = chpl_env_rt_get_int("COMM_UNORDERED_AMO_BUFF_SIZE",
+                                      DFLT_UNORDERED_AMO_BUFF);
+  if (amo_buff_size == 0)
+    amo_buff_size = 1;
+  if (chpl_numNodes > 1 && amo_buff_size > chpl_comm_impl_amo_max_batch())
+    amo_buff_size = chpl_comm_impl_amo_max_batch();
+#endif
+}
+
+
+static inline
+unordered_info_t* get_info(void) {
+  unordered_info_t* info = (unordered_info_t*) CHPL_TLS_GET(unordered_info);
+  if (info == NULL) {
+    info = (unordered_info_t*) chpl_mem_calloc(1, sizeof(*info),
+                                               CHPL_RT_MD_COMM_UTIL, 0, 0);
+    pthread_mutex_init(&info->lock, NULL);
+    atomic_init_uint_least32_t(&info->in_flight, 0);
+#ifndef CHPL_COMM_IMPL_UNORDERED_GET
+    info->amo_cnt = (size_t*)
+                    chpl_mem_calloc(chpl_numNodes, sizeof(info->amo_cnt[0]),
+                                    CHPL_RT_MD_COMM_PER_LOC_INFO, 0, 0);
+    info->amo_buf = (chpl_comm_amo_unordered_t**)
+                    chpl_mem_calloc(chpl_numNodes, sizeof(info->amo_buf[0]),
+                                    CHPL_RT_MD_COMM_PER_LOC_INFO, 0, 0);
+#endif
+
+    pthread_mutex_lock(&unordered_infos_lock);
+    info->next = unordered_infos;
+    unordered_infos = info;
+    pthread_mutex_unlock(&unordered_infos_lock);
+
+    CHPL_TLS_SET(unordered_info, info);
+  }
+  return info;
+}
+
+
+//
+// Wait until no batch taken out of a thread's info is still being
+// completed by some task.
+//
+static inline
+void wait_in_flight(unordered_info_t* info) {
+  while (atomic_load_uint_least32_t(&info->in_flight) != 0)
+    chpl_task_yield();
+}
+
+
+//
+// Apply 'flush' to this thread's info or, if tasks can move between
+// threads (and so a task's operations may be in any thread's info), to
+// every thread's.  'flush' is called with the info unlocked.
+//
+static
+void fence_infos(void (*flush)(unordered_info_t*), chpl_bool all_threads) {
+  unordered_info_t* info;
+
+  if (all_threads || chpl_task_canMigrateThreads()) {
+    unordered_info_t* infos;
+
+    // Infos are only ever added, at the head of the list, so once we
+    // have the head the rest of the list can be walked unlocked.
+    pthread_mutex_lock(&unordered_infos_lock);
+    infos = unordered_infos;
+    pthread_mutex_unlock(&unordered_infos_lock);
+
+    for (info = infos; info != NULL; info = info->next)
+      (*flush)(info);
+    for (info = infos; info != NULL; info = info->next)
+      wait_in_flight(info);
+  } else {
+    info = (unordered_info_t*) CHPL_TLS_GET(unordered_info);
+    if (info != NULL) {
+      (*flush)(info);
+      wait_in_flight(info);
+    }
+  }
+}
+
+
+////////////////////////////////////////
+//
+// GETs and PUTs
+//
+
+//
+// Take a thread's outstanding GETs and PUTs out of its info, for
+// complete_rma() to wait for.  Called with the info locked.
+//
+static
+void take_rma(unordered_info_t* info, rma_batch_t* batch) {
+  int n = info->rma.num_rma;
+
+  batch->num_rma = n;
+  if (n > 0) {
+    memcpy(batch->rma, info->rma.rma, n * sizeof(batch->rma[0]));
+    memcpy(batch->put_src, info->rma.put_src, n * sizeof(batch->put_src[0]));
+    info->rma.num_rma = 0;
+    info->put_used = 0;
+    atomic_fetch_add_uint_least32_t(&info->in_flight, 1);
+  }
+}
+
+//
+// Wait for a batch of GETs and PUTs taken by take_rma().  Called with
+// the info unlocked.  A NULL handle is a completed operation, and the
+// comm layers' wait functions NULL out the handles they complete.
+//
+static
+void complete_rma(unordered_info_t* info, rma_batch_t* batch) {
+  int i;
+
+  if (batch->num_rma == 0)
+    return;
+
+  for (i = 0; i < batch->num_rma; ) {
+    if ((void*) batch->rma[i] == NULL)
+      i++;
+    else
+      chpl_comm_wait_nb_some(&batch->rma[i], batch->num_rma - i);
+  }
+  for (i = 0; i < batch->num_rma; i++) {
+    if (batch->put_src[i] != NULL)
+      chpl_mem_free(batch->put_src[i], 0, 0);
+  }
+  atomic_fetch_sub_uint_least32_t(&info->in_flight, 1);
+}
+
+static
+void flush_rma(unordered_info_t* info) {
+  rma_batch_t batch;
+
+  pthread_mutex_lock(&info->lock);
+  take_rma(info, &batch);
+  pthread_mutex_unlock(&info->lock);
+  complete_rma(info, &batch);
+}
+
+//
+// Record an issued GET or PUT, the latter with the copy of its source
+// data to free once it is done.  If that would hold too many operations
+// or too much source data, the ones already held are taken out first,
+// for the caller to complete once it has unlocked the info.  Called
+// with the info locked.
+//
+static inline
+void add_rma(unordered_info_t* info, chpl_comm_nb_handle_t h,
+             void* put_src, size_t put_size, rma_batch_t* batch) {
+  int n;
+
+  batch->num_rma = 0;
+  if (info->rma.num_rma == MAX_UNORDERED_RMA
+      || info->put_used + put_size > UNORDERED_PUT_SPACE)
+    take_rma(info, batch);
+
+  n = info->rma.num_rma++;
+  info->rma.rma[n] = h;
+  info->rma.put_src[n] = put_src;
+  info->put_used += put_size;
+}
+
+
+#ifndef CHPL_COMM_IMPL_UNORDERED_GET
+
+void chpl_comm_get_unordered(void* addr, c_nodeid_t node, void* raddr,
+                             size_t size, int32_t typeIndex, int32_t commID,
+                             int ln, int32_t fn) {
+  unordered_info_t* info;
+  chpl_comm_nb_handle_t h;
+  rma_batch_t batch;
+
+  if (size == 0)
+    return;
+
+  if (node == chpl_nodeID) {
+    memmove(addr, raddr, size);
+    return;
+  }
+
+  h = chpl_comm_get_nb(addr, node, raddr, size, typeIndex, commID, ln, fn);
+  if ((void*) h == NULL)
+    return;
+
+  info = get_info();
+  pthread_mutex_lock(&info->lock);
+  add_rma(info, h, NULL, 0, &batch);
+  pthread_mutex_unlock(&info->lock);
+  complete_rma(info, &batch);
+}
+
+void chpl_comm_get_unordered_fence(void) {
+  fence_infos(flush_rma, true);
+}
+
+void chpl_comm_get_unordered_task_fence(void) {
+  fence_infos(flush_rma, false);
+}
+
+#endif // CHPL_COMM_IMPL_UNORDERED_GET
+
+
+void chpl_comm_put_unordered(void* addr, c_nodeid_t node, void* raddr,
+                             size_t size, int32_t typeIndex, int32_t commID,
+                             int ln, int32_t fn) {
+  unordered_info_t* info;
+  chpl_comm_nb_handle_t h;
+  rma_batch_t batch;
+  void* src;
+
+  if (size == 0)
+    return;
+
+  if (node == chpl_nodeID) {
+    memmove(raddr, addr, size);
+    return;
+  }
+
+  // Large PUTs gain little from being overlapped; just do them.
+  if (size > UNORDERED_PUT_SPACE / 4) {
+    chpl_comm_put(addr, node, raddr, size, typeIndex, commID, ln, fn);
+    return;
+  }
+
+  // Keep a copy of the source data until the PUT is done.
+  src = chpl_mem_alloc(size, CHPL_RT_MD_COMM_XMIT_RCV_BUF, 0, 0);
+  memcpy(src, addr, size);
+  h = chpl_comm_put_nb(src, node, raddr, size, typeIndex, commID, ln, fn);
+  if ((void*) h == NULL) {
+    chpl_mem_free(src, 0, 0);
+    return;
+  }
+
+  info = get_info();
+  pthread_mutex_lock(&info->lock);
+  add_rma(info, h, src, size, &batch);
+  pthread_mutex_unlock(&info->lock);
+  complete_rma(info, &batch);
+}
+
+void chpl_comm_put_unordered_fence(void) {
+  fence_infos(flush_rma, true);
+}
+
+void chpl_comm_put_unordered_task_fence(void) {
+  fence_infos(flush_rma, false);
+}
+
+
+////////////////////////////////////////
+//
+// Atomic updates
+//
+
+#ifndef CHPL_COMM_IMPL_UNORDERED_GET
+
+void chpl_comm_amo_unordered_apply(chpl_comm_amo_unordered_t* v, size_t n) {
+  size_t i;
+
+#define APPLY_INT_AMO(type, field)                                      \
+  switch ((chpl_comm_amo_op_t) v[i].op) {                               \
+  case chpl_comm_amo_and:                                               \
+    (void) atomic_fetch_and_ ## type((atomic_ ## type*) v[i].object,    \
+                                     v[i].operand.field);               \
+    break;                                                              \
+  case chpl_comm_amo_or:                                                \
+    (void) atomic_fetch_or_ ## type((atomic_ ## type*) v[i].object,     \
+                                    v[i].operand.field);                \
+    break;                                                              \
+  case chpl_comm_amo_xor:                                               \
+    (void) atomic_fetch_xor_ ## type((atomic_ ## type*) v[i].object,    \
+                                     v[i].operand.field);               \
+    break;                                                              \
+  case chpl_comm_amo_add:                                               \
+    (void) atomic_fetch_add_ ## type((atomic_ ## type*) v[i].object,    \
+                                     v[i].operand.field);               \
+    break;                                                              \
+  }
+
+  for (i = 0; i < n; i++) {
+    switch ((chpl_comm_amo_type_t) v[i].type) {
+    case chpl_comm_amo_int32:
+      APPLY_INT_AMO(int_least32_t, i32);
+      break;
+    case chpl_comm_amo_int64:
+      APPLY_INT_AMO(int_least64_t, i64);
+      break;
+    case chpl_comm_amo_uint32:
+      APPLY_INT_AMO(uint_least32_t, u32);
+      break;
+    case chpl_comm_amo_uint64:
+      APPLY_INT_AMO(uint_least64_t, u64);
+      break;
+    case chpl_comm_amo_real32:
+      (void) atomic_fetch_add__real32((atomic__real32*) v[i].object,
+                                      v[i].operand.r32);
+      break;
+    case chpl_comm_amo_real64:
+      (void) atomic_fetch_add__real64((atomic__real64*) v[i].object,
+                                      v[i].operand.r64);
+      break;
+    }
+  }
+
+#undef APPLY_INT_AMO
+}
+
+
+//
+// Take a thread's buffered updates for one node out of its info, for
+// send_amo() to ship.  Called with the info locked.
+//
+static inline
+size_t take_amo(unordered_info_t* info, c_nodeid_t node,
+                chpl_comm_amo_unordered_t** buf_p) {
+  size_t n = info->amo_cnt[node];
+
+  if (n > 0) {
+    *buf_p = info->amo_buf[node];
+    info->amo_buf[node] = NULL;
+    info->amo_cnt[node] = 0;
+    atomic_fetch_add_uint_least32_t(&info->in_flight, 1);
+  }
+  return n;
+}
+
+//
+// Ship updates taken by take_amo() and wait for them to be applied.
+// Called with the info unlocked.
+//
+static inline
+void send_amo(unordered_info_t* info, c_nodeid_t node,
+              chpl_comm_amo_unordered_t* buf, size_t n) {
+  if (n > 0) {
+    chpl_comm_impl_amo_unordered_send(node, buf, n);
+    chpl_mem_free(buf, 0, 0);
+    atomic_fetch_sub_uint_least32_t(&info->in_flight, 1);
+  }
+}
+
+static
+void flush_amo(unordered_info_t* info) {
+  chpl_comm_amo_unordered_t* buf = NULL;
+  c_nodeid_t node;
+  size_t n;
+
+  for (node = 0; node < chpl_numNodes; node++) {
+    pthread_mutex_lock(&info->lock);
+    n = take_amo(info, node, &buf);
+    pthread_mutex_unlock(&info->lock);
+    send_amo(info, node, buf, n);
+  }
+}
+
+static inline
+void add_amo(c_nodeid_t node, void* object, chpl_comm_amo_op_t op,
+             chpl_comm_amo_type_t type, const chpl_comm_amo_unordered_t* amo) {
+  unordered_info_t* info = get_info();
+  chpl_comm_amo_unordered_t* p;
+  chpl_comm_amo_unordered_t* buf = NULL;
+  size_t n = 0;
+
+  pthread_mutex_lock(&info->lock);
+  if (info->amo_buf[node] == NULL) {
+    info->amo_buf[node] = (chpl_comm_amo_unordered_t*)
+                          chpl_mem_allocMany(amo_buff_size, sizeof(*p),
+                                             CHPL_RT_MD_COMM_XMIT_RCV_BUF,
+                                             0, 0);
+  }
+  p = &info->amo_buf[node][info->amo_cnt[node]++];
+  *p = *amo;
+  p->object = object;
+  p->op = (uint8_t) op;
+  p->type = (uint8_t) type;
+  if (info->amo_cnt[node] == amo_buff_size)
+    n = take_amo(info, node, &buf);
+  pthread_mutex_unlock(&info->lock);
+  send_amo(info, node, buf, n);
+}
+
+#define DEFINE_PROC_ATOMIC_UNORDERED(fnOp, amoOp, fnType, amoType,      \
+                                     Type, field, negate)               \
+  void chpl_comm_proc_atomic_ ## fnOp ## _unordered_ ## fnType          \
+         (void* operand, c_nodeid_t node, void* object,                 \
+          int ln, int32_t fn) {                                         \
+    chpl_comm_amo_unordered_t amo;                                      \
+    amo.operand.field = negate(*(Type*) operand);                       \
+    amo.object = object;                                                \
+    amo.op = (uint8_t) amoOp;                                           \
+    amo.type = (uint8_t) amoType;                                       \
+    if (node == chpl_nodeID)                                            \
+      chpl_comm_amo_unordered_apply(&amo, 1);                           \
+    else                                                                \
+      add_amo(node, object, amoOp, amoType, &amo);                      \
+  }
+
+#define NO_NEGATE(x) (x)
+// Integer negation is done unsigned so that it wraps.
+#define NEGATE_I32(x) ((int32_t) (0 - (uint32_t) (x)))
+#define NEGATE_I64(x) ((int64_t) (0 - (uint64_t) (x)))
+#define NEGATE_U_OR_R(x) (-(x))
+
+#define DEFINE_PROC_ATOMIC_UNORDERED_INT(fnOp, amoOp)                   \
+  DEFINE_PROC_ATOMIC_UNORDERED(fnOp, amoOp, int32, chpl_comm_amo_int32, \
+                               int32_t, i32, NO_NEGATE)                 \
+  DEFINE_PROC_ATOMIC_UNORDERED(fnOp, amoOp, int64, chpl_comm_amo_int64, \
+                               int64_t, i64, NO_NEGATE)                 \
+  DEFINE_PROC_ATOMIC_UNORDERED(fnOp, amoOp, uint32,                     \
+                               chpl_comm_amo_uint32,                    \
+                               uint32_t, u32, NO_NEGATE)                \
+  DEFINE_PROC_ATOMIC_UNORDERED(fnOp, amoOp, uint64,                     \
+                               chpl_comm_amo_uint64,                    \
+                               uint64_t, u64, NO_NEGATE)
+
+DEFINE_PROC_ATOMIC_UNORDERED_INT(and, chpl_comm_amo_and)
+DEFINE_PROC_ATOMIC_UNORDERED_INT(or, chpl_comm_amo_or)
+DEFINE_PROC_ATOMIC_UNORDERED_INT(xor, chpl_comm_amo_xor)
+DEFINE_PROC_ATOMIC_UNORDERED_INT(add, chpl_comm_amo_add)
+DEFINE_PROC_ATOMIC_UNORDERED(add, chpl_comm_amo_add, real32,
+                             chpl_comm_amo_real32, float, r32, NO_NEGATE)
+DEFINE_PROC_ATOMIC_UNORDERED(add, chpl_comm_amo_add, real64,
+                             chpl_comm_amo_real64, double, r64, NO_NEGATE)
+
+// Subtraction is addition of the negated operand.
+DEFINE_PROC_ATOMIC_UNORDERED(sub, chpl_comm_amo_add, int32,
+                             chpl_comm_amo_int32, int32_t, i32, NEGATE_I32)
+DEFINE_PROC_ATOMIC_UNORDERED(sub, chpl_comm_amo_add, int64,
+                             chpl_comm_amo_int64, int64_t, i64, NEGATE_I64)
+DEFINE_PROC_ATOMIC_UNORDERED(sub, chpl_comm_amo_add, uint32,
+                             chpl_comm_amo_uint32, uint32_t, u32,
+                             NEGATE_U_OR_R)
+DEFINE_PROC_ATOMIC_UNORDERED(sub, chpl_comm_amo_add, uint64,
+                             chpl_comm_amo_uint64, uint64_t, u64,
+                             NEGATE_U_OR_R)
+DEFINE_PROC_ATOMIC_UNORDERED(sub, chpl_comm_amo_add, real32,
+                             chpl_comm_amo_real32, float, r32, NEGATE_U_OR_R)
+DEFINE_PROC_ATOMIC_UNORDERED(sub, chpl_comm_amo_add, real64,
+                             chpl_comm_amo_real64, double, r64, NEGATE_U_OR_R)
+
+#undef DEFINE_PROC_ATOMIC_UNORDERED_INT
+#undef DEFINE_PROC_ATOMIC_UNORDERED
+
+void chpl_comm_proc_atomic_unordered_fence(void) {
+  fence_infos(flush_amo, true);
+}
+
+void chpl_comm_proc_atomic_unordered_task_fence(void) {
+  fence_infos(flush_amo, false);
+}
+
+#endif // CHPL_COMM_IMPL_UNORDERED_GET
+
+
+//
+// Fence everything
+//
+static
+void flush_all(unordered_info_t* info) {
+  flush_rma(info);
+#ifndef CHPL_COMM_IMPL_UNORDERED_GET
+  flush_amo(info);
+#endif
+}
+
+void chpl_comm_unordered_task_fence(void) {
+#ifdef CHPL_COMM_IMPL_UNORDERED_GET
+  // The comm layer's own unordered operations
+  chpl_comm_get_unordered_task_fence();
+  chpl_comm_atomic_unordered_task_fence();
+#endif
+  fence_infos(flush_all, false);
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ * 
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ * 
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "chplrt.h"
+#include "chpl-hash.h"
+
+#include <string.h>
+
+//
+// Unaligned little-endian-as-stored loads.  The compiler turns the
+// memcpy()s into single loads.
+//
+static inline uint64_t read64(const uint8_t* p) {
+  uint64_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static inline uint64_t read32(const uint8_t* p) {
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+// Reads 1 to 3 bytes, covering all of them.
+static inline uint64_t readSmall(const uint8_t* p, int64_t len) {
+  return ((uint64_t) p[0] << 16) | ((uint64_t) p[len >> 1] << 8) | p[len - 1];
+}
+
+uint64_t chpl_hash_bytes(const void* key, int64_t len, uint64_t seed) {
+  const uint8_t* p = (const uint8_t*) key;
+  uint64_t a, b;
+
+  seed ^= chpl_hash_mix(seed ^ CHPL_HASH_SECRET0, CHPL_HASH_SECRET1);
+
+  if (len <= 16) {
+    if (len >= 4) {
+      // two overlapping pairs of 4-byte reads cover 4 to 16 bytes
+      const int64_t off = (len >> 3) << 2;
+      a = (read32(p) << 32) | read32(p + off);
+      b = (read32(p + len - 4) << 32) | read32(p + len - 4 - off);
+    } else if (len > 0) {
+      a = readSmall(p, len);
+      b = 0;
+    } else {
+      a = b = 0;
+    }
+  } else {
+    int64_t i = len;
+    if (i > 48) {
+      uint64_t seed1 = seed, seed2 = seed;
+      do {
+        seed = chpl_hash_mix(read64(p) ^ CHPL_HASH_SECRET1,
+                             read64(p + 8) ^ seed);
+        seed1 = chpl_hash_mix(read64(p + 16) ^ CHPL_HASH_SECRET2,
+                              read64(p + 24) ^ seed1);
+        seed2 = chpl_hash_mix(read64(p + 32) ^ CHPL_HASH_SECRET3,
+                              read64(p + 40) ^ seed2);
+        p += 48;
+        i -= 48;
+      } while (i > 48);
+      seed ^= seed1 ^ seed2;
+    }
+    while (i > 16) {
+      seed = chpl_hash_mix(read64(p) ^ CHPL_HASH_SECRET1, read64(p + 8) ^ seed);
+      p += 16;
+      i -= 16;
+    }
+    // the last 16 bytes, overlapping ones already mixed in if need be
+    a = read64(p + i - 16);
+    b = read64(p + i - 8);
+  }
+
+  return chpl_hash_mix(CHPL_HASH_SECRET1 ^ (uint64_t) len,
+                       chpl_hash_mix(a ^ CHPL_HASH_SECRET1, b ^ seed));
+}
@@ -31,6 +31,7 @@
 #include "chplmemtrack.h"
 #include "chpl-privatization.h"
 #include "chpl-tasks.h"
+#include "chpl-tasks-profile.h"
 #include "chpl-topo.h"
 #include "chpl-linefile-support.h"
 #include "chplsys.h"
@@ -189,9 +190,15 @@ void chpl_rt_init(int argc, char* argv[]) {
   //
   chpl_task_init();
 
+  // Start task profiling, if requested.
+  chpl_task_profile_init();
+
   // Initialize privatization, needs to happen before hitting module init
   chpl_privatization_init();
 
+  // Set up the portable unordered communication operations.
+  chpl_comm_unordered_init();
+
   //
   // Some comm layer initialization has to wait until after the
   // tasking layer is initialized.
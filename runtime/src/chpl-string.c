@@ -21,6 +21,8 @@
 #include "chpl-string.h"
 #include "chpl-gen-includes.h"
 
+#include <string.h>
+
 struct chpl_chpl____wide_chpl_string_s {
   chpl_localeID_t locale;
   chpl_string addr;
@@ -126,3 +128,205 @@ uint8_t* chpl__getInPlaceBufferData(chpl__inPlaceBuffer* buf) {
 uint8_t* chpl__getInPlaceBufferDataForWrite(chpl__inPlaceBuffer* buf) {
   return chpl__getInPlaceBufferData(buf);
 }
+
+
+//
+// Byte string search.
+//
+// Forward searches look for candidate positions with memchr() on the
+// needle's first byte and check the last byte before comparing the rest
+// with memcmp().  Both of those are vectorized in the C libraries we
+// use, so this is fast for typical text.  It can be quadratic on
+// repetitive input, though, so if verifying candidates costs much more
+// than the distance they let us advance, we switch to the Two-Way
+// algorithm (Crochemore and Perrin, 1991), which is linear in the worst
+// case and uses constant space.
+//
+
+#define BYTESET_BIT(set, b) \
+  ((set)[(size_t) (b) / (8 * sizeof(*(set)))] \
+   & ((size_t) 1 << ((size_t) (b) % (8 * sizeof(*(set))))))
+#define BYTESET_ADD(set, b) \
+  ((set)[(size_t) (b) / (8 * sizeof(*(set)))] \
+   |= ((size_t) 1 << ((size_t) (b) % (8 * sizeof(*(set))))))
+
+static
+const uint8_t* twoway_find(const uint8_t* h, const uint8_t* hEnd,
+                           const uint8_t* n, size_t l) {
+  size_t i, ip, jp, k, p, ms, p0, mem, mem0;
+  size_t byteset[32 / sizeof(size_t)] = { 0 };
+  size_t shift[256];
+
+  // For the bytes in the needle, how far from its end they last occur.
+  for (i = 0; i < l; i++) {
+    BYTESET_ADD(byteset, n[i]);
+    shift[n[i]] = i + 1;
+  }
+
+  // Find the critical factorization: the maximal suffix under both
+  // byte orders, and the period of the needle.
+  ip = -1; jp = 0; k = p = 1;
+  while (jp + k < l) {
+    if (n[ip + k] == n[jp + k]) {
+      if (k == p) {
+        jp += p;
+        k = 1;
+      } else {
+        k++;
+      }
+    } else if (n[ip + k] > n[jp + k]) {
+      jp += k;
+      k = 1;
+      p = jp - ip;
+    } else {
+      ip = jp++;
+      k = p = 1;
+    }
+  }
+  ms = ip;
+  p0 = p;
+
+  ip = -1; jp = 0; k = p = 1;
+  while (jp + k < l) {
+    if (n[ip + k] == n[jp + k]) {
+      if (k == p) {
+        jp += p;
+        k = 1;
+      } else {
+        k++;
+      }
+    } else if (n[ip + k] < n[jp + k]) {
+      jp += k;
+      k = 1;
+      p = jp - ip;
+    } else {
+      ip = jp++;
+      k = p = 1;
+    }
+  }
+  if (ip + 1 > ms + 1)
+    ms = ip;
+  else
+    p = p0;
+
+  // If the needle isn't periodic we can't reuse any matched prefix.
+  if (memcmp(n, n + p, ms + 1) != 0) {
+    mem0 = 0;
+    p = ((ms > l - ms - 1) ? ms : l - ms - 1) + 1;
+  } else {
+    mem0 = l - p;
+  }
+  mem = 0;
+
+  for (;;) {
+    if ((size_t) (hEnd - h) < l)
+      return NULL;
+
+    // Check the last byte first, and skip ahead on a mismatch.
+    if (BYTESET_BIT(byteset, h[l - 1])) {
+      k = l - shift[h[l - 1]];
+      if (k) {
+        if (k < mem)
+          k = mem;
+        h += k;
+        mem = 0;
+        continue;
+      }
+    } else {
+      h += l;
+      mem = 0;
+      continue;
+    }
+
+    // Compare the right half, then the left.
+    for (k = (ms + 1 > mem) ? ms + 1 : mem; k < l && n[k] == h[k]; k++)
+      ;
+    if (k < l) {
+      h += k - ms;
+      mem = 0;
+      continue;
+    }
+    for (k = ms + 1; k > mem && n[k - 1] == h[k - 1]; k--)
+      ;
+    if (k <= mem)
+      return h;
+    h += p;
+    mem = mem0;
+  }
+}
+
+#undef BYTESET_BIT
+#undef BYTESET_ADD
+
+
+int64_t chpl_bytes_find(const uint8_t* hay, int64_t hayLen,
+                        const uint8_t* needle, int64_t needleLen) {
+  const uint8_t* p;
+  const uint8_t* last;
+  const uint8_t first = needle[0];
+  const uint8_t lastByte = needle[needleLen - 1];
+  int64_t work = 0;
+
+  if (needleLen > hayLen)
+    return -1;
+
+  if (needleLen == 1) {
+    p = memchr(hay, first, hayLen);
+    return (p == NULL) ? -1 : p - hay;
+  }
+
+  p = hay;
+  last = hay + (hayLen - needleLen);     // last possible match start
+  while (p <= last) {
+    p = memchr(p, first, last - p + 1);
+    if (p == NULL)
+      return -1;
+    if (p[needleLen - 1] == lastByte
+        && memcmp(p + 1, needle + 1, needleLen - 2) == 0)
+      return p - hay;
+
+    // If checking candidates is costing more than scanning, fall back.
+    work += needleLen;
+    if (work > 2 * (p - hay) + 256 && needleLen > 2) {
+      p = twoway_find(p + 1, hay + hayLen, needle, needleLen);
+      return (p == NULL) ? -1 : p - hay;
+    }
+    p++;
+  }
+  return -1;
+}
+
+
+int64_t chpl_bytes_rfind(const uint8_t* hay, int64_t hayLen,
+                         const uint8_t* needle, int64_t needleLen) {
+  const uint8_t first = needle[0];
+  const uint8_t lastByte = needle[needleLen - 1];
+  int64_t i;
+
+  //
+  // There's no portable reverse memchr(), so this just scans backward
+  // checking the first and last bytes before comparing the rest.
+  //
+  for (i = hayLen - needleLen; i >= 0; i--) {
+    if (hay[i] == first && hay[i + needleLen - 1] == lastByte
+        && memcmp(hay + i, needle, needleLen) == 0)
+      return i;
+  }
+  return -1;
+}
+
+
+int64_t chpl_bytes_count(const uint8_t* hay, int64_t hayLen,
+                         const uint8_t* needle, int64_t needleLen) {
+  int64_t count = 0;
+  int64_t off = 0;
+  int64_t pos;
+
+  while (off + needleLen <= hayLen
+         && (pos = chpl_bytes_find(hay + off, hayLen - off,
+                                   needle, needleLen)) >= 0) {
+    count++;
+    off += pos + 1;
+  }
+  return count;
+}
@@ -0,0 +1,375 @@
+/*
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// Task profiling (see chpl-tasks-profile.h).
+//
+#include "chplrt.h"
+
+#include "chpl-atomics.h"
+#include "chpl-comm.h"
+#include "chpl-env.h"
+#include "chpl-linefile-support.h"
+#include "chpl-mem.h"
+#include "chpl-tasks.h"
+#include "chpl-tasks-callbacks.h"
+#include "chpl-tasks-profile.h"
+#include "chpl-thread-local-storage.h"
+#include "error.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/param.h>
+
+
+typedef enum {
+  ev_create,
+  ev_begin,
+  ev_end,
+  ev_sync_wait
+} profile_ev_kind_t;
+
+typedef struct {
+  uint64_t time;                // ns, from chpl_task_profile_now()
+  uint64_t id;                  // task ID
+  uint64_t dur;                 // ev_sync_wait: ns spent waiting
+  int32_t  filename;            // ev_create, ev_sync_wait
+  int32_t  lineno;              //   "
+  int32_t  subloc;              // ev_begin
+  int32_t  kind;                // profile_ev_kind_t
+} profile_ev_t;
+
+//
+// A thread's events.  Only the owning thread writes to it, so no
+// locking is needed.  When it fills up the oldest events are replaced.
+//
+typedef struct profile_buf_s {
+  struct profile_buf_s* next;   // list of all buffers
+  int                   thread; // index of the owning thread
+  uint64_t              count;  // number of events ever recorded
+  profile_ev_t          evs[];
+} profile_buf_t;
+
+
+chpl_bool chpl_task_profiling = false;
+
+static const char*          profile_root;
+static uint64_t             profile_start;
+static uint64_t             profile_size;
+static atomic_uintptr_t     profile_bufs;   // profile_buf_t* list head
+static atomic_int_least32_t profile_num_threads;
+
+CHPL_TLS_DECL(profile_buf_t*, profile_buf);
+
+
+static void cb_task_create(const chpl_task_cb_info_t*);
+static void cb_task_begin(const chpl_task_cb_info_t*);
+static void cb_task_end(const chpl_task_cb_info_t*);
+
+
+void chpl_task_profile_init(void) {
+  profile_root = chpl_env_rt_get("TASK_PROFILE", NULL);
+  if (profile_root == NULL || profile_root[0] == '\0')
+    return;
+
+  profile_size = chpl_env_rt_get_int("TASK_PROFILE_EVENTS", 65536);
+  if (profile_size == 0)
+    profile_size = 1;
+  profile_start = chpl_task_profile_now();
+  atomic_init_uintptr_t(&profile_bufs, (uintptr_t) NULL);
+  atomic_init_int_least32_t(&profile_num_threads, 0);
+  CHPL_TLS_INIT(profile_buf);
+
+  if (chpl_task_install_callback(chpl_task_cb_event_kind_create,
+                                 chpl_task_cb_info_kind_full,
+                                 cb_task_create) != 0
+      || chpl_task_install_callback(chpl_task_cb_event_kind_begin,
+                                    chpl_task_cb_info_kind_full,
+                                    cb_task_begin) != 0
+      || chpl_task_install_callback(chpl_task_cb_event_kind_end,
+                                    chpl_task_cb_info_kind_id_only,
+                                    cb_task_end) != 0) {
+    (void) chpl_task_uninstall_callback(chpl_task_cb_event_kind_create,
+                                        cb_task_create);
+    (void) chpl_task_uninstall_callback(chpl_task_cb_event_kind_begin,
+                                        cb_task_begin);
+    chpl_warning("cannot install task profiling callbacks", 0, 0);
+    return;
+  }
+
+  chpl_task_profiling = true;
+}
+
+
+static profile_buf_t* get_profile_buf(void) {
+  profile_buf_t* buf = (profile_buf_t*) CHPL_TLS_GET(profile_buf);
+  uintptr_t head;
+
+  if (buf != NULL)
+    return buf;
+
+  buf = (profile_buf_t*)
+        chpl_mem_alloc(sizeof(profile_buf_t)
+                       + profile_size * sizeof(profile_ev_t),
+                       CHPL_RT_MD_TASK_LAYER_UNSPEC, 0, 0);
+  buf->thread = atomic_fetch_add_int_least32_t(&profile_num_threads, 1);
+  buf->count = 0;
+
+  do {
+    head = atomic_load_uintptr_t(&profile_bufs);
+    buf->next = (profile_buf_t*) head;
+  } while (!atomic_compare_exchange_strong_uintptr_t(&profile_bufs, head,
+                                                     (uintptr_t) buf));
+
+  CHPL_TLS_SET(profile_buf, buf);
+  return buf;
+}
+
+
+static inline
+profile_ev_t* next_ev(profile_ev_kind_t kind, uint64_t id) {
+  profile_buf_t* buf = get_profile_buf();
+  profile_ev_t* ev = &buf->evs[buf->count++ % profile_size];
+
+  ev->time = chpl_task_profile_now();
+  ev->kind = kind;
+  ev->id = id;
+  return ev;
+}
+
+
+static void cb_task_create(const chpl_task_cb_info_t* info) {
+  profile_ev_t* ev = next_ev(ev_create, info->iu.full.id);
+
+  ev->filename = info->iu.full.filename;
+  ev->lineno = info->iu.full.lineno;
+}
+
+
+static void cb_task_begin(const chpl_task_cb_info_t* info) {
+  profile_ev_t* ev = next_ev(ev_begin, info->iu.full.id);
+
+  ev->filename = info->iu.full.filename;
+  ev->lineno = info->iu.full.lineno;
+  ev->subloc = (int32_t) chpl_task_getRequestedSubloc();
+}
+
+
+static void cb_task_end(const chpl_task_cb_info_t* info) {
+  (void) next_ev(ev_end, info->iu.id_only.id);
+}
+
+
+void chpl_task_profile_sync_wait(uint64_t start,
+                                 int32_t lineno, int32_t filename) {
+  profile_ev_t* ev = next_ev(ev_sync_wait, (uint64_t) chpl_task_getId());
+
+  ev->dur = ev->time - start;
+  ev->time = start;
+  ev->filename = filename;
+  ev->lineno = lineno;
+}
+
+
+//
+// Writing the trace.
+//
+// Task events are gathered from all the buffers and sorted by task ID,
+// so that each task's create, begin, and end events can be matched up.
+// A task becomes a complete ("X") event on the thread that ran it,
+// whose arguments include how long it waited to start.  Each sync
+// variable wait is also a complete event, nested within its task.
+//
+typedef struct {
+  profile_ev_t ev;
+  int          thread;
+} profile_rec_t;
+
+
+static int rec_cmp(const void* v1, const void* v2) {
+  const profile_rec_t* r1 = (const profile_rec_t*) v1;
+  const profile_rec_t* r2 = (const profile_rec_t*) v2;
+
+  if (r1->ev.id != r2->ev.id)
+    return (r1->ev.id < r2->ev.id) ? -1 : 1;
+  if (r1->ev.kind != r2->ev.kind)
+    return r1->ev.kind - r2->ev.kind;
+  if (r1->ev.time != r2->ev.time)
+    return (r1->ev.time < r2->ev.time) ? -1 : 1;
+  return 0;
+}
+
+
+static double to_usec(uint64_t t) {
+  return (t - profile_start) / 1000.0;
+}
+
+
+static void write_json_string(FILE* f, const char* s) {
+  fputc('"', f);
+  for ( ; *s != '\0'; s++) {
+    if (*s == '"' || *s == '\\')
+      fprintf(f, "\\%c", *s);
+    else if ((unsigned char) *s < 0x20)
+      fprintf(f, "\\u%04x", (unsigned char) *s);
+    else
+      fputc(*s, f);
+  }
+  fputc('"', f);
+}
+
+
+static void write_loc(FILE* f, int32_t filename, int32_t lineno) {
+  char loc[MAXPATHLEN + 16];
+
+  snprintf(loc, sizeof(loc), "%s:%d", chpl_lookupFilename(filename),
+           (int) lineno);
+  write_json_string(f, loc);
+}
+
+
+void chpl_task_profile_exit(void) {
+  char fname[MAXPATHLEN];
+  FILE* f;
+  profile_buf_t* buf;
+  profile_rec_t* recs;
+  size_t num_recs, i, j;
+  uint64_t dropped = 0;
+  const char* sep = "";
+
+  if (!chpl_task_profiling)
+    return;
+
+  (void) chpl_task_uninstall_callback(chpl_task_cb_event_kind_create,
+                                      cb_task_create);
+  (void) chpl_task_uninstall_callback(chpl_task_cb_event_kind_begin,
+                                      cb_task_begin);
+  (void) chpl_task_uninstall_callback(chpl_task_cb_event_kind_end,
+                                      cb_task_end);
+  chpl_task_profiling = false;
+
+  num_recs = 0;
+  for (buf = (profile_buf_t*) atomic_load_uintptr_t(&profile_bufs);
+       buf != NULL;
+       buf = buf->next) {
+    num_recs += (buf->count < profile_size) ? buf->count : profile_size;
+  }
+
+  recs = (profile_rec_t*) chpl_mem_alloc((num_recs + 1)
+                                         * sizeof(profile_rec_t),
+                                         CHPL_RT_MD_TASK_LAYER_UNSPEC, 0, 0);
+  num_recs = 0;
+  for (buf = (profile_buf_t*) atomic_load_uintptr_t(&profile_bufs);
+       buf != NULL;
+       buf = buf->next) {
+    uint64_t first = (buf->count < profile_size)
+                     ? 0 : buf->count - profile_size;
+    dropped += first;
+    for (i = 0; i < buf->count - first; i++) {
+      recs[num_recs].ev = buf->evs[(first + i) % profile_size];
+      recs[num_recs].thread = buf->thread;
+      num_recs++;
+    }
+  }
+  qsort(recs, num_recs, sizeof(profile_rec_t), rec_cmp);
+
+  snprintf(fname, sizeof(fname), "%s-%d.json", profile_root,
+           (int) chpl_nodeID);
+  if ((f = fopen(fname, "w")) == NULL) {
+    char msg[MAXPATHLEN + 64];
+    snprintf(msg, sizeof(msg), "cannot open task profile file %s", fname);
+    chpl_warning(msg, 0, 0);
+    chpl_mem_free(recs, 0, 0);
+    return;
+  }
+
+  fprintf(f, "{\"displayTimeUnit\":\"ms\",\n");
+  fprintf(f, "\"otherData\":{\"locale\":%d,\"droppedEvents\":%" PRIu64 "},\n",
+          (int) chpl_nodeID, dropped);
+  fprintf(f, "\"traceEvents\":[\n");
+
+  fprintf(f, "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":%d,\"tid\":0,"
+          "\"args\":{\"name\":\"locale %d\"}}",
+          (int) chpl_nodeID, (int) chpl_nodeID);
+  sep = ",\n";
+  for (i = 0; i < (size_t) atomic_load_int_least32_t(&profile_num_threads);
+       i++) {
+    fprintf(f, "%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":%d,"
+            "\"tid\":%d,\"args\":{\"name\":\"thread %d\"}}",
+            sep, (int) chpl_nodeID, (int) i, (int) i);
+  }
+
+  for (i = 0; i < num_recs; i = j) {
+    profile_rec_t* create = NULL;
+    profile_rec_t* begin = NULL;
+    profile_rec_t* end = NULL;
+
+    for (j = i; j < num_recs && recs[j].ev.id == recs[i].ev.id; j++) {
+      profile_rec_t* r = &recs[j];
+
+      switch ((profile_ev_kind_t) r->ev.kind) {
+      case ev_create:
+        create = r;
+        break;
+      case ev_begin:
+        begin = r;
+        break;
+      case ev_end:
+        end = r;
+        break;
+      case ev_sync_wait:
+        fprintf(f, "%s{\"ph\":\"X\",\"cat\":\"sync\",\"name\":\"sync wait\","
+                "\"pid\":%d,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,"
+                "\"args\":{\"task\":%" PRIu64 ",\"at\":",
+                sep, (int) chpl_nodeID, r->thread, to_usec(r->ev.time),
+                r->ev.dur / 1000.0, r->ev.id);
+        write_loc(f, r->ev.filename, r->ev.lineno);
+        fprintf(f, "}}");
+        break;
+      }
+    }
+
+    //
+    // Tasks whose begin or end was lost (to a full buffer, or because
+    // it was still running) are left out.
+    //
+    if (begin == NULL || end == NULL)
+      continue;
+
+    fprintf(f, "%s{\"ph\":\"X\",\"cat\":\"task\",\"name\":", sep);
+    write_loc(f, begin->ev.filename, begin->ev.lineno);
+    fprintf(f, ",\"pid\":%d,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,"
+            "\"args\":{\"task\":%" PRIu64 ",\"sublocale\":%d",
+            (int) chpl_nodeID, begin->thread, to_usec(begin->ev.time),
+            (end->ev.time - begin->ev.time) / 1000.0, begin->ev.id,
+            (int) begin->ev.subloc);
+    if (create != NULL)
+      fprintf(f, ",\"createdOnThread\":%d,\"queuedUs\":%.3f",
+              create->thread,
+              (begin->ev.time - create->ev.time) / 1000.0);
+    fprintf(f, "}}");
+  }
+
+  fprintf(f, "\n]}\n");
+  fclose(f);
+
+  chpl_mem_free(recs, 0, 0);
+}
@@ -24,6 +24,7 @@
 #include "chplexit.h"
 #include "chpl-mem.h"
 #include "chplmemtrack.h"
+#include "chpl-tasks-profile.h"
 #include "chpl-topo.h"
 #include "gdb.h"
 
@@ -38,6 +39,7 @@ static void chpl_exit_common(int status, int all) {
   }
   chpl_comm_pre_task_exit(all);
   if (all) {
+    chpl_task_profile_exit();
     chpl_task_exit();
     chpl_reportMemInfo();
   }
@@ -20,6 +20,7 @@
 #include "chplrt.h"
 
 #include "chplmemtrack.h"
+#include "chpl-atomics.h"
 #include "chpl-mem.h"
 #include "chpl-mem-desc.h"
 #include "chpl-mem-sys.h"  // mem layer not initialized yet, need system alloc
@@ -28,6 +29,7 @@
 #include "chpl-comm.h"
 #include "chplcgfns.h"
 #include "chpl-linefile-support.h"
+#include "chpl-thread-local-storage.h"
 #include "config.h"
 #include "error.h"
 
@@ -58,6 +60,8 @@ extern void chpl_memTracking_returnConfigVals(chpl_bool* memTrack,
                                               chpl_bool* memLeaks,
                                               size_t* memMax,
                                               size_t* memThreshold,
+                                              size_t* memSample,
+                                              chpl_bool* memSampleByCount,
                                               c_string* memLog,
                                               c_string* memLeaksLog);
 
@@ -66,6 +70,7 @@ chpl_bool chpl_memTrack = false;
 typedef struct memTableEntry_struct { /* table entry */
   size_t number;
   size_t size;
+  size_t weight;        /* allocations this entry stands for (sampling) */
   chpl_mem_descInt_t description;
   void* memAlloc;
   int32_t lineno;
@@ -73,16 +78,13 @@ typedef struct memTableEntry_struct { /* table entry */
   struct memTableEntry_struct* nextInBucket;
 } memTableEntry;
 
-#define NUM_HASH_SIZE_INDICES 20
+#define NUM_HASH_SIZE_INDICES 24
 
-static int hashSizes[NUM_HASH_SIZE_INDICES] = { 1543, 3079, 6151, 12289, 24593, 49157, 98317,
+static int hashSizes[NUM_HASH_SIZE_INDICES] = { 97, 193, 389, 769,
+                                                1543, 3079, 6151, 12289, 24593, 49157, 98317,
                                                 196613, 393241, 786433, 1572869, 3145739,
                                                 6291469, 12582917, 25165843, 50331653,
                                                 100663319, 201326611, 402653189, 805306457 };
-static int hashSizeIndex = 0;
-static int hashSize = 0;
-
-static memTableEntry** memTable = NULL;
 
 static _Bool memStats = false;
 static _Bool memLeaksByType = false;
@@ -90,39 +92,148 @@ static c_string memLeaksByDesc = "";
 static _Bool memLeaks = false;
 static size_t memMax = 0;
 static size_t memThreshold = 0;
+static size_t memSample = 0;
+static _Bool memSampleByCount = false;
 static c_string memLog = NULL;
 static FILE* memLogFile = NULL;
 static c_string memLeaksLog = NULL;
 
-static size_t totalMem = 0;       /* total memory currently allocated */
-static size_t maxMem = 0;         /* maximum total memory during run  */
-static size_t totalAllocated = 0; /* total memory allocated */
-static size_t totalFreed = 0;     /* total memory freed */
-static size_t totalEntries = 0;     /* number of entries in hash table */
+static atomic_uint_least64_t totalMem; /* total memory currently allocated */
+static atomic_uint_least64_t maxMem;   /* maximum total memory during run  */
 
 
+//
+// The table of tracked allocations is split into shards, each with its
+// own lock and its own hash table, and an allocation is tracked in the
+// shard its address hashes to.  Allocating and freeing threads thus
+// rarely contend, and a shard that outgrows its table only has to
+// rehash its own entries.  We shard by address rather than by thread
+// because memory is often freed by a different thread than the one
+// that allocated it.
+//
 // We can't use a sync var for concurrency control here.  The Qthreads
 // internal memory allocator shim references this memory tracking code
 // via the Chapel runtime public memory layer interface.  Referring to a
 // sync var here when exiting (to report memTrack results, say), after
 // the tasking layer is shut down, ends up trying to create a qthread in
-// the terminated Qthreads library.  Chaos results.  We also cannot use
-// an atomic var, because with CHPL_ATOMICS=locks those are implemented
-// by means of sync vars.  So, we use a pthread mutex.  Note that this
-// is only safe if we cannot switch tasks on a pthread while holding the
-// mutex and then try to lock it recursively.  Currently that is the
-// case, since we do not yield while holding the mutex.
-// 
-static pthread_mutex_t memTrack_lockVar = PTHREAD_MUTEX_INITIALIZER;
+// the terminated Qthreads library.  Chaos results.  So, we use pthread
+// mutexes.  Note that this is only safe if we cannot switch tasks on a
+// pthread while holding a mutex and then try to lock it recursively.
+// Currently that is the case, since we do not yield while holding the
+// mutexes.  The running totals (totalMem, maxMem) are runtime C atomics
+// instead, which never involve the tasking layer: even the
+// CHPL_ATOMICS=locks implementation of them uses pthread mutexes.
+//
+#define NUM_SHARDS_LOG2 6
+#define NUM_SHARDS (1 << NUM_SHARDS_LOG2)
+
+typedef struct {
+  pthread_mutex_t lock;
+  memTableEntry** table;
+  int hashSizeIndex;
+  int hashSize;
+  size_t entries;        /* number of entries in hash table */
+  size_t allocated;      /* memory allocated, via this shard */
+  size_t freed;          /* memory freed, via this shard */
+} __attribute__((aligned(128))) memTableShard;
+
+static memTableShard shards[NUM_SHARDS];
+
+static inline
+memTableShard* shardFor(void* memAlloc) {
+  uint64_t h = ((uint64_t) (uintptr_t) memAlloc >> 4)
+               * UINT64_C(0x9E3779B97F4A7C15);
+  return &shards[h >> (64 - NUM_SHARDS_LOG2)];
+}
 
 static inline
-void memTrack_lock(void) {
-  (void) pthread_mutex_lock(&memTrack_lockVar);
+void memTrack_lock(memTableShard* sh) {
+  (void) pthread_mutex_lock(&sh->lock);
 }
 
 static inline
-void memTrack_unlock(void) {
-  (void) pthread_mutex_unlock(&memTrack_lockVar);
+void memTrack_unlock(memTableShard* sh) {
+  (void) pthread_mutex_unlock(&sh->lock);
+}
+
+
+//
+// Sampling.  With memSample set, rather than tracking every allocation
+// we track about one allocation per memSample bytes allocated (or one
+// in memSample allocations, with memSampleByCount).  Each thread counts
+// down to its next sample privately, so allocations that aren't sampled
+// cost only a few instructions.  A sampled entry is weighted by the
+// number of allocations it stands for, and the reports and statistics
+// scale by that, so they estimate what full tracking would show.  The
+// interval between samples is randomized a little, so that programs
+// that allocate in a regular pattern aren't sampled with a bias.
+//
+typedef struct {
+  int64_t countdown;
+  uint64_t rand;
+  uint64_t weightRem;   /* bytes of weight not yet given to an entry */
+} sampleState;
+
+CHPL_TLS_DECL(sampleState*, memSampleState);
+
+static inline
+uint64_t sampleInterval(sampleState* ss) {
+  // xorshift64; uniform in [1, 2*memSample], which has mean ~memSample
+  ss->rand ^= ss->rand << 13;
+  ss->rand ^= ss->rand >> 7;
+  ss->rand ^= ss->rand << 17;
+  return 1 + ss->rand % (2 * (uint64_t) memSample);
+}
+
+static
+sampleState* sampleStateHere(void) {
+  sampleState* ss = (sampleState*) CHPL_TLS_GET(memSampleState);
+  if (ss == NULL) {
+    ss = (sampleState*) sys_calloc(1, sizeof(*ss));
+    ss->rand = UINT64_C(0x2545F4914F6CDD1D) ^ (uint64_t) (uintptr_t) ss;
+    ss->countdown = sampleInterval(ss);
+    CHPL_TLS_SET(memSampleState, ss);
+  }
+  return ss;
+}
+
+//
+// Returns the number of allocations a new allocation of the given size
+// should be tracked as standing for, or 0 if it shouldn't be tracked.
+//
+static inline
+size_t sampleWeight(size_t chunk) {
+  sampleState* ss;
+  uint64_t samples;
+  uint64_t bytes;
+
+  if (memSample == 0)
+    return 1;
+
+  ss = sampleStateHere();
+  ss->countdown -= (memSampleByCount ? 1 : (int64_t) chunk);
+  if (ss->countdown > 0)
+    return 0;
+  if (memSampleByCount || chunk >= memSample || chunk == 0) {
+    ss->countdown = sampleInterval(ss);
+    return memSampleByCount ? memSample : 1;
+  }
+
+  //
+  // Sample points fall every memSample bytes on average.  Keep the part
+  // of the interval that this allocation overshot, and count each point
+  // it covered, so that none are lost.  The samples stand for a number
+  // of bytes that is rarely a whole number of chunks; carry the fraction
+  // to this thread's next sample rather than rounding it away.
+  //
+  samples = 0;
+  do {
+    ss->countdown += sampleInterval(ss);
+    samples++;
+  } while (ss->countdown <= 0);
+  bytes = samples * memSample + ss->weightRem;
+  ss->weightRem = bytes % chunk;
+  return bytes / chunk;
 }
 
 
@@ -152,6 +263,8 @@ void chpl_setMemFlags(void) {
                                     &memLeaks,
                                     &memMax,
                                     &memThreshold,
+                                    &memSample,
+                                    &memSampleByCount,
                                     &memLog,
                                     &memLeaksLog);
 
@@ -161,6 +274,7 @@ void chpl_setMemFlags(void) {
       || (memLeaksByDesc && strcmp(memLeaksByDesc, ""))
       || memLeaks
       || memMax > 0
+      || memSample > 0
       || memLeaksLog != NULL) {
     chpl_memTrack = true;
   }
@@ -179,9 +293,17 @@ void chpl_setMemFlags(void) {
   }
 
   if (chpl_memTrack) {
-    hashSizeIndex = 0;
-    hashSize = hashSizes[hashSizeIndex];
-    memTable = sys_calloc(hashSize, sizeof(memTableEntry*));
+    int s;
+    atomic_init_uint_least64_t(&totalMem, 0);
+    atomic_init_uint_least64_t(&maxMem, 0);
+    CHPL_TLS_INIT(memSampleState);
+    for (s = 0; s < NUM_SHARDS; s++) {
+      memTableShard* sh = &shards[s];
+      (void) pthread_mutex_init(&sh->lock, NULL);
+      sh->hashSizeIndex = 0;
+      sh->hashSize = hashSizes[sh->hashSizeIndex];
+      sh->table = sys_calloc(sh->hashSize, sizeof(memTableEntry*));
+    }
   }
 }
 
@@ -198,37 +320,49 @@ static unsigned hash(void* memAlloc, int hashSize) {
 }
 
 
-static void increaseMemStat(size_t chunk, int32_t lineno, int32_t filename) {
-  totalMem += chunk;
-  totalAllocated += chunk;
-  if (memMax && (totalMem > memMax)) {
+static void increaseMemStat(memTableShard* sh, size_t chunk,
+                            int32_t lineno, int32_t filename) {
+  uint64_t now, max;
+
+  sh->allocated += chunk;
+  now = atomic_fetch_add_explicit_uint_least64_t(&totalMem, chunk,
+                                                 memory_order_relaxed)
+        + chunk;
+  if (memMax && (now > memMax)) {
     chpl_error("Exceeded memory limit", lineno, filename);
   }
-  if (totalMem > maxMem)
-    maxMem = totalMem;
+  max = atomic_load_explicit_uint_least64_t(&maxMem, memory_order_relaxed);
+  while (now > max) {
+    if (atomic_compare_exchange_weak_explicit_uint_least64_t(
+          &maxMem, max, now, memory_order_relaxed))
+      break;
+    max = atomic_load_explicit_uint_least64_t(&maxMem,
+                                              memory_order_relaxed);
+  }
 }
 
 
-static void decreaseMemStat(size_t chunk) {
-  totalMem -= chunk; // > totalMem ? 0 : totalMem - chunk;
-  totalFreed += chunk;
+static void decreaseMemStat(memTableShard* sh, size_t chunk) {
+  (void) atomic_fetch_sub_explicit_uint_least64_t(&totalMem, chunk,
+                                                  memory_order_relaxed);
+  sh->freed += chunk;
 }
 
 
 static void
-resizeTable(int direction) {
+resizeTable(memTableShard* sh, int direction) {
   memTableEntry** newMemTable = NULL;
   int newHashSizeIndex, newHashSize, newHashValue;
   int i;
   memTableEntry* me;
   memTableEntry* next;
 
-  newHashSizeIndex = hashSizeIndex + direction;
+  newHashSizeIndex = sh->hashSizeIndex + direction;
   newHashSize = hashSizes[newHashSizeIndex];
   newMemTable = sys_calloc(newHashSize, sizeof(memTableEntry*));
 
-  for (i = 0; i < hashSize; i++) {
-    for (me = memTable[i]; me != NULL; me = next) {
+  for (i = 0; i < sh->hashSize; i++) {
+    for (me = sh->table[i]; me != NULL; me = next) {
       next = me->nextInBucket;
       newHashValue = hash(me->memAlloc, newHashSize);
       me->nextInBucket = newMemTable[newHashValue];
@@ -236,20 +370,23 @@ resizeTable(int direction) {
     }
   }
 
-  sys_free(memTable);
-  memTable = newMemTable;
-  hashSize = newHashSize;
-  hashSizeIndex = newHashSizeIndex;
+  sys_free(sh->table);
+  sh->table = newMemTable;
+  sh->hashSize = newHashSize;
+  sh->hashSizeIndex = newHashSizeIndex;
 }
 
-static void addMemTableEntry(void *memAlloc, size_t number, size_t size,
+static void addMemTableEntry(memTableShard* sh,
+                             void *memAlloc, size_t number, size_t size,
+                             size_t weight,
                              chpl_mem_descInt_t description, int32_t lineno,
                              int32_t filename) {
   unsigned hashValue;
   memTableEntry* memEntry;
 
-  if ((totalEntries+1)*2 > hashSize && hashSizeIndex < NUM_HASH_SIZE_INDICES-1)
-    resizeTable(1);
+  if ((sh->entries+1)*2 > sh->hashSize
+      && sh->hashSizeIndex < NUM_HASH_SIZE_INDICES-1)
+    resizeTable(sh, 1);
 
   memEntry = (memTableEntry*) sys_calloc(1, sizeof(memTableEntry));
   if (!memEntry) {
@@ -257,33 +394,34 @@ static void addMemTableEntry(void *memAlloc, size_t number, size_t size,
                lineno, filename);
   }
 
-  hashValue = hash(memAlloc, hashSize);
-  memEntry->nextInBucket = memTable[hashValue];
-  memTable[hashValue] = memEntry;
+  hashValue = hash(memAlloc, sh->hashSize);
+  memEntry->nextInBucket = sh->table[hashValue];
+  sh->table[hashValue] = memEntry;
   memEntry->description = description;
   memEntry->memAlloc = memAlloc;
   memEntry->lineno = lineno;
   memEntry->filename = filename;
   memEntry->number = number;
   memEntry->size = size;
-  increaseMemStat(number*size, lineno, filename);
-  totalEntries += 1;
+  memEntry->weight = weight;
+  increaseMemStat(sh, number*size*weight, lineno, filename);
+  sh->entries += 1;
 }
 
 
-static memTableEntry* removeMemTableEntry(void* address) {
-  unsigned hashValue = hash(address, hashSize);
-  memTableEntry* thisBucketEntry = memTable[hashValue];
+static memTableEntry* removeMemTableEntry(memTableShard* sh, void* address) {
+  unsigned hashValue = hash(address, sh->hashSize);
+  memTableEntry* thisBucketEntry = sh->table[hashValue];
   memTableEntry* deletedBucket = NULL;
 
   if (!thisBucketEntry)
     return NULL;
 
   if (thisBucketEntry->memAlloc == address) {
-    memTable[hashValue] = thisBucketEntry->nextInBucket;
+    sh->table[hashValue] = thisBucketEntry->nextInBucket;
     deletedBucket = thisBucketEntry;
   } else {
-    for (thisBucketEntry = memTable[hashValue];
+    for (thisBucketEntry = sh->table[hashValue];
          thisBucketEntry != NULL;
          thisBucketEntry = thisBucketEntry->nextInBucket) {
 
@@ -296,15 +434,41 @@ static memTableEntry* removeMemTableEntry(void* address) {
     }
   }
   if (deletedBucket) {
-    decreaseMemStat(deletedBucket->number * deletedBucket->size);
-    totalEntries -= 1;
-    if (totalEntries*8 < hashSize && hashSizeIndex > 0)
-      resizeTable(-1);
+    decreaseMemStat(sh, deletedBucket->number * deletedBucket->size
+                        * deletedBucket->weight);
+    sh->entries -= 1;
+    if (sh->entries*8 < sh->hashSize && sh->hashSizeIndex > 0)
+      resizeTable(sh, -1);
   }
   return deletedBucket;
 }
 
 
+//
+// Lock all the shards, for reporting.  Shards are always locked in
+// index order, so this can't deadlock with itself.
+//
+static void memTrack_lockAll(void) {
+  int s;
+  for (s = 0; s < NUM_SHARDS; s++)
+    memTrack_lock(&shards[s]);
+}
+
+static void memTrack_unlockAll(void) {
+  int s;
+  for (s = NUM_SHARDS - 1; s >= 0; s--)
+    memTrack_unlock(&shards[s]);
+}
+
+
+static void printSampleNote(void) {
+  if (memSample > 0)
+    fprintf(memLogFile,
+            "(sampled about once per %zu %s; figures are estimates)\n",
+            memSample, memSampleByCount ? "allocations" : "bytes");
+}
+
+
 uint64_t chpl_memoryUsed(int32_t lineno, int32_t filename) {
   if (!chpl_memTrack) {
     chpl_warning("invalid call to memoryUsed(); rerun with --memTrack",
@@ -312,7 +476,7 @@ uint64_t chpl_memoryUsed(int32_t lineno, int32_t filename) {
     return 0;
   }
 
-  return (uint64_t)totalMem;
+  return atomic_load_uint_least64_t(&totalMem);
 }
 
 
@@ -343,18 +507,32 @@ void chpl_printMemAllocStats(int32_t lineno, int32_t filename) {
              nodeWidth, chpl_nodeID);
   }
 
+  //
+  // Gather the values.  The allocation and free sums are kept per
+  // shard.
+  //
+  size_t totalAllocated = 0;
+  size_t totalFreed = 0;
+
+  memTrack_lockAll();
+  for (int s = 0; s < NUM_SHARDS; s++) {
+    totalAllocated += shards[s].allocated;
+    totalFreed += shards[s].freed;
+  }
+  memTrack_unlockAll();
+
   //
   // Take a pre-run through the descriptions and values to figure
   // out how long each line will need to be.
   //
-  static const struct {
+  const struct {
     const char* desc;
-    size_t* val;
+    size_t val;
   } descsVals[] = {
-    { "Allocated Now:", &totalMem },
-    { "Allocation High Water Mark:", &maxMem },
-    { "Sum of Allocations:", &totalAllocated },
-    { "Sum of Frees:", &totalFreed },
+    { "Allocated Now:", atomic_load_uint_least64_t(&totalMem) },
+    { "Allocation High Water Mark:", atomic_load_uint_least64_t(&maxMem) },
+    { "Sum of Allocations:", totalAllocated },
+    { "Sum of Frees:", totalFreed },
   };
   const int nDescsVals = sizeof(descsVals) / sizeof(descsVals[0]);
 
@@ -366,9 +544,9 @@ void chpl_printMemAllocStats(int32_t lineno, int32_t filename) {
     if (thisDescWidth > descWidth)
       descWidth = thisDescWidth;
     const int thisMemWidth =
-                (*descsVals[i].val == 0)
+                (descsVals[i].val == 0)
                 ? 1
-                : (int) lrint(ceil(log10((double) *descsVals[i].val)));
+                : (int) lrint(ceil(log10((double) descsVals[i].val)));
     if (thisMemWidth > memWidth)
       memWidth = thisMemWidth;
   }
@@ -380,20 +558,17 @@ void chpl_printMemAllocStats(int32_t lineno, int32_t filename) {
   char buf[4 * (strlen(prefixBuf) + 1 + descWidth + 1 + memWidth + 1) + 1];
   size_t len;
 
-  memTrack_lock();
-
   len = 0;
   for (int i = 0; i < nDescsVals; i++) {
     len += snprintf(buf + len, sizeof(buf) - len,
                     "%s %-*s %*zd\n",
                     prefixBuf,
                     descWidth, descsVals[i].desc,
-                    memWidth, *descsVals[i].val);
+                    memWidth, descsVals[i].val);
   }
 
-  memTrack_unlock();
-
   fputs(buf, memLogFile);
+  printSampleNote();
 }
 
 
@@ -407,7 +582,7 @@ static void printMemAllocsByType(_Bool forLeaks,
                                  int32_t lineno, int32_t filename) {
   size_t* table;
   memTableEntry* me;
-  int i;
+  int s, i;
   const int numberWidth   = 9;
   const int numEntries = CHPL_RT_MD_NUM+chpl_mem_numDescs;
 
@@ -420,13 +595,18 @@ static void printMemAllocsByType(_Bool forLeaks,
 
   table = (size_t*)sys_calloc(numEntries, 3*sizeof(size_t));
 
-  for (i = 0; i < hashSize; i++) {
-    for (me = memTable[i]; me != NULL; me = me->nextInBucket) {
-      table[3*me->description] += me->number*me->size;
-      table[3*me->description+1] += 1;
-      table[3*me->description+2] = me->description;
+  memTrack_lockAll();
+  for (s = 0; s < NUM_SHARDS; s++) {
+    memTableShard* sh = &shards[s];
+    for (i = 0; i < sh->hashSize; i++) {
+      for (me = sh->table[i]; me != NULL; me = me->nextInBucket) {
+        table[3*me->description] += me->number*me->size*me->weight;
+        table[3*me->description+1] += me->weight;
+        table[3*me->description+2] = me->description;
+      }
     }
   }
+  memTrack_unlockAll();
 
   qsort(table, numEntries, 3*sizeof(size_t), memTableEntryCmp);
 
@@ -446,6 +626,7 @@ static void printMemAllocsByType(_Bool forLeaks,
   }
 
   fprintf(memLogFile, "                      Description of allocation\n");
+  printSampleNote();
   fprintf(memLogFile, "==============================================================\n");
   for (i = 0; i < 3*(CHPL_RT_MD_NUM+chpl_mem_numDescs); i += 3) {
     if (table[i] > 0) {
@@ -526,7 +707,7 @@ printMemAllocs(chpl_mem_descInt_t description, int64_t threshold,
 
   memTableEntry* memEntry;
   c_string memEntryFilename;
-  int n, i;
+  int n, s, i;
   char* loc;
   memTableEntry** table;
 
@@ -536,21 +717,26 @@ printMemAllocs(chpl_mem_descInt_t description, int64_t threshold,
     return;
   }
 
+  memTrack_lockAll();
+
   n = 0;
   filenameWidth = strlen("Allocated Memory (Bytes)");
-  for (i = 0; i < hashSize; i++) {
-    for (memEntry = memTable[i]; memEntry != NULL; memEntry = memEntry->nextInBucket) {
-      size_t chunk = memEntry->number * memEntry->size;
-      if (chunk < threshold)
-        continue;
-      if (description != -1 && memEntry->description != description)
-        continue;
-      n += 1;
-      if (memEntry->filename) {
-        memEntryFilename = chpl_lookupFilename(memEntry->filename);
-        filenameLength = strlen(memEntryFilename);
-        if (filenameLength > filenameWidth)
-          filenameWidth = filenameLength;
+  for (s = 0; s < NUM_SHARDS; s++) {
+    memTableShard* sh = &shards[s];
+    for (i = 0; i < sh->hashSize; i++) {
+      for (memEntry = sh->table[i]; memEntry != NULL; memEntry = memEntry->nextInBucket) {
+        size_t chunk = memEntry->number * memEntry->size;
+        if (chunk < threshold)
+          continue;
+        if (description != -1 && memEntry->description != description)
+          continue;
+        n += 1;
+        if (memEntry->filename) {
+          memEntryFilename = chpl_lookupFilename(memEntry->filename);
+          filenameLength = strlen(memEntryFilename);
+          if (filenameLength > filenameWidth)
+            filenameWidth = filenameLength;
+        }
       }
     }
   }
@@ -566,6 +752,7 @@ printMemAllocs(chpl_mem_descInt_t description, int64_t threshold,
          numberWidth, "Total",
          descWidth, "Description",
          20, "Address");
+  printSampleNote();
   for (i = 0; i < totalWidth; i++)
     fprintf(memLogFile, "=");
   fprintf(memLogFile, "\n");
@@ -575,14 +762,17 @@ printMemAllocs(chpl_mem_descInt_t description, int64_t threshold,
     chpl_error("out of memory printing memory table", lineno, filename);
 
   n = 0;
-  for (i = 0; i < hashSize; i++) {
-    for (memEntry = memTable[i]; memEntry != NULL; memEntry = memEntry->nextInBucket) {
-      size_t chunk = memEntry->number * memEntry->size;
-      if (chunk < threshold)
-        continue;
-      if (description != -1 && memEntry->description != description)
-        continue;
-      table[n++] = memEntry;
+  for (s = 0; s < NUM_SHARDS; s++) {
+    memTableShard* sh = &shards[s];
+    for (i = 0; i < sh->hashSize; i++) {
+      for (memEntry = sh->table[i]; memEntry != NULL; memEntry = memEntry->nextInBucket) {
+        size_t chunk = memEntry->number * memEntry->size;
+        if (chunk < threshold)
+          continue;
+        if (description != -1 && memEntry->description != description)
+          continue;
+        table[n++] = memEntry;
+      }
     }
   }
   qsort(table, n, sizeof(memTableEntry*), descCmp);
@@ -610,6 +800,8 @@ printMemAllocs(chpl_mem_descInt_t description, int64_t threshold,
   fprintf(memLogFile, "\n");
   putchar('\n');
 
+  memTrack_unlockAll();
+
   sys_free(table);
   sys_free(loc);
 }
@@ -651,9 +843,14 @@ void chpl_track_malloc(void* memAlloc, size_t number, size_t size,
                        int32_t lineno, int32_t filename) {
   if (number * size > memThreshold) {
     if (chpl_memTrack && chpl_mem_descTrack(description)) {
-      memTrack_lock();
-      addMemTableEntry(memAlloc, number, size, description, lineno, filename);
-      memTrack_unlock();
+      size_t weight = sampleWeight(number * size);
+      if (weight > 0) {
+        memTableShard* sh = shardFor(memAlloc);
+        memTrack_lock(sh);
+        addMemTableEntry(sh, memAlloc, number, size, weight,
+                         description, lineno, filename);
+        memTrack_unlock(sh);
+      }
     }
     if (chpl_verbose_mem) {
       fprintf(memLogFile, "%" PRI_c_nodeid_t ": %s:%" PRId32
@@ -669,8 +866,9 @@ void chpl_track_malloc(void* memAlloc, size_t number, size_t size,
 void chpl_track_free(void* memAlloc, int32_t lineno, int32_t filename) {
   memTableEntry* memEntry = NULL;
   if (chpl_memTrack) {
-    memTrack_lock();
-    memEntry = removeMemTableEntry(memAlloc);
+    memTableShard* sh = shardFor(memAlloc);
+    memTrack_lock(sh);
+    memEntry = removeMemTableEntry(sh, memAlloc);
     if (memEntry) {
       if (chpl_verbose_mem) {
         fprintf(memLogFile, "%" PRI_c_nodeid_t ": %s:%" PRId32
@@ -681,7 +879,7 @@ void chpl_track_free(void* memAlloc, int32_t lineno, int32_t filename) {
       }
       sys_free(memEntry);
     }
-    memTrack_unlock();
+    memTrack_unlock(sh);
   } else if (chpl_verbose_mem && !memEntry) {
     fprintf(memLogFile, "%" PRI_c_nodeid_t ": %s:%" PRId32 ": free at %p\n",
             chpl_nodeID, (filename ? chpl_lookupFilename(filename) : "--"),
@@ -695,14 +893,13 @@ void chpl_track_realloc_pre(void* memAlloc, size_t size,
                          int32_t lineno, int32_t filename) {
   memTableEntry* memEntry = NULL;
 
-  if (chpl_memTrack && size > memThreshold) {
-    memTrack_lock();
-    if (memAlloc) {
-      memEntry = removeMemTableEntry(memAlloc);
-      if (memEntry)
-        sys_free(memEntry);
-    }
-    memTrack_unlock();
+  if (chpl_memTrack && size > memThreshold && memAlloc) {
+    memTableShard* sh = shardFor(memAlloc);
+    memTrack_lock(sh);
+    memEntry = removeMemTableEntry(sh, memAlloc);
+    if (memEntry)
+      sys_free(memEntry);
+    memTrack_unlock(sh);
   }
 }
 
@@ -713,9 +910,14 @@ void chpl_track_realloc_post(void* moreMemAlloc,
                          int32_t lineno, int32_t filename) {
   if (size > memThreshold) {
     if (chpl_memTrack && chpl_mem_descTrack(description)) {
-      memTrack_lock();
-      addMemTableEntry(moreMemAlloc, 1, size, description, lineno, filename);
-      memTrack_unlock();
+      size_t weight = sampleWeight(size);
+      if (weight > 0) {
+        memTableShard* sh = shardFor(moreMemAlloc);
+        memTrack_lock(sh);
+        addMemTableEntry(sh, moreMemAlloc, 1, size, weight,
+                         description, lineno, filename);
+        memTrack_unlock(sh);
+      }
     }
     if (chpl_verbose_mem) {
       fprintf(memLogFile, "%" PRI_c_nodeid_t ": %s:%" PRId32
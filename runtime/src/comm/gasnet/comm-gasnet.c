@@ -250,7 +250,8 @@ typedef enum {
   SHUTDOWN,             // tell nodes to get ready for shutdown
   BCAST_SEGINFO,        // broadcast for segment info table
   DO_REPLY_PUT,         // do a PUT here from another locale
-  DO_COPY_PAYLOAD       // copy AM payload to another address
+  DO_COPY_PAYLOAD,      // copy AM payload to another address
+  AMO_UNORDERED         // apply a batch of unordered atomic updates
 } AM_handler_function_idx_t;
 
 static void AM_fork_fast(gasnet_token_t token, void* buf, size_t nbytes) {
@@ -586,6 +587,17 @@ void AM_copy_payload(gasnet_token_t token, void* buf, size_t nbytes,
   GASNET_Safe(gasnet_AMReplyShort2(token, SIGNAL, ack0, ack1));
 }
 
+// Apply the batch of unordered atomic updates in the payload.
+static
+void AM_amo_unordered(gasnet_token_t token, void* buf, size_t nbytes,
+                      gasnet_handlerarg_t ack0, gasnet_handlerarg_t ack1)
+{
+  chpl_comm_amo_unordered_apply((chpl_comm_amo_unordered_t*) buf,
+                                nbytes / sizeof(chpl_comm_amo_unordered_t));
+
+  GASNET_Safe(gasnet_AMReplyShort2(token, SIGNAL, ack0, ack1));
+}
+
 static gasnet_handlerentry_t ftable[] = {
   {FORK,          AM_fork},
   {FORK_SMALL,    AM_fork_small},
@@ -604,7 +616,8 @@ static gasnet_handlerentry_t ftable[] = {
   {SHUTDOWN,      AM_shutdown},
   {BCAST_SEGINFO, AM_bcast_seginfo},
   {DO_REPLY_PUT,  AM_reply_put},
-  {DO_COPY_PAYLOAD, AM_copy_payload}
+  {DO_COPY_PAYLOAD, AM_copy_payload},
+  {AMO_UNORDERED, AM_amo_unordered}
 };
 
 //
@@ -639,7 +652,7 @@ chpl_comm_nb_handle_t chpl_comm_put_nb(void *addr, c_nodeid_t node, void* raddr,
 
   ret = gasnet_put_nb_bulk(node, raddr, addr, size);
 
-  chpl_comm_diags_incr(put_nb);
+  chpl_comm_diags_incr_src(put_nb, size, ln, fn);
 
   return (chpl_comm_nb_handle_t) ret;
 }
@@ -673,7 +686,7 @@ chpl_comm_nb_handle_t chpl_comm_get_nb(void* addr, c_nodeid_t node, void* raddr,
 
   ret = gasnet_get_nb_bulk(addr, node, raddr, size);
 
-  chpl_comm_diags_incr(get_nb);
+  chpl_comm_diags_incr_src(get_nb, size, ln, fn);
 
   return (chpl_comm_nb_handle_t) ret;
 }
@@ -1129,7 +1142,7 @@ void  chpl_comm_put(void* addr, c_nodeid_t node, void* raddr,
     }
 
     chpl_comm_diags_verbose_rdma("put", node, size, ln, fn);
-    chpl_comm_diags_incr(put);
+    chpl_comm_diags_incr_src(put, size, ln, fn);
 
     // Handle remote address not in remote segment.
 #ifdef GASNET_SEGMENT_EVERYTHING
@@ -1205,7 +1218,7 @@ void  chpl_comm_get(void* addr, c_nodeid_t node, void* raddr,
     }
 
     chpl_comm_diags_verbose_rdma("get", node, size, ln, fn);
-    chpl_comm_diags_incr(get);
+    chpl_comm_diags_incr_src(get, size, ln, fn);
 
     // Handle remote address not in remote segment.
 
@@ -1347,7 +1360,10 @@ void  chpl_comm_get_strd(void* dstaddr, size_t* dststrides, c_nodeid_t srcnode_i
   
   // the case (chpl_nodeID == srcnode) is internally managed inside gasnet
   chpl_comm_diags_verbose_rdmaStrd("get", srcnode, ln, fn);
-  chpl_comm_diags_incr(get);
+  chpl_comm_diags_incr_src(get,
+                           chpl_comm_diags_strd_bytes(count, stridelevels,
+                                                      elemSize),
+                           ln, fn);
 
   // TODO -- handle strided get for non-registered memory
   gasnet_gets_bulk(dstaddr, dststr, srcnode, srcaddr, srcstr, cnt, strlvls); 
@@ -1390,7 +1406,10 @@ void  chpl_comm_put_strd(void* dstaddr, size_t* dststrides, c_nodeid_t dstnode_i
 
   // the case (chpl_nodeID == dstnode) is internally managed inside gasnet
   chpl_comm_diags_verbose_rdmaStrd("put", dstnode, ln, fn);
-  chpl_comm_diags_incr(put);
+  chpl_comm_diags_incr_src(put,
+                           chpl_comm_diags_strd_bytes(count, stridelevels,
+                                                      elemSize),
+                           ln, fn);
 
   // TODO -- handle strided put for non-registered memory
   gasnet_puts_bulk(dstnode, dstaddr, dststr, srcaddr, srcstr, cnt, strlvls); 
@@ -1527,7 +1546,9 @@ void  chpl_comm_execute_on(c_nodeid_t node, c_sublocid_t subloc,
     }
 
     chpl_comm_diags_verbose_executeOn("", node);
-    chpl_comm_diags_incr(execute_on);
+    chpl_comm_diags_incr_src(execute_on, arg_size,
+                             arg->task_bundle.lineno,
+                             arg->task_bundle.filename);
 
     execute_on_common(node, subloc, fid, arg, arg_size,
                      /*fast*/ false, /*blocking*/ true);
@@ -1550,7 +1571,9 @@ void  chpl_comm_execute_on_nb(c_nodeid_t node, c_sublocid_t subloc,
     }
 
     chpl_comm_diags_verbose_executeOn("non-blocking", node);
-    chpl_comm_diags_incr(execute_on_nb);
+    chpl_comm_diags_incr_src(execute_on_nb, arg_size,
+                             arg->task_bundle.lineno,
+                             arg->task_bundle.filename);
   
     execute_on_common(node, subloc, fid, arg, arg_size,
                       /*fast*/ false, /*blocking*/ false);
@@ -1574,7 +1597,9 @@ void  chpl_comm_execute_on_fast(c_nodeid_t node, c_sublocid_t subloc,
     }
 
     chpl_comm_diags_verbose_executeOn("fast", node);
-    chpl_comm_diags_incr(execute_on_fast);
+    chpl_comm_diags_incr_src(execute_on_fast, arg_size,
+                             arg->task_bundle.lineno,
+                             arg->task_bundle.filename);
 
     execute_on_common(node, subloc, fid, arg, arg_size,
                       /*fast*/ true, /*blocking*/ true);
@@ -1586,7 +1611,32 @@ void chpl_comm_make_progress(void)
   gasnet_AMPoll();
 }
 
-void chpl_comm_task_end(void) { }
+void chpl_comm_task_end(void) {
+  chpl_comm_unordered_task_fence();
+}
+
+//
+// Unordered atomic updates go over as one medium AM per batch, and are
+// applied in the handler.  We count each batch as a fast executeOn,
+// since that is how a single remote processor atomic would be done.
+//
+size_t chpl_comm_impl_amo_max_batch(void) {
+  return gasnet_AMMaxMedium() / sizeof(chpl_comm_amo_unordered_t);
+}
+
+void chpl_comm_impl_amo_unordered_send(c_nodeid_t node,
+                                       chpl_comm_amo_unordered_t* v,
+                                       size_t n) {
+  done_t done;
+
+  chpl_comm_diags_incr(execute_on_fast);
+
+  init_done_obj(&done, 1);
+  GASNET_Safe(gasnet_AMRequestMedium2(node, AMO_UNORDERED,
+                                      v, n * sizeof(v[0]),
+                                      Arg0(&done), Arg1(&done)));
+  wait_done_obj(&done);
+}
 
 void chpl_comm_gasnet_help_register_global_var(int i, wide_ptr_t wide_addr) {
   if (chpl_nodeID == 0) {
@@ -20,6 +20,7 @@
 #include "chplrt.h"
 
 #include "chpl-comm.h"
+#include "chpl-comm-diags.h"
 #include "chpl-comm-strd-xfer.h"
 #include "chplexit.h"
 #include "error.h"
@@ -108,6 +109,7 @@ int32_t chpl_comm_getMaxThreads(void) {
 void chpl_comm_init(int *argc_p, char ***argv_p) {
   chpl_numNodes = 1;
   chpl_nodeID = 0;
+  chpl_comm_diags_init();
 }
 
 void chpl_comm_post_mem_init(void) { }
@@ -221,4 +223,20 @@ int chpl_comm_numPollingTasks(void) { return 0; }
 
 void chpl_comm_make_progress(void) { }
 
-void chpl_comm_task_end(void) { }
+void chpl_comm_task_end(void) {
+  chpl_comm_unordered_task_fence();
+}
+
+//
+// There are no remote nodes, so buffered unordered atomic updates
+// (which are only buffered for remote targets) never reach us.
+//
+size_t chpl_comm_impl_amo_max_batch(void) {
+  return SIZE_MAX;
+}
+
+void chpl_comm_impl_amo_unordered_send(c_nodeid_t node,
+                                       chpl_comm_amo_unordered_t* v,
+                                       size_t n) {
+  chpl_comm_amo_unordered_apply(v, n);
+}
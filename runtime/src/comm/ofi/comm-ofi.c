@@ -1356,7 +1356,9 @@ void chpl_comm_make_progress(void) {
 }
 
 
-void chpl_comm_task_end(void) { }
+void chpl_comm_task_end(void) {
+  chpl_comm_unordered_task_fence();
+}
 
 
 void chpl_comm_execute_on(c_nodeid_t node, c_sublocid_t subloc,
@@ -1376,7 +1378,8 @@ void chpl_comm_execute_on(c_nodeid_t node, c_sublocid_t subloc,
   }
 
   chpl_comm_diags_verbose_executeOn("", node);
-  chpl_comm_diags_incr(execute_on);
+  chpl_comm_diags_incr_src(execute_on, argSize,
+                           arg->task_bundle.lineno, arg->task_bundle.filename);
 
   amRequestExecOn(node, subloc, fid, arg, argSize, false, true);
 }
@@ -1406,7 +1409,8 @@ void chpl_comm_execute_on_nb(c_nodeid_t node, c_sublocid_t subloc,
   }
 
   chpl_comm_diags_verbose_executeOn("non-blocking", node);
-  chpl_comm_diags_incr(execute_on_nb);
+  chpl_comm_diags_incr_src(execute_on_nb, argSize,
+                           arg->task_bundle.lineno, arg->task_bundle.filename);
 
   amRequestExecOn(node, subloc, fid, arg, argSize, false, false);
 }
@@ -1429,7 +1433,8 @@ void chpl_comm_execute_on_fast(c_nodeid_t node, c_sublocid_t subloc,
   }
 
   chpl_comm_diags_verbose_executeOn("fast", node);
-  chpl_comm_diags_incr(execute_on_fast);
+  chpl_comm_diags_incr_src(execute_on_fast, argSize,
+                           arg->task_bundle.lineno, arg->task_bundle.filename);
 
   amRequestExecOn(node, subloc, fid, arg, argSize, true, true);
 }
@@ -2186,7 +2191,7 @@ void chpl_comm_put(void* addr, c_nodeid_t node, void* raddr,
   }
 
   chpl_comm_diags_verbose_rdma("put", node, size, ln, fn);
-  chpl_comm_diags_incr(put);
+  chpl_comm_diags_incr_src(put, size, ln, fn);
 
   (void) ofi_put(addr, node, raddr, size);
 }
@@ -2215,7 +2220,7 @@ void chpl_comm_get(void* addr, int32_t node, void* raddr,
   }
 
   chpl_comm_diags_verbose_rdma("get", node, size, ln, fn);
-  chpl_comm_diags_incr(get);
+  chpl_comm_diags_incr_src(get, size, ln, fn);
 
   (void) ofi_get(addr, node, raddr, size);
 }
@@ -2914,6 +2919,49 @@ void chpl_comm_atomic_unordered_task_fence(void) {
 }
 
 
+//
+// Batches of unordered processor atomic updates, from the portable
+// implementation in chpl-comm-unordered.c.  We don't have a batched
+// AM yet, so for now each update is its own AMO request.
+//
+size_t chpl_comm_impl_amo_max_batch(void) {
+  return SIZE_MAX;
+}
+
+void chpl_comm_impl_amo_unordered_send(c_nodeid_t node,
+                                       chpl_comm_amo_unordered_t* v,
+                                       size_t n) {
+  static const int ofiOps[] = {
+    [chpl_comm_amo_and] = FI_BAND,
+    [chpl_comm_amo_or]  = FI_BOR,
+    [chpl_comm_amo_xor] = FI_BXOR,
+    [chpl_comm_amo_add] = FI_SUM,
+  };
+  static const enum fi_datatype ofiTypes[] = {
+    [chpl_comm_amo_int32]  = FI_INT32,
+    [chpl_comm_amo_int64]  = FI_INT64,
+    [chpl_comm_amo_uint32] = FI_UINT32,
+    [chpl_comm_amo_uint64] = FI_UINT64,
+    [chpl_comm_amo_real32] = FI_FLOAT,
+    [chpl_comm_amo_real64] = FI_DOUBLE,
+  };
+  static const size_t sizes[] = {
+    [chpl_comm_amo_int32]  = sizeof(int32_t),
+    [chpl_comm_amo_int64]  = sizeof(int64_t),
+    [chpl_comm_amo_uint32] = sizeof(uint32_t),
+    [chpl_comm_amo_uint64] = sizeof(uint64_t),
+    [chpl_comm_amo_real32] = sizeof(float),
+    [chpl_comm_amo_real64] = sizeof(double),
+  };
+  size_t i;
+
+  for (i = 0; i < n; i++) {
+    amRequestAMO(node, v[i].object, &v[i].operand, NULL, NULL,
+                 ofiOps[v[i].op], ofiTypes[v[i].type], sizes[v[i].type]);
+  }
+}
+
+
 //
 // internal AMO utilities
 //
@@ -1969,8 +1969,7 @@ int chpl_comm_numPollingTasks(void)
 }
 
 void chpl_comm_task_end(void) {
-  remote_get_buff_task_flush();
-  nic_amo_nf_buff_task_flush();
+  chpl_comm_unordered_task_fence();
 }
 
 void chpl_comm_post_task_init(void)
@@ -5117,7 +5116,7 @@ void chpl_comm_put(void* addr, c_nodeid_t locale, void* raddr,
   }
 
   chpl_comm_diags_verbose_rdma("put", locale, size, ln, fn);
-  chpl_comm_diags_incr(put);
+  chpl_comm_diags_incr_src(put, size, ln, fn);
 
   do_remote_put(addr, locale, raddr, size, NULL, may_proxy_true);
 }
@@ -5600,7 +5599,7 @@ void chpl_comm_get_unordered(void* addr, c_nodeid_t locale, void* raddr,
   }
 
   chpl_comm_diags_verbose_rdma("unordered get", locale, size, ln, fn);
-  chpl_comm_diags_incr(get);
+  chpl_comm_diags_incr_src(get, size, ln, fn);
 
   do_remote_get_buff(addr, locale, raddr, size, may_proxy_true);
 }
@@ -5640,7 +5639,7 @@ void chpl_comm_get(void* addr, c_nodeid_t locale, void* raddr,
   }
 
   chpl_comm_diags_verbose_rdma("get", locale, size, ln, fn);
-  chpl_comm_diags_incr(get);
+  chpl_comm_diags_incr_src(get, size, ln, fn);
 
   do_remote_get(addr, locale, raddr, size, may_proxy_true);
 }
@@ -6169,7 +6168,7 @@ chpl_comm_nb_handle_t chpl_comm_get_nb(void* addr, c_nodeid_t locale,
   }
 
   chpl_comm_diags_verbose_rdma("non-blocking get", locale, size, ln, fn);
-  chpl_comm_diags_incr(get_nb);
+  chpl_comm_diags_incr_src(get_nb, size, ln, fn);
 
   //
   // For now, if the local address isn't in a memory region known to the
@@ -7415,7 +7414,8 @@ void chpl_comm_execute_on(c_nodeid_t locale, c_sublocid_t subloc,
   }
 
   chpl_comm_diags_verbose_executeOn("", locale);
-  chpl_comm_diags_incr(execute_on);
+  chpl_comm_diags_incr_src(execute_on, arg_size,
+                           arg->task_bundle.lineno, arg->task_bundle.filename);
 
   PERFSTATS_INC(fork_call_cnt);
   fork_call_common(locale, subloc, fid, arg, arg_size, false, true);
@@ -7441,7 +7441,8 @@ void chpl_comm_execute_on_nb(c_nodeid_t locale, c_sublocid_t subloc,
   }
 
   chpl_comm_diags_verbose_executeOn("non-blocking", locale);
-  chpl_comm_diags_incr(execute_on_nb);
+  chpl_comm_diags_incr_src(execute_on_nb, arg_size,
+                           arg->task_bundle.lineno, arg->task_bundle.filename);
 
   PERFSTATS_INC(fork_call_nb_cnt);
   fork_call_common(locale, subloc, fid, arg, arg_size, false, false);
@@ -7467,7 +7468,8 @@ void chpl_comm_execute_on_fast(c_nodeid_t locale, c_sublocid_t subloc,
   }
 
   chpl_comm_diags_verbose_executeOn("fast", locale);
-  chpl_comm_diags_incr(execute_on_fast);
+  chpl_comm_diags_incr_src(execute_on_fast, arg_size,
+                           arg->task_bundle.lineno, arg->task_bundle.filename);
 
   //
   // Note: the rf_handler() logic assumes that fast implies blocking.
@@ -1933,6 +1933,8 @@ void _qio_channel_destroy(qio_channel_t* ch)
   qio_file_release(ch->file);
   ch->file = NULL;
 
+  if( ch->record_scratch ) qio_free(ch->record_scratch);
+
   DO_DESTROY_REFCNT(ch);
 
   qio_free(ch);
@@ -3496,6 +3498,109 @@ qioerr qio_channel_advance_past_byte(const int threadsafe, qio_channel_t* ch, in
 }
 
 
+static
+qioerr _qio_grow_record_scratch(qio_channel_t* ch, int64_t need)
+{
+  int64_t new_size;
+  uint8_t* new_scratch;
+
+  if( need <= ch->record_scratch_size ) return 0;
+
+  new_size = (ch->record_scratch_size > 0) ? ch->record_scratch_size : 128;
+  while( new_size < need ) new_size *= 2;
+
+  new_scratch = (uint8_t*) qio_realloc(ch->record_scratch, new_size);
+  if( ! new_scratch ) return QIO_ENOMEM;
+
+  ch->record_scratch = new_scratch;
+  ch->record_scratch_size = new_size;
+  return 0;
+}
+
+qioerr qio_channel_begin_peek_record(const int threadsafe, qio_channel_t* ch, int separator, uint8_t** ptr_out, int64_t* len_out)
+{
+  qioerr err = 0;
+  int64_t len = 0;
+
+  *ptr_out = NULL;
+  *len_out = 0;
+
+  if( threadsafe ) {
+    err = qio_lock(&ch->lock);
+    if( err ) {
+      return err;
+    }
+  }
+
+  ch->record_gen++;
+
+  // Fast path: the whole record is in the cached part of the buffer,
+  // so we can just point at it.
+  if( qio_space_in_ptr_diff(1, ch->cached_end, ch->cached_cur) ) {
+    size_t avail = qio_ptr_diff(ch->cached_end, ch->cached_cur);
+    void* found = memchr(ch->cached_cur, separator, avail);
+    if( found != NULL ) {
+      len = qio_ptr_diff(found, ch->cached_cur) + 1;
+      *ptr_out = (uint8_t*) ch->cached_cur;
+      *len_out = len;
+      ch->cached_cur = qio_ptr_add(ch->cached_cur, len);
+      return 0;
+    }
+  }
+
+  // Slow path: the record spans parts of the buffer (or the cached part
+  // hasn't been set up yet), so gather it in the scratch space.
+  while( err == 0 ) {
+    if( qio_space_in_ptr_diff(1, ch->cached_end, ch->cached_cur) ) {
+      size_t avail = qio_ptr_diff(ch->cached_end, ch->cached_cur);
+      void* found = memchr(ch->cached_cur, separator, avail);
+      int64_t amt = (found != NULL) ?
+                    qio_ptr_diff(found, ch->cached_cur) + 1 : avail;
+
+      err = _qio_grow_record_scratch(ch, len + amt);
+      if( err ) break;
+      qio_memcpy(ch->record_scratch + len, ch->cached_cur, amt);
+      ch->cached_cur = qio_ptr_add(ch->cached_cur, amt);
+      len += amt;
+      if( found != NULL ) break;
+    } else {
+      ssize_t amt_read;
+      uint8_t tmp;
+      err = _qio_slow_read(ch, &tmp, 1, &amt_read);
+      if( err == 0 && amt_read != 1 ) err = QIO_ESHORT;
+      if( err ) {
+        // A last record without a separator is still a record.
+        if( qio_err_to_int(err) == EEOF && len > 0 ) err = 0;
+        break;
+      }
+      err = _qio_grow_record_scratch(ch, len + 1);
+      if( err ) break;
+      ch->record_scratch[len++] = tmp;
+      if( tmp == separator ) break;
+    }
+  }
+
+  if( err ) {
+    _qio_channel_set_error_unlocked(ch, err);
+    if( threadsafe ) {
+      qio_unlock(&ch->lock);
+    }
+    return err;
+  }
+
+  *ptr_out = ch->record_scratch;
+  *len_out = len;
+  return 0;
+}
+
+qioerr qio_channel_end_peek_record(const int threadsafe, qio_channel_t* ch)
+{
+  if( threadsafe ) {
+    qio_unlock(&ch->lock);
+  }
+  return 0;
+}
+
 qioerr qio_channel_mark_maybe_flush_bits(const int threadsafe, qio_channel_t* ch, int flushbits)
 {
   qioerr err;
@@ -24,12 +24,15 @@
 #include "chplrt.h"
 #include "chpl_rt_utils_static.h"
 #include "chplcgfns.h"
+#include "chpl-atomics.h"
 #include "chpl-comm.h"
+#include "chpl-env.h"
 #include "chplexit.h"
 #include "chpl-locale-model.h"
 #include "chpl-mem.h"
 #include "chpl-tasks.h"
 #include "chpl-tasks-callbacks-internal.h"
+#include "chpl-tasks-profile.h"
 #include "chpl-topo.h"
 #include "chpl-linefile-support.h"
 #include "error.h"
@@ -61,6 +64,12 @@ typedef struct task_pool_struct {
   task_pool_p      next;         // double-link pointers for pool
   task_pool_p      prev;
 
+  // work-stealing mode only, for tasks on task lists: whether the task
+  // has been taken to run, and how many of its deque and list entries
+  // remain (see "Work stealing" below)
+  chpl_bool        claimed;
+  atomic_int_least32_t refs;
+
   chpl_task_prvDataImpl_t chpl_data;
 
   chpl_task_bundle_t bundle; // ends in a variable-length array
@@ -76,10 +85,55 @@ typedef struct lockReport {
 } lockReport_t;
 
 
+//
+// Work stealing
+//
+// When the CHPL_RT_TASKS_WORK_STEALING environment variable is set,
+// each thread puts the tasks it creates on a deque of its own rather
+// than in the shared task pool.  The deques are the Chase-Lev kind
+// ("Dynamic Circular Work-Stealing Deque", SPAA 2005), with the memory
+// orderings given by Le et al. in "Correct and Efficient Work-Stealing
+// for Weak Memory Models" (PPoPP 2013).  A thread looking for work first
+// pops the task it created most recently, whose data is the most likely
+// to still be in its cache.  Failing that it checks the shared pool,
+// and then tries to steal the oldest task from the other threads'
+// deques, starting with a randomly chosen one.  The owner pushes and
+// pops without locking, and a thief only contends with the owner and
+// other thieves of the same deque.  Threads that can't get a deque
+// (there are at most WS_MAX_DEQUES) still use the shared pool.
+//
+// A task on a cobegin/coforall task list is on a deque as well, so both
+// the parent running chpl_task_executeTasksInList() and a thread that
+// pops or steals the task may try to run it.  They claim it under one of
+// ws_list_locks, chosen by the list's address, which also protects the
+// list.  Whoever loses just drops its reference, and the descriptor is
+// freed when both the deque and list references are gone.
+//
+#define WS_MAX_DEQUES 4096
+#define WS_NUM_LIST_LOCKS 64
+#define WS_INITIAL_DEQUE_SIZE 64
+
+typedef struct task_deque_array_struct {
+  int64_t          size;         // a power of 2
+  struct task_deque_array_struct*
+                   prev;         // the smaller array this one replaced
+  atomic_uintptr_t tasks[];      // circular buffer of task_pool_p
+} task_deque_array_t;
+
+typedef struct {
+  atomic_int_least64_t top;      // thieves take from here
+  atomic_int_least64_t bottom;   // the owner pushes and pops here
+  atomic_uintptr_t     array;    // task_deque_array_t*
+  atomic_int_least32_t stealers; // thieves that may be reading an array
+} task_deque_t;
+
+
 // This is the data that is private to each thread.
 typedef struct {
   task_pool_p   ptask;
   lockReport_t* lockRprt;
+  task_deque_t* deque;           // work-stealing mode only
+  uint64_t      steal_rand;      // for choosing whom to steal from
 } thread_private_data_t;
 
 
@@ -113,11 +167,39 @@ static chpl_thread_mutex_t taskTable_lock;     // critical section lock
 
 static chpl_fn_p comm_task_fn;
 
+static chpl_bool           work_stealing = false;
+static atomic_uintptr_t    ws_deques[WS_MAX_DEQUES];  // task_deque_t*
+static atomic_int_least32_t
+                           ws_num_deques;
+static chpl_thread_mutex_t ws_list_locks[WS_NUM_LIST_LOCKS];
+static atomic_int_least64_t
+                           ws_queued_task_cnt; // queued_task_cnt and
+static atomic_int_least32_t                    //   idle_thread_cnt, in
+                           ws_idle_thread_cnt; //   work-stealing mode
+
 //
 // Internal functions.
 //
 static void                    enqueue_task(task_pool_p, task_pool_p*);
 static void                    dequeue_task(task_pool_p);
+static void                    pool_add_task(task_pool_p);
+static void                    pool_remove_task(task_pool_p);
+static void                    list_add_task(task_pool_p, task_pool_p*);
+static void                    list_remove_task(task_pool_p);
+static void                    ws_init(void);
+static void                    ws_enqueue_task(task_pool_p, task_pool_p*);
+static task_pool_p             ws_dequeue_list_task(task_pool_p*);
+static chpl_bool               ws_claim_task(task_pool_p);
+static void                    ws_release_task(task_pool_p);
+static void                    ws_drop_claimed_tasks(void);
+static chpl_bool               ws_task_claimed(task_pool_p);
+static void                    ws_maybe_add_thread(void);
+static void                    ws_run_tasks(thread_private_data_t*);
+static chpl_bool               tasks_available(void);
+static int                     num_idle_threads(void);
+static void                    wait_for_tasks(void);
+static void                    run_pool_task(thread_private_data_t*,
+                                             task_pool_p);
 static void                    comm_task_wrapper(void*);
 static void                    taskCallBody(chpl_fn_int_t, chpl_fn_p,
                                             chpl_task_bundle_t*, size_t,
@@ -160,6 +242,7 @@ static void sync_wait_and_lock(chpl_sync_aux_t *s,
                                chpl_bool want_full,
                                int32_t lineno, int32_t filename) {
   chpl_bool suspend_using_cond;
+  uint64_t wait_start = 0;
 
   chpl_thread_mutexLock(&s->lock);
 
@@ -170,6 +253,8 @@ static void sync_wait_and_lock(chpl_sync_aux_t *s,
                         chpl_topo_getNumCPUsLogical(true));
 
   while (s->is_full != want_full) {
+    if (chpl_task_profiling && wait_start == 0)
+      wait_start = chpl_task_profile_now();
     if (!suspend_using_cond) {
       chpl_thread_mutexUnlock(&s->lock);
     }
@@ -211,6 +296,9 @@ static void sync_wait_and_lock(chpl_sync_aux_t *s,
       chpl_thread_mutexLock(&s->lock);
   }
 
+  if (wait_start != 0)
+    chpl_task_profile_sync_wait(wait_start, lineno, filename);
+
   if (blockreport)
     progress_cnt++;
 }
@@ -339,6 +427,10 @@ void chpl_task_init(void) {
   extra_task_cnt = 0;
   task_pool_head = task_pool_tail = NULL;
 
+  work_stealing = chpl_env_rt_get_bool("TASKS_WORK_STEALING", false);
+  if (work_stealing)
+    ws_init();
+
   chpl_thread_init(thread_begin, thread_end);
 
   //
@@ -522,42 +614,33 @@ static void comm_task_wrapper(void* arg) {
 static inline
 void enqueue_task(task_pool_p ptask, task_pool_p* p_task_list_head) {
   queued_task_cnt++;
+  pool_add_task(ptask);
+  list_add_task(ptask, p_task_list_head);
+}
 
-  //
-  // Add to pool.
-  //
+
+static inline
+void dequeue_task(task_pool_p ptask) {
+  assert(queued_task_cnt > 0);
+  queued_task_cnt--;
+  pool_remove_task(ptask);
+  list_remove_task(ptask);
+}
+
+
+static inline
+void pool_add_task(task_pool_p ptask) {
   if (task_pool_tail)
     task_pool_tail->next = ptask;
   else
     task_pool_head = ptask;
   ptask->prev = task_pool_tail;
   task_pool_tail = ptask;
-
-  //
-  // Add to list, if any.
-  //
-  if (p_task_list_head == NULL) {
-    ptask->p_list_head = NULL;
-  }
-  else {
-    ptask->p_list_head = p_task_list_head;
-    ptask->list_next = *p_task_list_head;
-    if (*p_task_list_head != NULL)
-      (*p_task_list_head)->list_prev = ptask;
-    ptask->list_prev = NULL;
-    *p_task_list_head = ptask;
-  }
 }
 
 
 static inline
-void dequeue_task(task_pool_p ptask) {
-  assert(queued_task_cnt > 0);
-  queued_task_cnt--;
-
-  //
-  // Remove from pool.
-  //
+void pool_remove_task(task_pool_p ptask) {
   if (ptask == task_pool_head) {
     if ((task_pool_head = task_pool_head->next) == NULL)
       task_pool_tail = NULL;
@@ -570,10 +653,33 @@ void dequeue_task(task_pool_p ptask) {
     else
       ptask->next->prev = ptask->prev;
   }
+}
 
-  //
-  // Remove from list, if on one.
-  //
+
+//
+// Add to the given task list, if any.
+//
+static inline
+void list_add_task(task_pool_p ptask, task_pool_p* p_task_list_head) {
+  if (p_task_list_head == NULL) {
+    ptask->p_list_head = NULL;
+  }
+  else {
+    ptask->p_list_head = p_task_list_head;
+    ptask->list_next = *p_task_list_head;
+    if (*p_task_list_head != NULL)
+      (*p_task_list_head)->list_prev = ptask;
+    ptask->list_prev = NULL;
+    *p_task_list_head = ptask;
+  }
+}
+
+
+//
+// Remove from the task list, if on one.  This leaves p_list_head set.
+//
+static inline
+void list_remove_task(task_pool_p ptask) {
   if (ptask->p_list_head != NULL) {
     if (ptask == *(ptask->p_list_head))
       *(ptask->p_list_head) = ptask->list_next;
@@ -585,6 +691,449 @@ void dequeue_task(task_pool_p ptask) {
 }
 
 
+//
+// Work-stealing deques and the operations on them.  Only the thread
+// that owns a deque may push or pop; any thread may steal.
+//
+static task_deque_array_t* deque_array_alloc(int64_t size) {
+  task_deque_array_t* a;
+  int64_t i;
+
+  a = (task_deque_array_t*)
+      chpl_mem_alloc(sizeof(task_deque_array_t)
+                     + size * sizeof(atomic_uintptr_t),
+                     CHPL_RT_MD_TASK_LAYER_UNSPEC, 0, 0);
+  a->size = size;
+  a->prev = NULL;
+  for (i = 0; i < size; i++)
+    atomic_init_uintptr_t(&a->tasks[i], (uintptr_t) NULL);
+  return a;
+}
+
+
+static task_deque_t* deque_create(void) {
+  task_deque_t* d;
+
+  d = (task_deque_t*) chpl_mem_alloc(sizeof(task_deque_t),
+                                     CHPL_RT_MD_TASK_LAYER_UNSPEC, 0, 0);
+  atomic_init_int_least64_t(&d->top, 0);
+  atomic_init_int_least64_t(&d->bottom, 0);
+  atomic_init_uintptr_t(&d->array,
+                        (uintptr_t) deque_array_alloc(WS_INITIAL_DEQUE_SIZE));
+  atomic_init_int_least32_t(&d->stealers, 0);
+  return d;
+}
+
+
+//
+// Free the arrays a deque has outgrown, if no thief can still be
+// reading them.  A thief counts itself in 'stealers' before it loads
+// the array, so once the count is seen to be 0 after the new array was
+// published, any later thief will load the new one.  Only the owner
+// calls this; if thieves are busy, the next call tries again.
+//
+static void deque_free_retired(task_deque_t* d) {
+  task_deque_array_t* a =
+    (task_deque_array_t*) atomic_load_explicit_uintptr_t(&d->array,
+                                                         memory_order_relaxed);
+  task_deque_array_t* old;
+
+  if (a->prev == NULL)
+    return;
+
+  chpl_atomic_thread_fence(memory_order_seq_cst);
+  if (atomic_load_explicit_int_least32_t(&d->stealers,
+                                         memory_order_seq_cst) != 0)
+    return;
+
+  while ((old = a->prev) != NULL) {
+    a->prev = old->prev;
+    chpl_mem_free(old, 0, 0);
+  }
+}
+
+
+static inline
+task_pool_p deque_array_get(task_deque_array_t* a, int64_t i) {
+  return (task_pool_p)
+         atomic_load_explicit_uintptr_t(&a->tasks[i & (a->size - 1)],
+                                        memory_order_relaxed);
+}
+
+
+static inline
+void deque_array_put(task_deque_array_t* a, int64_t i, task_pool_p ptask) {
+  atomic_store_explicit_uintptr_t(&a->tasks[i & (a->size - 1)],
+                                  (uintptr_t) ptask, memory_order_relaxed);
+}
+
+
+static void deque_push(task_deque_t* d, task_pool_p ptask) {
+  int64_t b = atomic_load_explicit_int_least64_t(&d->bottom,
+                                                 memory_order_relaxed);
+  int64_t t = atomic_load_explicit_int_least64_t(&d->top,
+                                                 memory_order_acquire);
+  task_deque_array_t* a =
+    (task_deque_array_t*) atomic_load_explicit_uintptr_t(&d->array,
+                                                         memory_order_relaxed);
+
+  if (b - t > a->size - 1) {
+    //
+    // Full; move to an array twice the size.  Thieves may still be
+    // reading the old one, so it is linked from the new one until
+    // deque_free_retired() finds that it is safe to free.
+    //
+    task_deque_array_t* new_a = deque_array_alloc(2 * a->size);
+    int64_t i;
+
+    for (i = t; i < b; i++)
+      deque_array_put(new_a, i, deque_array_get(a, i));
+    new_a->prev = a;
+    atomic_store_explicit_uintptr_t(&d->array, (uintptr_t) new_a,
+                                    memory_order_release);
+    a = new_a;
+    deque_free_retired(d);
+  }
+
+  deque_array_put(a, b, ptask);
+  chpl_atomic_thread_fence(memory_order_release);
+  atomic_store_explicit_int_least64_t(&d->bottom, b + 1,
+                                      memory_order_relaxed);
+}
+
+
+static task_pool_p deque_pop(task_deque_t* d) {
+  int64_t b = atomic_load_explicit_int_least64_t(&d->bottom,
+                                                 memory_order_relaxed) - 1;
+  task_deque_array_t* a =
+    (task_deque_array_t*) atomic_load_explicit_uintptr_t(&d->array,
+                                                         memory_order_relaxed);
+  int64_t t;
+  task_pool_p ptask;
+
+  atomic_store_explicit_int_least64_t(&d->bottom, b, memory_order_relaxed);
+  chpl_atomic_thread_fence(memory_order_seq_cst);
+  t = atomic_load_explicit_int_least64_t(&d->top, memory_order_relaxed);
+
+  if (t > b) {
+    // empty
+    atomic_store_explicit_int_least64_t(&d->bottom, b + 1,
+                                        memory_order_relaxed);
+    return NULL;
+  }
+
+  ptask = deque_array_get(a, b);
+  if (t == b) {
+    // This was the last one, so we have to beat any thieves to it.
+    if (!atomic_compare_exchange_strong_explicit_int_least64_t(
+           &d->top, t, t + 1, memory_order_seq_cst))
+      ptask = NULL;
+    atomic_store_explicit_int_least64_t(&d->bottom, b + 1,
+                                        memory_order_relaxed);
+  }
+  return ptask;
+}
+
+
+//
+// Take the oldest task from a deque owned by another thread.  This
+// returns NULL if the deque is empty or another thread got there first.
+//
+static task_pool_p deque_steal(task_deque_t* d) {
+  int64_t t = atomic_load_explicit_int_least64_t(&d->top,
+                                                 memory_order_acquire);
+  int64_t b;
+  task_deque_array_t* a;
+  task_pool_p ptask;
+
+  chpl_atomic_thread_fence(memory_order_seq_cst);
+  b = atomic_load_explicit_int_least64_t(&d->bottom, memory_order_acquire);
+  if (t >= b)
+    return NULL;
+
+  (void) atomic_fetch_add_explicit_int_least32_t(&d->stealers, 1,
+                                                 memory_order_seq_cst);
+  a = (task_deque_array_t*) atomic_load_explicit_uintptr_t(&d->array,
+                                                           memory_order_acquire);
+  ptask = deque_array_get(a, t);
+  (void) atomic_fetch_sub_explicit_int_least32_t(&d->stealers, 1,
+                                                 memory_order_release);
+  if (!atomic_compare_exchange_strong_explicit_int_least64_t(
+         &d->top, t, t + 1, memory_order_seq_cst))
+    return NULL;
+  return ptask;
+}
+
+
+static void ws_init(void) {
+  int i;
+
+  for (i = 0; i < WS_MAX_DEQUES; i++)
+    atomic_init_uintptr_t(&ws_deques[i], (uintptr_t) NULL);
+  atomic_init_int_least32_t(&ws_num_deques, 0);
+  for (i = 0; i < WS_NUM_LIST_LOCKS; i++)
+    chpl_thread_mutexInit(&ws_list_locks[i]);
+  atomic_init_int_least64_t(&ws_queued_task_cnt, 0);
+  atomic_init_int_least32_t(&ws_idle_thread_cnt, 0);
+}
+
+
+//
+// Get this thread's deque, creating it on first use.  This returns
+// NULL if there are already as many deques as we can keep track of.
+//
+static task_deque_t* ws_get_deque(thread_private_data_t* tp) {
+  int32_t slot;
+
+  if (tp->deque == NULL
+      && atomic_load_int_least32_t(&ws_num_deques) < WS_MAX_DEQUES) {
+    slot = atomic_fetch_add_int_least32_t(&ws_num_deques, 1);
+    if (slot < WS_MAX_DEQUES) {
+      tp->deque = deque_create();
+      tp->steal_rand = (uint64_t) (intptr_t) tp | 1;
+      atomic_store_explicit_uintptr_t(&ws_deques[slot],
+                                      (uintptr_t) tp->deque,
+                                      memory_order_release);
+    }
+  }
+  return tp->deque;
+}
+
+
+static inline
+chpl_thread_mutex_t* ws_list_lock(task_pool_p* p_task_list_head) {
+  return &ws_list_locks[((uintptr_t) p_task_list_head >> 4)
+                        % WS_NUM_LIST_LOCKS];
+}
+
+
+static void ws_enqueue_task(task_pool_p ptask,
+                            task_pool_p* p_task_list_head) {
+  thread_private_data_t* tp = chpl_thread_getPrivateData();
+  task_deque_t* deque = (tp == NULL) ? NULL : ws_get_deque(tp);
+
+  ptask->claimed = false;
+  if (p_task_list_head == NULL) {
+    ptask->p_list_head = NULL;
+    atomic_init_int_least32_t(&ptask->refs, 1);
+  }
+  else {
+    chpl_thread_mutex_t* lock = ws_list_lock(p_task_list_head);
+
+    atomic_init_int_least32_t(&ptask->refs, 2);
+    chpl_thread_mutexLock(lock);
+    list_add_task(ptask, p_task_list_head);
+    chpl_thread_mutexUnlock(lock);
+  }
+
+  if (deque != NULL) {
+    deque_push(deque, ptask);
+  }
+  else {
+    chpl_thread_mutexLock(&threading_lock);
+    pool_add_task(ptask);
+    chpl_thread_mutexUnlock(&threading_lock);
+  }
+
+  (void) atomic_fetch_add_int_least64_t(&ws_queued_task_cnt, 1);
+}
+
+
+//
+// Take the first task off a task list for the parent to run, or return
+// NULL if other threads have taken them all.
+//
+static task_pool_p ws_dequeue_list_task(task_pool_p* p_task_list_head) {
+  chpl_thread_mutex_t* lock = ws_list_lock(p_task_list_head);
+  task_pool_p ptask;
+
+  chpl_thread_mutexLock(lock);
+  if ((ptask = *p_task_list_head) != NULL) {
+    assert(!ptask->claimed);
+    ptask->claimed = true;
+    list_remove_task(ptask);
+  }
+  chpl_thread_mutexUnlock(lock);
+
+  if (ptask != NULL)
+    (void) atomic_fetch_sub_int_least64_t(&ws_queued_task_cnt, 1);
+  return ptask;
+}
+
+
+//
+// Claim a task popped or stolen from a deque, or found in the shared
+// pool.  This returns false if the task was on a task list and its
+// parent has already run it.
+//
+static chpl_bool ws_claim_task(task_pool_p ptask) {
+  chpl_bool claimed = true;
+
+  if (ptask->p_list_head != NULL) {
+    chpl_thread_mutex_t* lock = ws_list_lock(ptask->p_list_head);
+
+    chpl_thread_mutexLock(lock);
+    if (ptask->claimed) {
+      claimed = false;
+    }
+    else {
+      ptask->claimed = true;
+      list_remove_task(ptask);
+    }
+    chpl_thread_mutexUnlock(lock);
+  }
+
+  if (claimed)
+    (void) atomic_fetch_sub_int_least64_t(&ws_queued_task_cnt, 1);
+  return claimed;
+}
+
+
+//
+// Whether a task on a deque has already been claimed, for reporting.
+// A task that isn't on a task list is only ever claimed by taking it
+// off the deque.
+//
+static chpl_bool ws_task_claimed(task_pool_p ptask) {
+  chpl_bool claimed = false;
+
+  if (ptask->p_list_head != NULL) {
+    chpl_thread_mutex_t* lock = ws_list_lock(ptask->p_list_head);
+
+    chpl_thread_mutexLock(lock);
+    claimed = ptask->claimed;
+    chpl_thread_mutexUnlock(lock);
+  }
+  return claimed;
+}
+
+
+static void ws_release_task(task_pool_p ptask) {
+  if (atomic_fetch_sub_int_least32_t(&ptask->refs, 1) == 1)
+    chpl_mem_free(ptask, 0, 0);
+}
+
+
+//
+// After a task list has been run, the tasks the parent ran itself are
+// still on the parent thread's deque, at the bottom.  Drop them now
+// rather than leaving them for a thief.
+//
+static void ws_drop_claimed_tasks(void) {
+  thread_private_data_t* tp = get_thread_private_data();
+  task_pool_p ptask;
+
+  if (tp->deque == NULL)
+    return;
+
+  while ((ptask = deque_pop(tp->deque)) != NULL) {
+    if (!ptask->claimed) {
+      deque_push(tp->deque, ptask);
+      break;
+    }
+    ws_release_task(ptask);
+  }
+}
+
+
+//
+// Find a task to run: the newest one on our own deque, then the oldest
+// one in the shared pool, then the oldest one on some other deque.
+//
+static task_pool_p ws_find_task(thread_private_data_t* tp) {
+  task_pool_p ptask;
+  int32_t num_deques;
+  int32_t start, i;
+
+  if (tp->deque != NULL) {
+    if ((ptask = deque_pop(tp->deque)) != NULL)
+      return ptask;
+    deque_free_retired(tp->deque);
+  }
+
+  if (task_pool_head != NULL) {
+    chpl_thread_mutexLock(&threading_lock);
+    if ((ptask = task_pool_head) != NULL)
+      pool_remove_task(ptask);
+    chpl_thread_mutexUnlock(&threading_lock);
+    if (ptask != NULL)
+      return ptask;
+  }
+
+  num_deques = atomic_load_int_least32_t(&ws_num_deques);
+  if (num_deques > WS_MAX_DEQUES)
+    num_deques = WS_MAX_DEQUES;
+  if (num_deques == 0)
+    return NULL;
+
+  // xorshift64
+  tp->steal_rand ^= tp->steal_rand << 13;
+  tp->steal_rand ^= tp->steal_rand >> 7;
+  tp->steal_rand ^= tp->steal_rand << 17;
+  start = (int32_t) (tp->steal_rand % (uint64_t) num_deques);
+
+  for (i = 0; i < num_deques; i++) {
+    task_deque_t* victim =
+      (task_deque_t*)
+      atomic_load_explicit_uintptr_t(&ws_deques[(start + i) % num_deques],
+                                     memory_order_acquire);
+    if (victim != NULL && victim != tp->deque
+        && (ptask = deque_steal(victim)) != NULL)
+      return ptask;
+  }
+
+  return NULL;
+}
+
+
+//
+// The work-stealing version of the thread_begin() loop.
+//
+static void ws_run_tasks(thread_private_data_t* tp) {
+  task_pool_p ptask;
+
+  while (true) {
+    wait_for_tasks();
+
+    if ((ptask = ws_find_task(tp)) == NULL) {
+      // Another thread got the task we saw.
+      chpl_thread_yield();
+      continue;
+    }
+
+    if (!ws_claim_task(ptask)) {
+      ws_release_task(ptask);
+      continue;
+    }
+
+    if (blockreport)
+      progress_cnt++;
+
+    (void) atomic_fetch_sub_int_least32_t(&ws_idle_thread_cnt, 1);
+
+    run_pool_task(tp, ptask);
+    ws_release_task(ptask);
+
+    (void) atomic_fetch_add_int_least32_t(&ws_idle_thread_cnt, 1);
+  }
+}
+
+
+//
+// In work-stealing mode, try to start another thread if there are more
+// queued tasks than idle threads.
+//
+static void ws_maybe_add_thread(void) {
+  if (atomic_load_int_least64_t(&ws_queued_task_cnt)
+        > atomic_load_int_least32_t(&ws_idle_thread_cnt)
+      && chpl_thread_canCreate()) {
+    chpl_thread_mutexLock(&threading_lock);
+    maybe_add_thread();
+    chpl_thread_mutexUnlock(&threading_lock);
+  }
+}
+
+
 void chpl_task_addToTaskList(chpl_fn_int_t fid,
                              chpl_task_bundle_t* arg, size_t arg_size,
                              c_sublocid_t subloc,
@@ -595,6 +1144,20 @@ void chpl_task_addToTaskList(chpl_fn_int_t fid,
                              int32_t filename) {
   assert(subloc == c_sublocid_any);
 
+  if (work_stealing) {
+    if (task_list_locale == chpl_nodeID) {
+      (void) add_to_task_pool(fid, chpl_ftable[fid], arg, arg_size,
+                              false, (task_pool_p*) p_task_list_void,
+                              is_begin_stmt, lineno, filename);
+    }
+    else {
+      assert(is_begin_stmt);
+      (void) add_to_task_pool(fid, chpl_ftable[fid], arg, arg_size,
+                              false, NULL, true, 0, CHPL_FILE_IDX_UNKNOWN);
+    }
+    return;
+  }
+
   // begin critical section
   chpl_thread_mutexLock(&threading_lock);
 
@@ -633,16 +1196,22 @@ void chpl_task_executeTasksInList(void** p_task_list_void) {
   while (*p_task_list_head != NULL) {
     chpl_fn_p task_to_run_fun = NULL;
 
-    // begin critical section
-    chpl_thread_mutexLock(&threading_lock);
-
-    if ((child_ptask = *p_task_list_head) != NULL) {
-      task_to_run_fun = child_ptask->bundle.requested_fn;
-      dequeue_task(child_ptask);
+    if (work_stealing) {
+      if ((child_ptask = ws_dequeue_list_task(p_task_list_head)) != NULL)
+        task_to_run_fun = child_ptask->bundle.requested_fn;
     }
+    else {
+      // begin critical section
+      chpl_thread_mutexLock(&threading_lock);
 
-    // end critical section
-    chpl_thread_mutexUnlock(&threading_lock);
+      if ((child_ptask = *p_task_list_head) != NULL) {
+        task_to_run_fun = child_ptask->bundle.requested_fn;
+        dequeue_task(child_ptask);
+      }
+
+      // end critical section
+      chpl_thread_mutexUnlock(&threading_lock);
+    }
 
     if (task_to_run_fun == NULL)
       continue;
@@ -699,9 +1268,15 @@ void chpl_task_executeTasksInList(void** p_task_list_void) {
     chpl_thread_mutexUnlock(&extra_task_lock);
 
     set_current_ptask(curr_ptask);
-    chpl_mem_free(child_ptask, 0, 0);
+    if (work_stealing)
+      ws_release_task(child_ptask);
+    else
+      chpl_mem_free(child_ptask, 0, 0);
 
   }
+
+  if (work_stealing)
+    ws_drop_claimed_tasks();
 }
 
 
@@ -718,6 +1293,12 @@ void taskCallBody(chpl_fn_int_t fid, chpl_fn_p fp,
                   chpl_task_bundle_t* arg, size_t arg_size,
                   c_sublocid_t subloc,
                   int lineno, int32_t filename) {
+  if (work_stealing) {
+    (void) add_to_task_pool(fid, fp, arg, arg_size, true,
+                            NULL, false, lineno, filename);
+    return;
+  }
+
   // begin critical section
   chpl_thread_mutexLock(&threading_lock);
 
@@ -847,6 +1428,10 @@ size_t chpl_task_getCallStackSize(void) {
 }
 
 uint32_t chpl_task_getNumQueuedTasks(void) {
+  if (work_stealing) {
+    int64_t cnt = atomic_load_int_least64_t(&ws_queued_task_cnt);
+    return (cnt > 0) ? (uint32_t) cnt : 0;
+  }
   return queued_task_cnt;
 }
 
@@ -858,7 +1443,7 @@ int32_t chpl_task_getNumBlockedTasks(void) {
     chpl_thread_mutexLock(&threading_lock);
     chpl_thread_mutexLock(&block_report_lock);
 
-    numBlockedTasks = blocked_thread_cnt - idle_thread_cnt;
+    numBlockedTasks = blocked_thread_cnt - num_idle_threads();
 
     // end critical section
     chpl_thread_mutexUnlock(&block_report_lock);
@@ -964,6 +1549,32 @@ static void report_all_tasks(void) {
            pendingTask->bundle.lineno);
     pendingTask = pendingTask->next;
   }
+  if (work_stealing) {
+    int32_t num_deques = atomic_load_int_least32_t(&ws_num_deques);
+    int32_t i;
+    int64_t j;
+
+    if (num_deques > WS_MAX_DEQUES)
+      num_deques = WS_MAX_DEQUES;
+    for (i = 0; i < num_deques; i++) {
+      task_deque_t* d = (task_deque_t*)
+                        atomic_load_uintptr_t(&ws_deques[i]);
+      task_deque_array_t* a;
+
+      if (d == NULL)
+        continue;
+      a = (task_deque_array_t*) atomic_load_uintptr_t(&d->array);
+      for (j = atomic_load_int_least64_t(&d->top);
+           j < atomic_load_int_least64_t(&d->bottom);
+           j++) {
+        pendingTask = deque_array_get(a, j);
+        if (pendingTask != NULL && !ws_task_claimed(pendingTask))
+          printf("- %s:%d\n",
+                 chpl_lookupFilename(pendingTask->bundle.filename),
+                 pendingTask->bundle.lineno);
+      }
+    }
+  }
   printf("\n");
 
   // print out running tasks
@@ -1125,14 +1736,83 @@ thread_begin(void* ptask_void) {
 
   tp->ptask = NULL;
   tp->lockRprt = NULL;
+  tp->deque = NULL;
+  tp->steal_rand = 0;
   if (blockreport)
     initializeLockReportForThread();
 
+  if (work_stealing)
+    ws_run_tasks(tp); // does not return
+
   while (true) {
+    wait_for_tasks();
+
     //
-    // wait for a task to be present in the task pool
+    // Just now the pool had at least one task in it.  Lock and see if
+    // there's something still there.
     //
+    chpl_thread_mutexLock(&threading_lock);
+    if (!task_pool_head) {
+      chpl_thread_mutexUnlock(&threading_lock);
+      continue;
+    }
 
+    //
+    // We've found a task to run.
+    //
+
+    if (blockreport)
+      progress_cnt++;
+
+    //
+    // start new task; remove task from pool also add to task to task-table
+    // (structure in ChapelRuntime that keeps track of currently running tasks
+    // for task-reports on deadlock or Ctrl+C).
+    //
+    ptask = task_pool_head;
+    idle_thread_cnt--;
+
+    dequeue_task(ptask);
+
+    // end critical section
+    chpl_thread_mutexUnlock(&threading_lock);
+
+    run_pool_task(tp, ptask);
+    chpl_mem_free(ptask, 0, 0);
+
+    // begin critical section
+    chpl_thread_mutexLock(&threading_lock);
+
+    //
+    // finished task; increment idle count
+    //
+    idle_thread_cnt++;
+
+    // end critical section
+    chpl_thread_mutexUnlock(&threading_lock);
+  }
+}
+
+
+static chpl_bool tasks_available(void) {
+  if (work_stealing)
+    return atomic_load_int_least64_t(&ws_queued_task_cnt) > 0;
+  return task_pool_head != NULL;
+}
+
+
+static int num_idle_threads(void) {
+  if (work_stealing)
+    return atomic_load_int_least32_t(&ws_idle_thread_cnt);
+  return idle_thread_cnt;
+}
+
+
+//
+// Wait for a task to be present in the task pool (or in work-stealing
+// mode, anywhere), watching for deadlock if blockreport is on.
+//
+static void wait_for_tasks(void) {
     // In revision 22137, we investigated whether it was beneficial to
     // implement this while loop in a hybrid style, where depending on
     // the number of tasks available, idle threads would either yield or
@@ -1143,7 +1823,7 @@ thread_begin(void* ptask_void) {
     // that were waiting on the signal, but since there was a performance
     // impact from keeping it as a hybrid as opposed to merely yielding,
     // it was decided that we would return to the simple yield case.
-    while (!task_pool_head) {
+    while (!tasks_available()) {
       if (set_block_loc(0, CHPL_FILE_IDX_IDLE_TASK)) {
         // all other tasks appear to be blocked
         struct timeval deadline, now;
@@ -1151,55 +1831,31 @@ thread_begin(void* ptask_void) {
         deadline.tv_sec += 1;
         do {
           chpl_thread_yield();
-          if (!task_pool_head)
+          if (!tasks_available())
             gettimeofday(&now, NULL);
-        } while (!task_pool_head
+        } while (!tasks_available()
                  && (now.tv_sec < deadline.tv_sec
                      || (now.tv_sec == deadline.tv_sec
                          && now.tv_usec < deadline.tv_usec)));
-        if (!task_pool_head) {
+        if (!tasks_available()) {
           check_for_deadlock();
         }
       }
       else {
         do {
           chpl_thread_yield();
-        } while (!task_pool_head);
+        } while (!tasks_available());
       }
 
       unset_block_loc();
     }
- 
-    //
-    // Just now the pool had at least one task in it.  Lock and see if
-    // there's something still there.
-    //
-    chpl_thread_mutexLock(&threading_lock);
-    if (!task_pool_head) {
-      chpl_thread_mutexUnlock(&threading_lock);
-      continue;
-    }
-
-    //
-    // We've found a task to run.
-    //
-
-    if (blockreport)
-      progress_cnt++;
-
-    //
-    // start new task; remove task from pool also add to task to task-table
-    // (structure in ChapelRuntime that keeps track of currently running tasks
-    // for task-reports on deadlock or Ctrl+C).
-    //
-    ptask = task_pool_head;
-    idle_thread_cnt--;
-
-    dequeue_task(ptask);
+}
 
-    // end critical section
-    chpl_thread_mutexUnlock(&threading_lock);
 
+//
+// Run a task taken from the pool (or a deque) on this thread.
+//
+static void run_pool_task(thread_private_data_t* tp, task_pool_p ptask) {
     tp->ptask = ptask;
 
     if (do_taskReport) {
@@ -1231,19 +1887,6 @@ thread_begin(void* ptask_void) {
     }
 
     tp->ptask = NULL;
-    chpl_mem_free(ptask, 0, 0);
-
-    // begin critical section
-    chpl_thread_mutexLock(&threading_lock);
-
-    //
-    // finished task; increment idle count
-    //
-    idle_thread_cnt++;
-
-    // end critical section
-    chpl_thread_mutexUnlock(&threading_lock);
-  }
 }
 
 
@@ -1274,7 +1917,10 @@ static void maybe_add_thread(void) {
 
   if (!warning_issued && chpl_thread_canCreate()) {
     if (chpl_thread_create(NULL) == 0) {
-      idle_thread_cnt++;
+      if (work_stealing)
+        (void) atomic_fetch_add_int_least32_t(&ws_idle_thread_cnt, 1);
+      else
+        idle_thread_cnt++;
     }
     else {
       int32_t max_threads = chpl_thread_getMaxThreads();
@@ -1298,8 +1944,10 @@ static void maybe_add_thread(void) {
 
 
 // create a task from the given function pointer and arguments
-// and append it to the end of the task pool
-// assumes threading_lock has already been acquired!
+// and append it to the end of the task pool (or in work-stealing mode,
+// push it on this thread's deque)
+// assumes threading_lock has already been acquired, except in
+// work-stealing mode!
 static inline
 task_pool_p add_to_task_pool(chpl_fn_int_t fid, chpl_fn_p fp,
                              chpl_task_bundle_t* a, size_t a_size,
@@ -1338,8 +1986,8 @@ task_pool_p add_to_task_pool(chpl_fn_int_t fid, chpl_fn_p fp,
   ptask->bundle.requested_fn    = fp;
   ptask->bundle.id              = get_next_task_id();
 
-  enqueue_task(ptask, p_task_list_head);
-
+  // In work-stealing mode another thread could run (and free) the task
+  // as soon as it is enqueued, so do everything else first.
   chpl_task_do_callbacks(chpl_task_cb_event_kind_create,
                          ptask->bundle.requested_fid,
                          ptask->bundle.filename,
@@ -1355,6 +2003,14 @@ task_pool_p add_to_task_pool(chpl_fn_int_t fid, chpl_fn_p fp,
     chpl_thread_mutexUnlock(&taskTable_lock);
   }
 
+  if (work_stealing) {
+    ws_enqueue_task(ptask, p_task_list_head);
+    ws_maybe_add_thread();
+    return NULL;
+  }
+
+  enqueue_task(ptask, p_task_list_head);
+
   // If we now have more tasks than threads to run them on, try to start
   // another thread
   if (queued_task_cnt > idle_thread_cnt) {
@@ -1372,5 +2028,5 @@ uint32_t chpl_task_getNumThreads(void) {
 }
 
 uint32_t chpl_task_getNumIdleThreads(void) {
-  return idle_thread_cnt;
+  return num_idle_threads();
 }
@@ -47,6 +47,7 @@
 #include "chpl-linefile-support.h"
 #include "chpl-tasks.h"
 #include "chpl-tasks-callbacks-internal.h"
+#include "chpl-tasks-profile.h"
 #include "chpl-tasks-impl.h"
 #include "chpl-topo.h"
 
@@ -210,12 +211,18 @@ void chpl_sync_waitFullAndLock(chpl_sync_aux_t *s,
 {
     PROFILE_INCR(profile_sync_waitFullAndLock, 1);
 
+    uint64_t wait_start = 0;
+
     chpl_sync_lock(s);
     while (s->is_full == 0) {
+        if (chpl_task_profiling && wait_start == 0)
+            wait_start = chpl_task_profile_now();
         chpl_sync_unlock(s);
         qthread_readFE(NULL, &(s->signal_full));
         chpl_sync_lock(s);
     }
+    if (wait_start != 0)
+        chpl_task_profile_sync_wait(wait_start, lineno, filename);
 }
 
 void chpl_sync_waitEmptyAndLock(chpl_sync_aux_t *s,
@@ -224,12 +231,18 @@ void chpl_sync_waitEmptyAndLock(chpl_sync_aux_t *s,
 {
     PROFILE_INCR(profile_sync_waitEmptyAndLock, 1);
 
+    uint64_t wait_start = 0;
+
     chpl_sync_lock(s);
     while (s->is_full != 0) {
+        if (chpl_task_profiling && wait_start == 0)
+            wait_start = chpl_task_profile_now();
         chpl_sync_unlock(s);
         qthread_readFE(NULL, &(s->signal_empty));
         chpl_sync_lock(s);
     }
+    if (wait_start != 0)
+        chpl_task_profile_sync_wait(wait_start, lineno, filename);
 }
 
 void chpl_sync_markAndSignalFull(chpl_sync_aux_t *s)         // and unlock
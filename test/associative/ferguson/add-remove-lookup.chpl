@@ -0,0 +1,35 @@
+// Adds, removes and looks up indices with both associative table engines
+// (see defaultAssocGroupProbe in DefaultAssociative.chpl).
+
+config const n = 20000;
+
+var D: domain(string, parSafe=true);
+forall i in 1..n with (ref D) do
+  D += i:string;
+writeln(D.size);
+
+for i in 1..n by 3 do
+  D -= i:string;
+writeln(D.size);
+
+var ok = true;
+forall i in 1..n with (&& reduce ok) do
+  ok &&= D.contains(i:string) == (i % 3 != 1);
+writeln(ok);
+
+var A: [D] int;
+forall k in D with (ref A) do
+  A[k] = k:int;
+writeln(+ reduce A);
+
+D.clear();
+writeln(D.size, " ", D.contains("2"));
+
+D.requestCapacity(1000);
+D += "x";
+writeln(D);
+
+var E: domain(int);
+for i in 1..100 do E += i;
+for i in 1..100 do E -= i;
+writeln(E.size, " ", E);
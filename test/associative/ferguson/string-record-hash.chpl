@@ -0,0 +1,75 @@
+// Checks the default hashes of strings, records and tuples, and that a
+// string's cached hash follows changes to its contents.
+
+record R {
+  var a: int;
+  var b: string;
+}
+
+proc h(x) return chpl__defaultHash(x);
+
+// equal strings hash the same however they were built
+var s = "hello, world";
+const built = "hello" + ", " + "world";
+writeln(h(s) == h(built));
+writeln(h(s) == h(s[1..12]));
+writeln(h(s) != h(s[1..11]));
+writeln(h("") == h(""));
+
+// the cached hash is copied, and reset when the string changes
+const hs = h(s);
+var t = s;
+writeln(h(t) == hs);
+t += "!";
+writeln(h(t) == h("hello, world!"), " ", h(t) != hs);
+t = "hello, world";
+writeln(h(t) == hs);
+t = "other";
+writeln(h(t) == h("other"));
+
+// case changes copy the string and rewrite it in place
+var cased: domain(string);
+var lower = "abc";
+cased += lower;
+const upper = lower.toUpper();
+cased += upper;
+writeln(cased.contains("ABC"), " ", h(upper) == h("ABC"), " ",
+        h(upper.toLower()) == h(lower), " ",
+        h(lower.toTitle()) == h("Abc"), " ",
+        h(upper.capitalize()) == h("Abc"));
+
+// lengths straddling the hash's 4/16/48-byte cases
+var prev: string;
+for len in 0..100 {
+  const x = "a" * len;
+  const y = if len == 0 then "b" else "a" * (len-1) + "b";
+  if h(x) == h(y) || (len > 0 && h(x) == h(prev)) then
+    writeln("collision at length ", len);
+  prev = x;
+}
+
+// records and tuples whose fields differ slightly spread across the
+// low bits used to pick a slot
+config const n = 64;
+var lowBitsR, lowBitsT: domain(uint);
+for i in 1..n {
+  for j in 1..n {
+    lowBitsR += h(new R(i, j:string)) & 0xffff;
+    lowBitsT += h((i, j)) & 0xffff;
+  }
+}
+writeln(lowBitsR.size > n*n*9/10, " ", lowBitsT.size > n*n*9/10);
+writeln(h(new R(1, "x")) != h(new R(2, "x")), " ",
+        h((1, 2)) != h((2, 1)));
+
+// string-keyed associative domains and arrays
+var D: domain(string);
+var A: [D] int;
+for i in 1..1000 {
+  D += "key" + i;
+  A["key" + i] = i;
+}
+var ok = D.size == 1000;
+for i in 1..1000 do
+  ok &&= D.contains("key" + i) && A["key" + i] == i;
+writeln(ok, " ", D.contains("key0"), " ", D.contains("key1001"));
@@ -0,0 +1,43 @@
+// Exercise code that crosses module (and so translation unit) boundaries:
+// module-level globals, virtual dispatch, generics and arrays.
+use Sort;
+
+config const n = 1000;
+
+var counter = 0;
+
+class Shape {
+  proc area(): real { return 0.0; }
+}
+
+class Square: Shape {
+  var side: real;
+  override proc area(): real { return side * side; }
+}
+
+class Circle: Shape {
+  var r: real;
+  override proc area(): real { return 3.0 * r * r; }
+}
+
+proc total(shapes) {
+  var sum = 0.0;
+  for s in shapes {
+    sum += s.area();
+    counter += 1;
+  }
+  return sum;
+}
+
+var shapes: [1..4] unmanaged Shape;
+shapes[1] = new unmanaged Square(2.0);
+shapes[2] = new unmanaged Circle(1.0);
+shapes[3] = new unmanaged Square(3.0);
+shapes[4] = new unmanaged Circle(2.0);
+writeln(total(shapes));
+writeln(counter);
+for s in shapes do delete s;
+
+var A: [1..n] int = [i in 1..n] (i * 7919) % n;
+sort(A);
+writeln(isSorted(A), " ", A[1], " ", A[n], " ", + reduce A);
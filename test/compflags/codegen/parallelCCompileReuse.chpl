@@ -0,0 +1,10 @@
+// The prediff edits a string literal in this program and recompiles it
+// against the same object cache: only the units holding this module and
+// the string literals should be rebuilt.
+use Sort;
+
+config const n = 10;
+
+var A = [i in 1..n] (i * 7) % n;
+sort(A);
+writeln("first build ", n + 1, " ", A);
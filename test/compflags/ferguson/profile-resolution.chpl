@@ -0,0 +1,3 @@
+proc double(x) return 2*x;
+
+writeln(double(21), " ", double(1.5));
@@ -0,0 +1,90 @@
+//
+// 2-D heat diffusion (Jacobi) on a Stencil-distributed grid, comparing a
+// blocking updateFluff() with a split-phase beginUpdateFluff() /
+// waitUpdateFluff() that computes each locale's interior while the halo
+// exchange is in flight and only then computes the cells along the edges
+// of the locale's block.
+//
+
+use StencilDist, Time;
+
+config const n = 64,
+             numSteps = 10,
+             printPerf = false;
+
+const Dom = {1..n, 1..n};
+const Space = Dom dmapped Stencil(Dom, fluff=(1,1));
+
+proc initGrid(ref X) {
+  X = 0.0;
+  // a hot square in the middle of the grid
+  forall (i, j) in Space do
+    if abs(i - n/2) <= n/8 && abs(j - n/2) <= n/8 then X[i, j] = 100.0;
+}
+
+inline proc relax(const ref src, ref dst, i, j) {
+  dst[i, j] = 0.25 * (src[i-1, j] + src[i+1, j] + src[i, j-1] + src[i, j+1]);
+}
+
+// Step using the blocking update
+proc blockingStep(ref src, ref dst) {
+  src.updateFluff();
+  forall (i, j) in Space do
+    relax(src, dst, i, j);
+}
+
+// Step that overlaps the update with the computation on each locale's
+// interior, the cells that only read elements the locale owns.
+proc overlappedStep(ref src, ref dst) {
+  var update = src.beginUpdateFluff();
+
+  coforall loc in Locales do on loc {
+    const myBlock = Space.localSubdomain();
+    forall (i, j) in myBlock.expand(-1, -1) do
+      relax(src, dst, i, j);
+  }
+
+  src.waitUpdateFluff(update);
+
+  coforall loc in Locales do on loc {
+    const myBlock = Space.localSubdomain();
+    if myBlock.size > 0 {
+      const rows = myBlock.dim(1), cols = myBlock.dim(2);
+      forall j in cols {
+        relax(src, dst, rows.low, j);
+        if rows.size > 1 then relax(src, dst, rows.high, j);
+      }
+      forall i in rows.expand(-1) {
+        relax(src, dst, i, cols.low);
+        if cols.size > 1 then relax(src, dst, i, cols.high);
+      }
+    }
+  }
+}
+
+proc run(param overlap: bool) {
+  var A, B: [Space] real;
+  initGrid(A);
+
+  var t: Timer;
+  t.start();
+  for step in 1..numSteps {
+    if overlap {
+      if step % 2 == 1 then overlappedStep(A, B); else overlappedStep(B, A);
+    } else {
+      if step % 2 == 1 then blockingStep(A, B); else blockingStep(B, A);
+    }
+  }
+  t.stop();
+
+  const result = if numSteps % 2 == 1 then B else A;
+  if printPerf then
+    writeln((if overlap then "Overlapped" else "Blocking"), " time: ",
+            t.elapsed());
+  return + reduce result;
+}
+
+const blocking = run(overlap=false),
+      overlapped = run(overlap=true);
+
+writeln("Results match: ", blocking == overlapped);
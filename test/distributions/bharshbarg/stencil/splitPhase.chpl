@@ -0,0 +1,97 @@
+use StencilDist;
+
+config const debug = false;
+
+config const maxFluff = 2;
+
+//
+// Check that beginUpdateFluff/waitUpdateFluff fill the caches just like
+// updateFluff does, including when elements are written between the two
+// calls and when the update is repeated.
+//
+proc test(dom : domain) {
+  for i in 1..maxFluff {
+    var halo : dom.rank * int;
+    for j in 1..dom.rank do halo(j) = i;
+    test(dom, halo);
+  }
+}
+
+proc test(dom : domain, halo : dom.rank * int) {
+  param rank = dom.rank;
+
+  if debug then writeln("Testing domain ", dom, " with halo ", halo);
+  var Space = dom dmapped Stencil(dom, fluff=halo, periodic=true);
+
+  var A : [Space] int;
+  const n = dom.dim(1).size;
+
+  // Distinguishes the values written after the update has started
+  const offset = 1_000_000;
+
+  proc initVal(idx, trial) {
+    var val = trial;
+    for i in 1..rank do val += n*idx(i);
+    return val;
+  }
+
+  // Map an index in the periodic fluff back into 'dom'
+  proc wrap(idx) {
+    var ret = idx;
+    for i in 1..rank {
+      const r = dom.dim(i);
+      const extent = r.size * r.stride;
+      if ret(i) < r.low then ret(i) += extent;
+      else if ret(i) > r.high then ret(i) -= extent;
+    }
+    return ret;
+  }
+
+  var offs : rank*range(stridable=true);
+  for i in 1..rank do
+    offs(i) = -halo(i)*dom.dim(i).stride..halo(i)*dom.dim(i).stride by dom.dim(i).stride;
+  const Offsets = {(...offs)};
+
+  for trial in 1..2 {
+    forall idx in Space do A[idx] = initVal(idx, trial);
+
+    var update = A.beginUpdateFluff();
+
+    // Writes after the update has started must not be seen by it
+    forall idx in Space do A[idx] += offset;
+
+    A.waitUpdateFluff(update);
+
+    // Each locale should read its own elements as they are now, and
+    // everything else in its fluff as it was when the update began.
+    coforall loc in Locales do on loc {
+      const mine = Space.localSubdomain();
+      for idx in mine {
+        for off in Offsets {
+          const g = idx + off;
+          const expected = if mine.contains(g) then initVal(g, trial) + offset
+                                               else initVal(wrap(g), trial);
+          if A[g] != expected {
+            writeln("Failed when domain is: ", dom, " with halo ", halo,
+                    ". A", g, " = ", A[g], " on locale ", here.id,
+                    "; expected ", expected);
+            halt();
+          }
+        }
+      }
+    }
+  }
+
+  if debug then writeln();
+}
+
+test({1..10, 1..10});
+test({-3..11, -3..11});
+test({1..10, 1..10, 1..10});
+test({-10..#30, -10..#30, -10..#30} by 3);
+
+// At least one dimension has no fluff
+test({1..10, 1..10}, (1, 0));
+test({1..10, 1..10, 1..10}, (1, 0, 1));
+
+writeln("Success!");
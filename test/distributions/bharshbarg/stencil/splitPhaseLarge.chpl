@@ -0,0 +1,41 @@
+use StencilDist;
+
+//
+// Like splitPhase, but with regions large enough that some of the GETs
+// started by beginUpdateFluff are still in flight when others have
+// completed.  waitUpdateFluff must not return, or unpack any region,
+// until all of them are done.
+//
+config const n = 2048,
+             halo = 8,
+             trials = 4;
+
+const Dom = {1..n, 1..n};
+const Space = Dom dmapped Stencil(Dom, fluff=(halo, halo), periodic=true);
+var A : [Space] int;
+
+proc val(i, j, trial) return (trial * n + i) * n + j;
+
+// Map an index in the periodic fluff back into Dom
+proc wrap(x) return if x < 1 then x + n else if x > n then x - n else x;
+
+for trial in 1..trials {
+  forall (i, j) in Space do A[i, j] = val(i, j, trial);
+
+  var update = A.beginUpdateFluff();
+  A.waitUpdateFluff(update);
+
+  var errors : atomic int;
+  coforall loc in Locales do on loc {
+    const mine = Space.localSubdomain();
+    forall (i, j) in mine.expand(halo) {
+      if !mine.contains((i, j)) &&
+         A[i, j] != val(wrap(i), wrap(j), trial) then
+        errors.add(1);
+    }
+  }
+  if errors.read() != 0 then
+    writeln("trial ", trial, ": ", errors.read(), " stale fluff elements");
+}
+
+writeln("Success!");
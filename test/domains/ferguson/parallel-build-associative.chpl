@@ -0,0 +1,61 @@
+config const timing = true;
+config const perf = false;
+config const correctness = false;
+
+// number of indices added per trial and number of trials
+config const size = 2000000;
+config const trials = 3;
+
+use Time;
+
+// Measures the rate at which 1, 2, 4, ... maxTaskPar tasks can add
+// distinct indices to a shared parSafe associative domain.
+
+proc buildDomain(numTasks: int) {
+  var D: domain(int, parSafe=true);
+  var A: [D] int;
+
+  coforall tid in 0..#numTasks with (ref D) {
+    // spread each task's indices across the table
+    for i in tid..size-1 by numTasks do
+      D += (i:uint * 0x9E3779B97F4A7C15):int;
+  }
+
+  if correctness && D.size != size then
+    writeln("FAILED: ", numTasks, " tasks added ", D.size, " of ", size);
+}
+
+var taskCounts: [1..0] int;
+var n = 1;
+while n < here.maxTaskPar {
+  taskCounts.push_back(n);
+  n *= 2;
+}
+taskCounts.push_back(here.maxTaskPar);
+
+for numTasks in taskCounts {
+  var best = max(real);
+  for 1..(if correctness then 1 else trials) {
+    var t = new Timer();
+    t.start();
+    buildDomain(numTasks);
+    t.stop();
+    best = min(best, t.elapsed());
+  }
+
+  if timing {
+    const rate = size / best / 1e6;
+    if perf {
+      if numTasks == 1 then
+        writef("1 task: % 7.3r\n", rate);
+      if numTasks == here.maxTaskPar then
+        writef("max tasks: % 7.3r\n", rate);
+    } else {
+      writef("%i tasks: % 7.3r M adds/s\n", numTasks, rate);
+    }
+  }
+}
+
+if perf || correctness {
+  writeln("SUCCESS");
+}
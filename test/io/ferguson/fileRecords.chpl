@@ -0,0 +1,46 @@
+use IO;
+
+config const n = 10000;
+config const chunkSize = 0;
+
+var f = opentmp();
+{
+  var w = f.writer();
+  for i in 1..n do w.writeln(i);
+  w.write("last");
+  w.close();
+}
+
+// serial
+var serialCount = 0;
+var lastRecord: string;
+for r in f.records() {
+  serialCount += 1;
+  lastRecord = r;
+}
+writeln(serialCount, " ", lastRecord);
+
+// parallel, on one locale and spread over locales
+for distributed in (false, true) {
+  var count, sum: atomic int;
+  forall r in f.records(chunkSize=chunkSize, distributed=distributed) {
+    count.add(1);
+    if r != "last" then sum.add(r[1..r.length-1]:int);
+  }
+  writeln(count.read(), " ", sum.read() == n*(n+1)/2);
+}
+
+// the regions cover the file exactly once
+var covered: atomic int;
+forall (s, e) in f.recordRegions(chunkSize=chunkSize) do
+  covered.add(e - s);
+writeln(covered.read() == f.length());
+
+// other separators
+var words = 0;
+for r in f.records(separator=0x31:uint(8)) do
+  words += 1;
+var pwords: atomic int;
+forall r in f.records(separator=0x31:uint(8), chunkSize=chunkSize) do
+  pwords.add(1);
+writeln(words == pwords.read());
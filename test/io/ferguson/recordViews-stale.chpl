@@ -0,0 +1,16 @@
+use IO;
+
+var f = opentmp();
+{
+  var w = f.writer();
+  w.writeln("one");
+  w.writeln("two");
+  w.close();
+}
+
+var keep: bytesView;
+var r = f.reader();
+for v in r.recordViews() {
+  if v.size == 4 && v[1] == 0x6f then keep = v;
+  else writeln(keep.size);
+}
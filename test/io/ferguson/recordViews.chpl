@@ -0,0 +1,44 @@
+use IO;
+
+config const n = 1000;
+
+proc check(hints: iohints) {
+  var f = opentmp();
+  {
+    var w = f.writer();
+    for i in 1..n do w.writeln("line ", i);
+    // a long record, so that some records cross buffer boundaries
+    w.writeln("x" * 100000);
+    w.write("no newline");
+    w.close();
+  }
+
+  var count, nbytes, ok = 0;
+  var last: string;
+  var r = f.reader(hints=hints);
+  for v in r.recordViews() {
+    count += 1;
+    nbytes += v.size;
+    if count <= n && v.toString() == "line " + count + "\n" then ok += 1;
+    if count == n+1 && v.find(0x0a) != v.size then writeln("bad find");
+    last = v.toString();
+  }
+  r.close();
+  writeln(count, " ", nbytes, " ", ok, " ", last);
+
+  // a different separator, and stopping early
+  var commas = 0;
+  r = f.reader(hints=hints);
+  for v in r.recordViews(separator=0x20) {
+    commas += 1;
+    if commas == 3 {
+      writeln(v, "|", v[1], " ", v.find(0x0a));
+      break;
+    }
+  }
+  r.close();
+  f.close();
+}
+
+check(IOHINT_NONE);
+check(IOHINT_CACHED);
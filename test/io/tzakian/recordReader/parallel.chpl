@@ -0,0 +1,49 @@
+use RecordParser;
+
+// Check that the parallel stream() finds the same records as the serial one
+config const copies = 20;
+config const chunkSize = 100;
+
+record Beer {
+  var name:  string;
+  var beerId: int;
+  var brewerId: int;
+  var ABV: real;
+  var style: string;
+  var appearance: real;
+  var aroma: real;
+  var palate: real;
+  var taste: real;
+  var overall: real;
+  var time:  int;
+  var profileName:  string;
+  var text: string;
+}
+
+var strt = "\\s*beer/name: (.*)\\s*beer/beerId: (.*)\\s*beer/brewerId: (.*)\\s*beer/ABV: (.*)\\s*beer/style: (.*)\\s*review/appearance: (.*)\\s*review/aroma: (.*)\\s*review/palate: (.*)\\s*review/taste: (.*)\\s*review/overall: (.*)\\s*review/time: (.*)\\s*review/profileName: (.*)\\s*review/text: (.*)";
+
+var data: string;
+open("input2_beer.txt", iomode.r).reader().readstring(data);
+
+var f = opentmp();
+{
+  var w = f.writer();
+  for i in 1..copies do w.write(data);
+  w.close();
+}
+
+var serialCount, serialSum = 0;
+var S = new owned RecordReader(Beer, f.reader(), strt);
+for r in S.stream() {
+  serialCount += 1;
+  serialSum += r.beerId + r.time;
+}
+
+var count, sum: atomic int;
+var P = new owned RecordReader(Beer, f.reader(), strt);
+forall r in P.stream(chunkSize=chunkSize) {
+  count.add(1);
+  sum.add(r.beerId + r.time);
+}
+
+writeln(serialCount == count.read(), " ", serialSum == sum.read());
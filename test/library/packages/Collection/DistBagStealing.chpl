@@ -0,0 +1,37 @@
+use DistributedBag;
+
+// Elements added on one node are drained by tasks on every node, through
+// 'remove' and 'removeBulk', which have to steal work from the other nodes.
+// Every element must come out exactly once.
+config const nElems = 100000;
+
+var bag = new DistBag(int);
+assert(bag.addBulk(1..nElems) == nElems);
+assert(bag.getSize() == nElems);
+
+var seen : [1..nElems] atomic int;
+coforall loc in Locales do on loc {
+  coforall tid in 0..#here.maxTaskPar {
+    while true {
+      if tid % 2 == 0 {
+        var (hasElt, elt) = bag.remove();
+        if !hasElt then break;
+        seen[elt].add(1);
+      } else {
+        var elts = bag.removeBulk(1000);
+        if elts.size == 0 then break;
+        for elt in elts do seen[elt].add(1);
+      }
+    }
+  }
+}
+
+assert(&& reduce [s in seen] s.read() == 1);
+assert(bag.getSize() == 0);
+
+// Bulk removal returns what is there when there are fewer elements than asked
+bag.addBulk(1..10);
+var elts = bag.removeBulk(100);
+assert(elts.size == 10 && + reduce elts == 55);
+
+writeln("SUCCESS");
@@ -0,0 +1,47 @@
+// dot() and transpose() on Block- and Cyclic-distributed operands,
+// checked against the same operations on local copies.
+
+use LinearAlgebra, BlockDist, CyclicDist;
+config const m = 70, n = 45, p = 33;
+
+proc check(A, B, C) {
+  var err = 0.0;
+  for i in 1..m do for j in 1..p {
+    var s = 0.0;
+    for k in 1..n do s += A[i,k] * B[k,j];
+    err = max(err, abs(s - C[i,j]));
+  }
+  return err;
+}
+
+const DA = {1..m, 1..n}, DB = {1..n, 1..p};
+const BA = DA dmapped Block(DA), BB = DB dmapped Block(DB);
+const CA = DA dmapped Cyclic(startIdx=DA.low), CB = DB dmapped Cyclic(startIdx=DB.low);
+var A: [BA] real, B: [BB] real, Ac: [CA] real, Bc: [CB] real, Al: [DA] real, Bl: [DB] real;
+forall (i,j) in DA do A[i,j] = (i*3 + j) % 7 - 3.0;
+forall (i,j) in DB do B[i,j] = (i + 2*j) % 5 - 2.0;
+Ac = A; Bc = B; Al = A; Bl = B;
+
+var C1 = dot(A, B);
+writeln(C1.domain, " ", check(Al, Bl, C1));
+var C2 = dot(Ac, Bc);
+writeln(C2.domain, " ", check(Al, Bl, C2));
+var C3 = dot(Al, B);
+writeln(C3.domain, " ", check(Al, Bl, C3));
+var C4 = dot(A, Bc);
+writeln(check(Al, Bl, C4));
+
+var T = transpose(A);
+writeln(T.domain, " ", && reduce [(i,j) in DA] (T[j,i] == A[i,j]));
+var Tc = transpose(Ac);
+writeln(Tc.domain, " ", && reduce [(i,j) in DA] (Tc[j,i] == A[i,j]));
+
+const Dx = {1..n} dmapped Block({1..n});
+var x: [Dx] real = [i in 1..n] i:real;
+var xl: [1..n] real = x;
+var y = dot(A, x), yl = dot(Al, xl), y2 = dot(Al, x);
+writeln(y.domain, " ", max reduce abs(y - yl), " ", max reduce abs(y2 - yl));
+var z: [1..m] real = [i in 1..m] (i % 4):real;
+var w = dot(z, Ac), wl = dot(z, Al);
+writeln(w.domain, " ", max reduce abs(w - wl));
+writeln(dot(x, x) == dot(xl, xl));
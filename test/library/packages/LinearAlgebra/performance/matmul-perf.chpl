@@ -0,0 +1,116 @@
+/*
+Matrix multiplication performance testing
+
+Reports GFLOP/s for LinearAlgebra.dot() on matrix-matrix and matrix-vector
+products.  Which implementation dot() uses depends on how this is compiled:
+
+  chpl matmul-perf.chpl                      # BLAS
+  chpl matmul-perf.chpl --set blasImpl=none  # native
+
+--m=100     --iters=100
+--m=1000    --iters=3
+--m=2000    --iters=1
+*/
+
+use LinearAlgebra;
+use BLAS;
+use Time;
+
+config const m=1000,
+             iters=3,
+             reference=false,
+             correctness=false;
+
+
+config type eltType = real;
+
+proc main() {
+  const D = {1..m, 1..m};
+  var A, B: [D] eltType;
+
+  [(i, j) in D] A[i,j] = ((i + 2*j) % 7):eltType;
+  [(i, j) in D] B[i,j] = ((3*i - j) % 5):eltType;
+  var x: [1..m] eltType = [i in 1..m] (i % 3):eltType;
+
+  var t: Timer;
+
+  const impl = if blasImpl == BlasImpl.none then 'native' else 'BLAS';
+
+  if !correctness {
+    writeln('======================================');
+    writeln('Matrix Multiplication Performance Test');
+    writeln('======================================');
+    writeln('iters : ', iters);
+    writeln('m     : ', m);
+    writeln('impl  : ', impl);
+    writeln();
+  }
+
+  var C: [D] eltType;
+  for 1..iters {
+    t.start();
+    C = dot(A, B);
+    t.stop();
+  }
+  if !correctness then
+    writeln('dot(matrix, matrix) GFLOP/s: ', gflops(2.0*m*m*m, t.elapsed()/iters));
+  t.clear();
+
+  var y: [1..m] eltType;
+  for 1..iters {
+    t.start();
+    y = dot(A, x);
+    t.stop();
+  }
+  if !correctness then
+    writeln('dot(matrix, vector) GFLOP/s: ', gflops(2.0*m*m, t.elapsed()/iters));
+  t.clear();
+
+  var yT: [1..m] eltType;
+  for 1..iters {
+    t.start();
+    yT = dot(x, A);
+    t.stop();
+  }
+  if !correctness then
+    writeln('dot(vector, matrix) GFLOP/s: ', gflops(2.0*m*m, t.elapsed()/iters));
+  t.clear();
+
+  if reference {
+    // the element-at-a-time algorithm dot() used before it was blocked
+    var R: [D] eltType;
+    for 1..iters {
+      t.start();
+      forall (i, j) in D do
+        R[i, j] = + reduce (A[i, ..] * B[.., j]);
+      t.stop();
+    }
+    if !correctness then
+      writeln('reference GFLOP/s: ', gflops(2.0*m*m*m, t.elapsed()/iters));
+    t.clear();
+  } else {
+    if !correctness then
+      writeln('reference GFLOP/s: -1');
+  }
+
+  // check a sample of each result against a straightforward sum
+  var ok = true;
+  for i in 1..m by max(1, m/17) {
+    for j in 1..m by max(1, m/13) {
+      var sum: eltType;
+      for k in 1..m do sum += A[i, k] * B[k, j];
+      ok &&= C[i, j] == sum;
+    }
+    var sum, sumT: eltType;
+    for k in 1..m {
+      sum += A[i, k] * x[k];
+      sumT += x[k] * A[k, i];
+    }
+    ok &&= y[i] == sum && yT[i] == sumT;
+  }
+  writeln(if ok then 'Success' else 'Failure');
+}
+
+proc gflops(flops: real, seconds: real) {
+  return flops / seconds / 1e9;
+}
@@ -0,0 +1,86 @@
+/*
+ *  Check that sort() and radixSort() agree with quickSort() for the key
+ *  types and comparators that use the radix sort.
+ */
+
+use Sort;
+use Random;
+
+config const n = 100000;
+
+// Sorts by first, then second, using key parts
+record Pair { var first, second: int; }
+record PairCmp { }
+proc PairCmp.keyPart(a: Pair, i: int) {
+  if i == 1 then return (0:int(8), a.first);
+  else if i == 2 then return (0:int(8), a.second);
+  else return (-1:int(8), 0);
+}
+
+record AbsKeyCmp { }
+proc AbsKeyCmp.key(a) { return abs(a); }
+
+proc check(A, cmp, name) {
+  var Expected = A;
+  quickSort(Expected, comparator=cmp);
+
+  var Sorted = A;
+  sort(Sorted, comparator=cmp);
+
+  var ok = isSorted(Sorted, comparator=cmp);
+  for (e, s) in zip(Expected, Sorted) do
+    if chpl_compare(e, s, cmp) != 0 then
+      ok = false;
+  writeln(name, ": ", ok);
+}
+
+proc main() {
+  var I: [1..n] int;
+  fillRandom(I, 7);
+  check(I, defaultComparator, "int");
+  check(I, reverseComparator, "int reverse");
+
+  var Small: [1..n] int;
+  for (x, i) in zip(Small, 1..) do x = (i * 7919) % 1000 - 500;
+  check(Small, new AbsKeyCmp(), "int key");
+  check(Small, new ReverseComparator(new AbsKeyCmp()), "int key reverse");
+
+  var U: [0..#n] uint(32);
+  fillRandom(U, 9);
+  check(U, defaultComparator, "uint(32)");
+
+  var R: [1..n] real;
+  fillRandom(R, 11);
+  R -= 0.5;
+  check(R, defaultComparator, "real");
+
+  var T: [1..n] (int, real);
+  for (t, i, r) in zip(T, I, R) do t = (i % 10, r);
+  check(T, defaultComparator, "tuple");
+  check(T, reverseComparator, "tuple reverse");
+
+  var S: [1..n/10] string;
+  for (s, i) in zip(S, Small[1..n/10]) do s = (i*i):string + "x";
+  S[1] = "";
+  S[2] = "1";
+  S[3] = "10";
+  check(S, defaultComparator, "string");
+  check(S, reverseComparator, "string reverse");
+
+  var P: [1..n] Pair;
+  for (p, i, j) in zip(P, Small, I) do p = new Pair(i, j);
+  check(P, new PairCmp(), "keyPart");
+  check(P, new ReverseComparator(new PairCmp()), "keyPart reverse");
+
+  var Strided: [1..2*n by 2] int = I;
+  radixSort(Strided);
+  writeln("strided: ", isSorted(Strided));
+
+  var Empty: [1..0] int;
+  radixSort(Empty);
+  writeln("empty: ", isSorted(Empty));
+
+  var A = [3, -1, 2, 7, -10];
+  radixSort(A);
+  writeln(A);
+}
@@ -0,0 +1,31 @@
+use List;
+var l: list(int);
+for i in 1..20 do l.append(i);
+l.prepend(0);
+writeln(l, " ", l.size, " ", l(1), " ", l(21));
+l.remove(5); l.remove(18); l.remove(100);
+writeln(l);
+writeln(l.pop_front(), " ", l.pop_back(), " ", l);
+l(2) = 42;
+var A = [100, 200, 300];
+l.extend(A);
+writeln(l);
+writeln(+ reduce l);
+forall x in l do x += 1;
+writeln(l);
+var B: [1..l.size] int;
+forall (b, x) in zip(B, l) do b = x;
+writeln(B);
+forall (x, b) in zip(l, B) do x = b * 2;
+writeln(l);
+var s: list(string);
+for i in 1..10 do s.push_front("s" + i);
+for i in 1..5 do s.pop_front();
+s.remove("s3");
+writeln(s);
+var s2 = s; s2.append("x"); writeln(s, s2);
+const cl = s2;
+writeln(cl(1), " ", makeList(1,2,3));
+var big: list(int); big.reserve(1000); writeln(big.capacity >= 1000);
+for i in 1..1000000 do big.append(i);
+writeln(+ reduce big);
@@ -0,0 +1,34 @@
+// Prepending and popping should reuse free slots rather than growing the
+// buffer each time the first element reaches the front of it.
+use List;
+
+var l: list(int);
+var popped = 0;
+for i in 1..100 {
+  l.prepend(i);
+  popped += l.pop_front();
+}
+writeln(popped);
+for i in 1..100 {
+  l.prepend(i);
+  l.pop_back();
+}
+writeln(l.size, " ", l._capacity <= 16);
+
+// A queue fed at one end and drained at the other stays within twice its
+// largest size.
+for i in 1..8 do l.append(i);
+for i in 9..1000 {
+  l.append(i);
+  l.pop_front();
+  l.prepend(-i);
+  l.pop_back();
+}
+writeln(l, " ", l._capacity <= 16);
+
+// Growth still happens once the buffer is full
+var m: list(int);
+for i in 1..100 do m.prepend(i);
+for i in 1..100 do m.append(-i);
+writeln(m.size, " ", m(1), " ", m(100), " ", m(101), " ", m(200),
+        " ", + reduce m);
@@ -0,0 +1,46 @@
+// Shuffles and permutations of arrays large enough to be done in
+// parallel, checking that local and Block-distributed arrays get the
+// same result from the same seed.
+
+use Random, BlockDist;
+config const n = 300_001;
+
+proc isPermutation(A: [] int, D) {
+  var seen: [D] atomic bool;
+  forall a in A do
+    if D.contains(a) then
+      seen[a].write(true);
+  return && reduce [s in seen] s.read();
+}
+
+const D = {1..n},
+      BD = D dmapped Block(D);
+
+var A: [D] int = D,
+    B: [BD] int = D;
+shuffle(A, seed=17);
+shuffle(B, seed=17);
+writeln(isPermutation(A, D), " ", && reduce (A == B));
+
+var A2: [D] int = D;
+shuffle(A2, seed=19);
+writeln(|| reduce (A != A2));
+
+var P: [D] int,
+    Q: [BD] int;
+permutation(P, seed=23);
+permutation(Q, seed=23);
+writeln(isPermutation(P, D), " ", && reduce (P == Q));
+
+// Successive shuffles from one stream continue from where it left off
+var rs = new owned RandomStream(int, seed=29);
+var S1: [D] int = D, S2: [D] int = D;
+rs.shuffle(S1);
+rs.shuffle(S2);
+const next = rs.getNext();
+writeln(|| reduce (S1 != S2), " ", next == rs.getNth(4*n + 1));
+
+const SD = {1..2*n by 2};
+var T: [SD] int = SD;
+shuffle(T, seed=31);
+writeln(isPermutation(T, SD));
@@ -0,0 +1,108 @@
+// Check the Philox generator against the Random123 known-answer vectors,
+// and check that its streams can be indexed, skipped and filled in
+// parallel consistently.
+
+use Random;
+use PhiloxRandom;
+
+writeln("Checking Philox4x32-10 known answers");
+proc hex(t) {
+  var s = "%08xu".format(t(1));
+  for param i in 2..4 do s += " %08xu".format(t(i));
+  return s;
+}
+writeln(hex(philox4x32((0:uint(32), 0:uint(32), 0:uint(32), 0:uint(32)),
+                       (0:uint(32), 0:uint(32)))));
+const ones = max(uint(32));
+writeln(hex(philox4x32((ones, ones, ones, ones), (ones, ones))));
+writeln(hex(philox4x32((0x243f6a88:uint(32), 0x85a308d3:uint(32),
+                        0x13198a2e:uint(32), 0x03707344:uint(32)),
+                       (0xa4093822:uint(32), 0x299f31d0:uint(32)))));
+
+proc checkStream(type t) {
+  const n = 1001;
+  var rs = makeRandomStream(t, seed=42, parSafe=false,
+                            algorithm=RNG.Philox);
+  var expect: [1..n] t;
+  for x in expect do x = rs.getNext();
+
+  // getNth and skipToNth are consistent with getNext
+  var ok = true;
+  for i in 1..n by 97 do
+    ok &&= rs.getNth(i) == expect[i];
+  rs.skipToNth(500);
+  ok &&= rs.getNext() == expect[500];
+
+  // So is filling arrays in parallel, including strided ones
+  var A: [1..n] t;
+  fillRandom(A, seed=42, algorithm=RNG.Philox);
+  ok &&= && reduce (A == expect);
+  var S: [1..2*n by 2] t;
+  fillRandom(S, seed=42, algorithm=RNG.Philox);
+  ok &&= && reduce [(s, a) in zip(S, A)] s == a;
+  var M: [1..7, 1..143] t;
+  fillRandom(M, seed=42, algorithm=RNG.Philox);
+  ok &&= && reduce [(i, j) in M.domain] M[i, j] == expect[(i-1)*143 + j];
+
+  // And the stream continues after a fill
+  var rs2 = makeRandomStream(t, seed=42, parSafe=false,
+                             algorithm=RNG.Philox);
+  var B: [1..10] t;
+  rs2.fillRandom(B);
+  ok &&= rs2.getNext() == expect[11];
+  writeln(t:string, ": ", ok);
+}
+
+writeln("Checking streams");
+checkStream(uint(8));
+checkStream(int(32));
+checkStream(uint(64));
+checkStream(real(32));
+checkStream(real(64));
+checkStream(imag(64));
+checkStream(complex(64));
+checkStream(complex(128));
+checkStream(bool);
+
+writeln("Checking ranges");
+{
+  var rs = makeRandomStream(int, seed=7, algorithm=RNG.Philox);
+  var ok = true;
+  var seen: [-3..3] bool;
+  for 1..1000 {
+    const x = rs.getNext(-3, 3);
+    ok &&= x >= -3 && x <= 3;
+    seen[x] = true;
+  }
+  for 1..1000 {
+    const x = rs.getNext(uint(8), 250, 255);
+    ok &&= x >= 250;
+  }
+  for 1..1000 {
+    const x = rs.getNext(min(int), max(int));
+    const y = rs.getNext(real, 2.0, 3.0);
+    ok &&= y >= 2.0 && y < 3.0;
+  }
+  writeln(ok, " ", && reduce seen);
+}
+
+writeln("Checking mean");
+{
+  var R: [1..1000000] real;
+  fillRandom(R, seed=3, algorithm=RNG.Philox);
+  const mean = (+ reduce R) / R.size;
+  writeln(abs(mean - 0.5) < 0.002, " ", min reduce R >= 0.0,
+          " ", max reduce R < 1.0);
+}
+
+writeln("Checking shuffle and permutation");
+{
+  var A: [1..1000] int = 1..1000;
+  shuffle(A, seed=5, algorithm=RNG.Philox);
+  var P: [1..1000] int;
+  permutation(P, seed=5, algorithm=RNG.Philox);
+  writeln(&& reduce (P == A), " ", || reduce (A != 1..1000));
+  var seen: [1..1000] bool;
+  for a in A do seen[a] = true;
+  writeln(&& reduce seen);
+}
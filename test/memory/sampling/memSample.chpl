@@ -0,0 +1,29 @@
+//
+// In sampling mode memoryUsed() estimates the memory allocated.  Check
+// that the estimate is close for a large number of allocations, and
+// that freeing them brings it back down.
+//
+use Memory;
+
+config const n = 100000;
+
+class C { var t: 16*int; }   // 128 bytes of payload
+
+proc main() {
+  var A: [1..n] unmanaged C;
+  const m0 = memoryUsed();
+  forall i in 1..n do A[i] = new unmanaged C();
+  const m1 = memoryUsed();
+  const expected = n * 128;
+  const est = (m1 - m0): int;
+  if abs(est - expected) > expected / 5 then
+    writeln("estimate ", est, " too far from ", expected);
+  else
+    writeln("estimate ok");
+  forall a in A do delete a;
+  const m2 = memoryUsed();
+  if abs((m2 - m0): int) > expected / 5 then
+    writeln("after freeing, estimate ", (m2 - m0): int, " too large");
+  else
+    writeln("after freeing ok");
+}
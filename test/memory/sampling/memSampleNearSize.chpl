@@ -0,0 +1,24 @@
+//
+// Sampling by bytes with allocations a little smaller than memSample:
+// each sample then stands for a fractional number of allocations, and
+// the estimate must not lose the fraction.
+//
+use Memory;
+
+config const n = 20000;
+
+class C { var t: 375*int; }   // 3000 bytes of payload
+
+proc main() {
+  var A: [1..n] unmanaged C;
+  const m0 = memoryUsed();
+  forall i in 1..n do A[i] = new unmanaged C();
+  const m1 = memoryUsed();
+  const expected = n * 3000;
+  const est = (m1 - m0): int;
+  if abs(est - expected) > expected / 10 then
+    writeln("estimate ", est, " too far from ", expected);
+  else
+    writeln("estimate ok");
+  forall a in A do delete a;
+}
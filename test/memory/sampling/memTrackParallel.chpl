@@ -0,0 +1,21 @@
+//
+// Allocate and free concurrently from many tasks, with full tracking,
+// and check that the tracked total comes back to where it started.
+//
+use Memory;
+
+config const n = 200000;
+
+class C { var x: int; }
+
+proc main() {
+  var A: [1..n] unmanaged C;
+  const m0 = memoryUsed();
+  forall i in 1..n do A[i] = new unmanaged C(i);
+  const m1 = memoryUsed();
+  // free in a different order, so mostly by other tasks
+  forall i in 1..n do delete A[n+1-i];
+  const m2 = memoryUsed();
+  writeln(m1 - m0 >= n * 8);
+  writeln(m2 == m0);
+}
@@ -0,0 +1,45 @@
+use CommDiagnostics;
+
+// Run with CHPL_RT_CACHE_ADAPTIVE set (see .execenv), so the caches
+// should grow when pages are revisited after being evicted and read
+// further ahead when the data read ahead gets used.
+
+config const n = 100000;
+config const pages = 1500;
+config const passes = 8;
+
+// A has one int per page of the cache, B is read sequentially
+param intsPerPage = 1024 / numBytes(int);
+var A:[0..#pages*intsPerPage] int;
+var B:[1..n] int;
+
+var start, revisited, sequential: cacheStats;
+var sum = 0;
+
+on Locales[1] {
+  sum += B[1];
+  start = getCacheStatsHere();
+
+  // Visit the pages of A in the same shuffled order on every pass, so
+  // that the cache can't prefetch them, but would hit if it were larger
+  var order: [0..#pages] int = 0..#pages;
+  var seed = 1;
+  for i in 1..pages-1 by -1 {
+    seed = (seed * 1103515245 + 12345) % 2147483648;
+    order[i] <=> order[seed % (i+1)];
+  }
+  for pass in 1..passes do
+    for p in order do
+      sum += A[p*intsPerPage];
+  revisited = getCacheStatsHere();
+
+  for i in 1..n do
+    sum += B[i];
+  sequential = getCacheStatsHere();
+}
+
+writeln(sum);
+
+assert(start.capacity_pages > 0);
+assert(revisited.capacity_pages > start.capacity_pages);
+assert(sequential.readahead_max_bytes > start.readahead_max_bytes);
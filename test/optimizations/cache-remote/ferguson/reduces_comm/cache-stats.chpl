@@ -0,0 +1,26 @@
+use CommDiagnostics;
+
+config const n = 100000;
+var A:[1..n] int;
+
+for i in 1..n do
+  A[i] = i;
+
+resetCacheStats();
+
+var sum = 0;
+on Locales[1] {
+  for i in 1..n do
+    sum += A[i];
+}
+
+writeln(sum);
+
+const s = getCacheStats()[1];
+
+// Reading A sequentially should mostly hit in pages brought in by readahead
+assert(s.get_hits > s.get_misses);
+assert(s.readaheads > 0);
+assert(s.readahead_hits > 0);
+assert(s.capacity_pages > 0);
+assert(s.readahead_max_bytes > 0);
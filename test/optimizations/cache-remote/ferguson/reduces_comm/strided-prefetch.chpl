@@ -0,0 +1,39 @@
+use CommDiagnostics;
+use Prefetch;
+use ChapelEnv;
+
+// Without segment information the cache can't tell how far a pattern can
+// be followed safely, so only the explicit prefetch is expected then.
+param canPredict = CHPL_GASNET_SEGMENT != "everything";
+
+config const n = 1000;
+var A:[1..n, 1..n] int;
+
+forall (i,j) in A.domain do
+  A[i,j] = i*n + j;
+
+proc sumColumn(j: int, explicit: bool) {
+  var sum = 0;
+  on Locales[1] {
+    if explicit then
+      prefetchStrided(A[1,j], n, n);
+    for i in 1..n do
+      sum += A[i,j];
+  }
+  return sum;
+}
+
+for explicit in [false, true] {
+  resetCacheStats();
+  writeln(sumColumn(if explicit then 7 else 3, explicit));
+  const s = getCacheStats()[1];
+
+  // Reading down a column should be prefetched after the first few misses.
+  // The explicit prefetch alone is capped by the cache size.
+  if explicit || canPredict then
+    assert(s.prefetches > 0);
+  if canPredict then
+    assert(s.get_misses < n / 10);
+  else if explicit then
+    assert(s.get_misses < n);
+}
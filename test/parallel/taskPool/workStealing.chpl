@@ -0,0 +1,36 @@
+// Nested begins, cobegins, and coforalls, run with work stealing on.
+
+config const n = 1000;
+
+proc fib(x: int): int {
+  if x < 2 then return x;
+  var a, b: int;
+  if x > 12 then
+    cobegin with (ref a, ref b) {
+      a = fib(x-1);
+      b = fib(x-2);
+    }
+  else {
+    a = fib(x-1);
+    b = fib(x-2);
+  }
+  return a + b;
+}
+
+proc tree(depth: int): int {
+  if depth == 0 then return 1;
+  var counts: [0..3] int;
+  coforall i in 0..3 do
+    counts[i] = tree(depth-1);
+  return + reduce counts + 1;
+}
+
+var total: atomic int;
+sync {
+  for i in 1..n do
+    begin total.add(i);
+}
+writeln("total is ", total.read());
+
+writeln("fib(20) is ", fib(20));
+writeln("tree(4) has ", tree(4), " nodes");
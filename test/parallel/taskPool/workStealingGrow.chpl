@@ -0,0 +1,15 @@
+// One task queues many more tasks than a deque first holds, while the
+// other threads steal them, so the deque is grown (and the arrays it
+// outgrew are freed) while thieves are reading it.
+
+config const n = 50000,
+             rounds = 4;
+
+var total: atomic int;
+for r in 1..rounds {
+  sync {
+    for i in 1..n do
+      begin total.add(i);
+  }
+}
+writeln("total is ", total.read());
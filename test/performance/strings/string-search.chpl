@@ -0,0 +1,94 @@
+use Time;
+
+// Compare string.find/count/replace/split against a straightforward
+// byte-at-a-time search, like the one the string module used to do, on
+// log-like text.
+
+config const n = 20000;          // lines of text
+config const numTrials = 1;
+config const timing = false;
+
+const words = ["GET", "POST", "/index.html", "/api/v1/items", "200", "404",
+               "user=alice", "user=bob", "latency=12ms", "latency=340ms"];
+
+var text: string;
+for i in 1..n {
+  for j in 0..5 do
+    text += words[1 + (i*7 + j*3) % words.size] + " ";
+  text += "\n";
+}
+
+// the old search: try each starting position, comparing byte by byte
+proc naiveCount(s: string, needle: string): int {
+  var count = 0;
+  const sLen = s.length, nLen = needle.length;
+  for i in 0..#(sLen - nLen + 1) {
+    for j in 0..#nLen {
+      if s.buff[i+j] != needle.buff[j] then break;
+      if j == nLen-1 then count += 1;
+    }
+  }
+  return count;
+}
+
+proc naiveFind(s: string, needle: string, start: int): int {
+  const sLen = s.length, nLen = needle.length;
+  for i in (start-1)..#(sLen - nLen - start + 2) {
+    for j in 0..#nLen {
+      if s.buff[i+j] != needle.buff[j] then break;
+      if j == nLen-1 then return i+1;
+    }
+  }
+  return 0;
+}
+
+const needles = ["latency=340ms", "/api/v1/items", "user=carol", "\n"];
+
+var tNaive, tCount, tReplace, tSplit: Timer;
+var ok = true;
+
+for 1..numTrials {
+  for needle in needles {
+    tNaive.start();
+    const expected = naiveCount(text, needle);
+    tNaive.stop();
+
+    tCount.start();
+    const got = text.count(needle);
+    tCount.stop();
+    if got != expected then ok = false;
+  }
+
+  tReplace.start();
+  const replaced = text.replace("latency=", "lat=");
+  tReplace.stop();
+  if replaced.length != text.length - 4*text.count("latency=") then
+    ok = false;
+
+  tSplit.start();
+  var lines = 0;
+  for line in text.split("\n", ignoreEmpty=true) do
+    lines += 1;
+  tSplit.stop();
+  if lines != n then ok = false;
+
+  // a find that walks the whole text one match at a time
+  var pos = 1, found = 0;
+  while true {
+    const idx = naiveFind(text, "user=bob", pos);
+    if idx == 0 then break;
+    if text.find("user=bob", pos..) != idx then ok = false;
+    found += 1;
+    pos = idx + 1;
+  }
+  if found != text.count("user=bob") then ok = false;
+}
+
+writeln(if ok then "Success" else "Mismatch");
+
+if timing {
+  writeln("naive count: ", tNaive.elapsed());
+  writeln("count: ", tCount.elapsed());
+  writeln("replace: ", tReplace.elapsed());
+  writeln("split: ", tSplit.elapsed());
+}
@@ -0,0 +1,47 @@
+use CommDiagnostics;
+
+var x: int = 1;
+
+proc bump() {
+  on Locales[numLocales-1] {
+    for i in 1..5 do
+      x += i;
+  }
+}
+
+startCommDiagnosticsBySource();
+bump();
+stopCommDiagnosticsBySource();
+
+// by-source counts should account for all the GETs, PUTs, and ons
+const bySrc = getCommDiagnosticsBySource();
+var total: uint;
+for e in bySrc do total += e.count;
+const counts = + reduce [cd in getCommDiagnostics()] (cd.get + cd.put +
+                                                      cd.execute_on);
+writeln(x);
+writeln(total == counts);
+
+proc show(A) {
+  for kind in ["execute_on", "get", "put"] do
+    for e in A do
+      if e.file.endsWith("commDiagsBySource.chpl") && e.kind == kind then
+        writeln((e.line, e.kind, e.count,
+                 if kind == "execute_on" then 0 else e.bytes));
+}
+
+show(bySrc);
+
+// counting without 'BySource' shouldn't add to the source counts
+resetCommDiagnostics();
+startCommDiagnostics();
+bump();
+stopCommDiagnostics();
+writeln(getCommDiagnosticsBySource().size);
+
+// and counting again should only show the new location
+startCommDiagnosticsBySource();
+writeln(x);
+on Locales[numLocales-1] do x = 0;
+stopCommDiagnosticsBySource();
+show(getCommDiagnosticsBySource());
@@ -0,0 +1,53 @@
+//
+// Remote assignments that end forall iterations are done with unordered
+// GETs and PUTs, which must all be complete once the forall is.
+//
+use BlockDist, BufferedGets;
+
+config const n = 100000;
+config const stride = 7919;     // prime, so i*stride%n is a permutation
+
+record R {
+  var x: int;
+  var y: real;
+}
+
+const D = {0..#n} dmapped Block({0..#n});
+var A, B, C: [D] int;
+var RA, RB: [D] R;
+
+forall i in D do
+  A[i] = i;
+forall i in D do
+  RA[i] = new R(i, i:real);
+
+// unordered GETs
+forall i in D do
+  B[i] = A[i*stride%n];
+writeln(&& reduce [i in D] B[i] == i*stride%n);
+
+forall i in D do
+  RB[i] = RA[i*stride%n];
+writeln(&& reduce [i in D] (RB[i].x == i*stride%n && RB[i].y == RB[i].x));
+
+// unordered PUTs
+forall i in D do
+  C[i*stride%n] = i;
+writeln(&& reduce [i in D] C[i*stride%n] == i);
+
+forall i in D do
+  RB[i*stride%n] = RA[i];
+writeln(&& reduce [i in D] (RB[i*stride%n].x == i && RB[i].y == RB[i].x));
+
+// buffered GETs
+coforall loc in Locales do on loc {
+  var sum = 0;
+  var vals: [0..#n/numLocales] int;
+  for (v, i) in zip(vals, 0..) do
+    getBuff(v, A[(i + here.id * 17) * stride % n]);
+  flushGetBuff();
+  for (v, i) in zip(vals, 0..) do
+    if v != (i + here.id * 17) * stride % n then
+      halt("bad getBuff value");
+}
+writeln(true);
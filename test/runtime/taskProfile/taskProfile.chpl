@@ -0,0 +1,13 @@
+// Check the trace written when CHPL_RT_TASK_PROFILE is set.  The
+// prediff reads the trace and summarizes it in the output.
+
+config const n = 8;
+
+var s$: sync int;
+var total: atomic int;
+
+coforall i in 1..n do
+  total.add(i);
+
+begin s$ = total.read();
+writeln("total is ", s$.readFE());
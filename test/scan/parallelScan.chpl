@@ -0,0 +1,65 @@
+// Check that the parallel scans of 1-D default rectangular and
+// Block-distributed arrays match a serial scan, including for a
+// non-commutative user-defined op.
+use BlockDist;
+
+config const n = 1000;
+
+class concatOp: ReduceScanOp {
+  type eltType;
+  var value: string;
+
+  proc accumulate(x) { value += x:string; }
+  proc combine(x) { value += x.value; }
+  proc generate() return value;
+  proc clone() return new unmanaged concatOp(eltType=eltType);
+}
+
+proc check(name, A, B, op) {
+  var ok = true;
+  var state = op;
+  for (a, b) in zip(A, B) {
+    state.accumulate(a);
+    if b != state.generate() then ok = false;
+  }
+  delete state;
+  writeln(name, ": ", if ok then "ok" else "FAILED");
+}
+
+proc testAll(A: [] int) {
+  type eltType = A.eltType;
+  check("+", A, + scan A, new unmanaged SumReduceScanOp(eltType=eltType));
+  check("*", A, * scan A, new unmanaged ProductReduceScanOp(eltType=eltType));
+  check("max", A, max scan A, new unmanaged MaxReduceScanOp(eltType=eltType));
+  check("min", A, min scan A, new unmanaged MinReduceScanOp(eltType=eltType));
+  check("^", A, ^ scan A, new unmanaged BitwiseXorReduceScanOp(eltType=eltType));
+  check("concat", A, concatOp scan A, new unmanaged concatOp(eltType=eltType));
+}
+
+var A: [1..n] int = [i in 1..n] (i * 7919) % 10;
+testAll(A);
+writeln((+ scan A).domain);
+
+var S: [1..n by 3] int = [i in 1..n by 3] (i * 7919) % 10;
+testAll(S);
+writeln((+ scan S).domain);
+
+const D = {1..n} dmapped Block({1..n});
+var B: [D] int = [i in D] (i * 7919) % 10;
+testAll(B);
+writeln((+ scan B).domain, " ", (+ scan B).targetLocales().size == numLocales);
+
+// Array views are scanned over the view's own indices
+var R = A.reindex(0..#n);
+check("reindex", R, + scan R, new unmanaged SumReduceScanOp(eltType=int));
+writeln((+ scan R).domain);
+check("slice", A[3..n-3], + scan A[3..n-3],
+      new unmanaged SumReduceScanOp(eltType=int));
+check("Block slice", B[3..6], + scan B[3..6],
+      new unmanaged SumReduceScanOp(eltType=int));
+var BR = B.reindex(0..#n);
+check("Block reindex", BR, + scan BR,
+      new unmanaged SumReduceScanOp(eltType=int));
+
+var E: [1..0] int;
+writeln(+ scan E);